@@ -0,0 +1,189 @@
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BoundingBox.h"
+
+/**
+ * @class AabbTree
+ * @brief Dynamiczne drzewo prostopadłościanów otaczających (BVH) z wyważaniem rotacjami.
+ *
+ * Liście przechowują AABB obiektów powiększone o margines, więc obiekt poruszający się
+ * w obrębie swojego powiększonego AABB nie zmienia drzewa. Liść wstawiany jest obok węzła,
+ * który najmniej zwiększa sumę pól powierzchni przodków, a po każdej zmianie ścieżka do korzenia
+ * jest wyważana rotacjami - wysokość drzewa pozostaje rzędu log n, więc zapytania promieniem
+ * odwiedzają O(log n) węzłów zamiast testować wszystkie obiekty.
+ */
+class AabbTree {
+public:
+    /**
+     * @brief Uchwyt liścia (indeks węzła).
+     */
+    using Proxy = int32_t;
+
+    /**
+     * @brief Pusty uchwyt.
+     */
+    static constexpr Proxy NULL_NODE = -1;
+
+    /**
+     * @brief Konstruktor tworzący puste drzewo.
+     *
+     * @param margin Powiększenie AABB liści w każdą stronę.
+     */
+    explicit AabbTree(float margin = 0.1f);
+
+    /**
+     * @brief Dodaje obiekt.
+     *
+     * @param box AABB obiektu.
+     * @param userData Dane przekazywane do funkcji zwrotnych zapytań.
+     * @return Uchwyt liścia.
+     */
+    Proxy createProxy(const BoundingBox& box, uint32_t userData);
+
+    /**
+     * @brief Usuwa obiekt.
+     */
+    void destroyProxy(Proxy proxy);
+
+    /**
+     * @brief Aktualizuje AABB obiektu.
+     *
+     * @return true, jeśli obiekt wyszedł poza powiększony AABB i został wstawiony ponownie.
+     */
+    bool moveProxy(Proxy proxy, const BoundingBox& box);
+
+    /**
+     * @brief Zwraca dane obiektu.
+     */
+    uint32_t getUserData(Proxy proxy) const;
+
+    /**
+     * @brief Przechodzi po liściach, których AABB przecina promień w odcinku [0, maxDistance].
+     *
+     * Funkcja zwrotna dostaje dane liścia i bieżący zasięg, a zwraca nowy zasięg - po trafieniu
+     * zwraca odległość trafienia, więc dalsze poddrzewa są odcinane.
+     *
+     * @param origin Początek promienia.
+     * @param direction Znormalizowany kierunek promienia.
+     * @param maxDistance Zasięg promienia.
+     * @param callback Funkcja float(uint32_t userData, float maxDistance).
+     */
+    template <typename F>
+    void raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, F&& callback) {
+        visitedCount = 0;
+        if (root == NULL_NODE) {
+            return;
+        }
+        glm::vec3 inverseDirection = 1.0f / direction;
+
+        // Bliższe dziecko zdejmowane jest pierwsze, więc wczesne trafienie odcina dalsze poddrzewa
+        stack.clear();
+        stack.push_back({ root, rayEntry(nodes[root].box, origin, inverseDirection, maxDistance) });
+        while (!stack.empty()) {
+            StackEntry entry = stack.back();
+            stack.pop_back();
+            if (entry.distance > maxDistance) {
+                continue;
+            }
+            const Node& node = nodes[entry.node];
+            visitedCount++;
+            if (node.isLeaf()) {
+                maxDistance = callback(node.userData, maxDistance);
+                continue;
+            }
+            float distance1 = rayEntry(nodes[node.child1].box, origin, inverseDirection, maxDistance);
+            float distance2 = rayEntry(nodes[node.child2].box, origin, inverseDirection, maxDistance);
+            if (distance1 < distance2) {
+                stack.push_back({ node.child2, distance2 });
+                stack.push_back({ node.child1, distance1 });
+            }
+            else {
+                stack.push_back({ node.child1, distance1 });
+                stack.push_back({ node.child2, distance2 });
+            }
+        }
+    }
+
+    /**
+     * @brief Zwraca wysokość drzewa (0 dla pojedynczego liścia).
+     */
+    int getHeight() const;
+
+    /**
+     * @brief Zwraca liczbę obiektów.
+     */
+    size_t getProxyCount() const;
+
+    /**
+     * @brief Zwraca liczbę węzłów odwiedzonych w ostatnim zapytaniu.
+     */
+    size_t getVisitedCount() const;
+
+private:
+    /**
+     * @struct Node
+     * @brief Węzeł drzewa; liść, gdy nie ma dzieci.
+     */
+    struct Node {
+        BoundingBox box;             /**< AABB węzła (w liściu powiększony o margines). */
+        Proxy parent = NULL_NODE;    /**< Rodzic albo następny wolny węzeł. */
+        Proxy child1 = NULL_NODE;    /**< Pierwsze dziecko. */
+        Proxy child2 = NULL_NODE;    /**< Drugie dziecko. */
+        int height = -1;             /**< Wysokość poddrzewa (-1 dla wolnego węzła). */
+        uint32_t userData = 0;       /**< Dane obiektu w liściu. */
+
+        bool isLeaf() const {
+            return child1 == NULL_NODE;
+        }
+    };
+
+    /**
+     * @struct StackEntry
+     * @brief Węzeł czekający na odwiedzenie wraz z odległością wejścia promienia w jego AABB.
+     */
+    struct StackEntry {
+        Proxy node;          /**< Węzeł. */
+        float distance;      /**< Odległość wejścia promienia. */
+    };
+
+    /**
+     * @brief Test promienia z AABB metodą płyt.
+     *
+     * @return Odległość wejścia promienia w AABB albo nieskończoność, gdy promień go nie przecina.
+     */
+    static float rayEntry(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance);
+
+    Proxy allocateNode();
+    void freeNode(Proxy node);
+    void insertLeaf(Proxy leaf);
+    void removeLeaf(Proxy leaf);
+
+    /**
+     * @brief Wyważa poddrzewo rotacją, jeśli wysokości dzieci różnią się o więcej niż 1.
+     *
+     * @return Korzeń poddrzewa po rotacji.
+     */
+    Proxy balance(Proxy node);
+
+    /**
+     * @brief Przelicza AABB i wysokości od węzła do korzenia, wyważając po drodze.
+     */
+    void refitAncestors(Proxy node);
+
+    float margin;
+    std::vector<Node> nodes;
+    Proxy root = NULL_NODE;
+    Proxy freeList = NULL_NODE;
+    size_t proxyCount = 0;
+    size_t visitedCount = 0;
+    std::vector<StackEntry> stack;
+};
+
+#endif // AABBTREE_H
@@ -0,0 +1,75 @@
+#ifndef BOUNDINGBOX_H
+#define BOUNDINGBOX_H
+
+#include <glm/glm.hpp>
+#include <span>
+#include <limits>
+
+/**
+ * @struct BoundingBox
+ * @brief Prostopadłościan otaczający wyrównany do osi (AABB) w przestrzeni świata.
+ *
+ * Używany do odrzucania obiektów, które nie mogą być widoczne w danym widoku
+ * (kamera, ściany mapy cieni itp.).
+ */
+struct BoundingBox {
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());    /**< Najmniejszy narożnik. */
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());   /**< Największy narożnik. */
+
+    /**
+     * @brief Rozszerza prostopadłościan tak, aby zawierał podany punkt.
+     *
+     * @param point Punkt w przestrzeni świata.
+     */
+    void expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    /**
+     * @brief Sprawdza, czy prostopadłościany mają część wspólną.
+     */
+    bool intersects(const BoundingBox& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x
+            && min.y <= other.max.y && max.y >= other.min.y
+            && min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    /**
+     * @brief Zwraca środek prostopadłościanu.
+     */
+    glm::vec3 getCenter() const {
+        return (min + max) * 0.5f;
+    }
+
+    /**
+     * @brief Zwraca połowę wymiarów prostopadłościanu.
+     */
+    glm::vec3 getExtents() const {
+        return (max - min) * 0.5f;
+    }
+
+    /**
+     * @brief Zwraca promień sfery opisanej na prostopadłościanie.
+     */
+    float getRadius() const {
+        return glm::length(getExtents());
+    }
+
+    /**
+     * @brief Wyznacza prostopadłościan dla przeplatanych danych wierzchołków.
+     *
+     * @param vertices Dane wierzchołków (pozycja w pierwszych trzech składowych).
+     * @param stride Liczba wartości float na wierzchołek.
+     * @return Prostopadłościan zawierający wszystkie wierzchołki.
+     */
+    static BoundingBox fromVertices(std::span<const float> vertices, size_t stride) {
+        BoundingBox box;
+        for (size_t i = 0; i + 2 < vertices.size(); i += stride) {
+            box.expand(glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]));
+        }
+        return box;
+    }
+};
+
+#endif // BOUNDINGBOX_H
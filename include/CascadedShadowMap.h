@@ -0,0 +1,117 @@
+#ifndef CASCADEDSHADOWMAP_H
+#define CASCADEDSHADOWMAP_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @class CascadedShadowMap
+ * @brief Kaskadowa mapa cieni dla światła kierunkowego.
+ *
+ * Frustum obserwatora dzielone jest na kaskady według praktycznego schematu podziału
+ * (mieszanka podziału logarytmicznego i równomiernego). Każda kaskada otrzymuje rzut
+ * ortogonalny dopasowany do sfery opisanej na jej wycinku frustum, przyciągnięty do siatki
+ * tekseli, aby cienie nie migotały przy ruchu kamery. Kaskady przechowywane są w warstwach
+ * jednej tekstury `GL_TEXTURE_2D_ARRAY`.
+ */
+class CascadedShadowMap {
+public:
+    /**
+     * @brief Maksymalna liczba kaskad obsługiwana przez shader.
+     */
+    static const int MAX_CASCADES = 4;
+
+    /**
+     * @brief Konstruktor tworzący teksturę kaskad i bufor ramki.
+     *
+     * @param resolution Rozdzielczość jednej kaskady w tekselach.
+     * @param cascadeCount Liczba kaskad (1 - MAX_CASCADES).
+     * @param splitLambda Waga podziału logarytmicznego (0 = równomierny, 1 = logarytmiczny).
+     */
+    CascadedShadowMap(int resolution, int cascadeCount, float splitLambda = 0.75f);
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~CascadedShadowMap();
+
+    /**
+     * @brief Wyznacza podziały i macierze kaskad dla bieżącej klatki.
+     *
+     * @param observer Obserwator, do którego frustum dopasowywane są kaskady.
+     * @param aspect Stosunek szerokości do wysokości obrazu.
+     * @param lightDirection Kierunek padania światła (od światła do sceny).
+     */
+    void update(const Observer& observer, float aspect, const glm::vec3& lightDirection);
+
+    /**
+     * @brief Podpina warstwę kaskady jako cel renderowania głębokości.
+     *
+     * @param cascade Indeks kaskady.
+     */
+    void bindForWriting(int cascade) const;
+
+    /**
+     * @brief Pobiera identyfikator tekstury kaskad.
+     *
+     * @return Identyfikator tekstury `GL_TEXTURE_2D_ARRAY`.
+     */
+    GLuint getTexture() const;
+
+    /**
+     * @brief Pobiera liczbę kaskad.
+     *
+     * @return Liczba kaskad.
+     */
+    int getCascadeCount() const;
+
+    /**
+     * @brief Pobiera rozdzielczość jednej kaskady.
+     *
+     * @return Rozdzielczość w tekselach.
+     */
+    int getResolution() const;
+
+    /**
+     * @brief Pobiera macierze przestrzeni światła kolejnych kaskad.
+     *
+     * @return Wektor macierzy (rzut * widok).
+     */
+    const std::vector<glm::mat4>& getMatrices() const;
+
+    /**
+     * @brief Pobiera dalekie granice kaskad mierzone jako głębokość w przestrzeni widoku.
+     *
+     * @return Wektor odległości podziałów.
+     */
+    const std::vector<float>& getSplits() const;
+
+    /**
+     * @brief Ustawia maksymalny zasięg cieni od kamery.
+     *
+     * @param distance Odległość, do której rysowane są cienie kaskadowe.
+     */
+    void setShadowDistance(float distance);
+
+private:
+    GLuint fbo = 0;
+    GLuint depthArray = 0;
+    int resolution;
+    int cascadeCount;
+    float splitLambda;
+    float shadowDistance = 60.0f;
+
+    /**
+     * @brief Dodatkowa głębokość za kaskadą, aby obiekty poza frustum nadal rzucały cień.
+     */
+    float casterMargin = 50.0f;
+
+    std::vector<glm::mat4> matrices;
+    std::vector<float> splits;
+};
+
+#endif // CASCADEDSHADOWMAP_H
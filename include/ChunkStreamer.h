@@ -0,0 +1,222 @@
+#ifndef CHUNKSTREAMER_H
+#define CHUNKSTREAMER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SceneFile.h"
+
+/**
+ * @brief Bok kwadratowego fragmentu świata w płaszczyźnie XZ (w jednostkach świata).
+ */
+constexpr float WORLD_CHUNK_SIZE = 32.0f;
+
+/**
+ * @class ChunkStreamer
+ * @brief Wczytywanie i zwalnianie fragmentów świata w tle, zależnie od odległości od obserwatora.
+ *
+ * Świat to katalog plików SceneFile `chunk_<x>_<z>.scene`, każdy z obiektami jednego fragmentu
+ * siatki o boku WORLD_CHUNK_SIZE. Wątki wejścia-wyjścia (osobne od JobSystem, bo blokują się na
+ * dysku) wczytują najbliższe fragmenty w promieniu wczytywania; fragmenty dalsze niż promień
+ * zwalniania są zwalniane, a różnica promieni zapobiega miganiu na granicy. Suma szacowanej
+ * pamięci fragmentów nie przekracza budżetu - gdy bliższy fragment się nie mieści, zwalniane są
+ * najdalsze. Obiekty wczytanych fragmentów przekazywane są do silnika porcjami przez upload(),
+ * więc przesyłanie danych do GPU rozkłada się na wiele klatek. Obiekty fragmentu przychodzą
+ * posortowane po materiale.
+ *
+ * Wszystkie metody publiczne wywoływane są z wątku głównego; po update() należy wywołać
+ * unload() i upload().
+ */
+class ChunkStreamer {
+public:
+    /**
+     * @brief Uchwyt fragmentu (indeks w katalogu fragmentów).
+     */
+    using Chunk = uint32_t;
+
+    /**
+     * @brief Skanuje katalog świata i uruchamia wątki wejścia-wyjścia.
+     *
+     * @param directory Katalog z plikami fragmentów.
+     * @param loadRadius Odległość, do której fragmenty są wczytywane.
+     * @param unloadRadius Odległość, od której fragmenty są zwalniane (nie mniejsza niż loadRadius).
+     * @param memoryBudget Budżet pamięci fragmentów w bajtach.
+     * @param bytesPerObject Szacowany koszt jednego obiektu w silniku (pamięć CPU i GPU).
+     * @param threadCount Liczba wątków wejścia-wyjścia.
+     */
+    ChunkStreamer(const std::string& directory, float loadRadius, float unloadRadius, size_t memoryBudget, size_t bytesPerObject, unsigned int threadCount = 2);
+
+    /**
+     * @brief Kończy wątki wejścia-wyjścia (po dokończeniu bieżących odczytów).
+     */
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    /**
+     * @brief Odbiera wczytane fragmenty i wyznacza fragmenty do wczytania i zwolnienia.
+     *
+     * @param position Pozycja obserwatora.
+     */
+    void update(const glm::vec3& position);
+
+    /**
+     * @brief Przekazuje silnikowi fragmenty wybrane do zwolnienia.
+     *
+     * @param destroy Funkcja void(Chunk) usuwająca obiekty fragmentu utworzone przez upload().
+     */
+    template <typename F>
+    void unload(F&& destroy) {
+        for (Chunk chunk : unloads) {
+            destroy(chunk);
+        }
+        unloads.clear();
+    }
+
+    /**
+     * @brief Przekazuje silnikowi obiekty wczytanych fragmentów, od najbliższych, aż wyczerpie budżet.
+     *
+     * @param budget Budżet w tym wywołaniu (np. bajty przesyłane na GPU w klatce).
+     * @param create Funkcja size_t(Chunk, const SceneObject&, const SceneMaterial*) tworząca obiekt
+     *        i zwracająca jego koszt w jednostkach budżetu; 0 oznacza obiekt pominięty, który nie
+     *        zużywa budżetu i nie jest liczony. Materiał jest pusty, gdy obiekt go nie ma.
+     * @return Liczba utworzonych obiektów (o niezerowym koszcie).
+     */
+    template <typename F>
+    size_t upload(size_t budget, F&& create) {
+        size_t count = 0;
+        size_t spent = 0;
+        while (spent < budget && !uploads.empty()) {
+            Entry& entry = chunks[uploads.front()];
+            while (spent < budget && entry.uploaded < entry.objects.size()) {
+                const SceneObject& object = entry.objects[entry.uploaded++];
+                const SceneMaterial* material = object.material < entry.materials.size() ? &entry.materials[object.material] : nullptr;
+                size_t cost = create(uploads.front(), object, material);
+                spent += cost;
+                count += cost != 0 ? 1 : 0;
+            }
+            if (entry.uploaded == entry.objects.size()) {
+                // Rekordy nie są już potrzebne - zostaje tylko szacowany koszt obiektów w silniku
+                entry.state = State::Resident;
+                std::vector<SceneObject>().swap(entry.objects);
+                std::vector<SceneMaterial>().swap(entry.materials);
+                uploads.erase(uploads.begin());
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Zwraca liczbę fragmentów w katalogu świata.
+     */
+    size_t getChunkCount() const;
+
+    /**
+     * @brief Zwraca liczbę fragmentów w pamięci (wczytanych lub przekazywanych silnikowi).
+     */
+    size_t getResidentCount() const;
+
+    /**
+     * @brief Zwraca liczbę fragmentów czekających na wątki wejścia-wyjścia lub wczytywanych.
+     */
+    size_t getPendingCount() const;
+
+    /**
+     * @brief Zwraca szacowaną pamięć fragmentów w pamięci i wczytywanych (w bajtach).
+     */
+    size_t getUsedBytes() const;
+
+    /**
+     * @brief Zwraca liczbę obiektów czekających na przekazanie silnikowi.
+     */
+    size_t getUploadBacklog() const;
+
+    /**
+     * @brief Zwraca liczbę obiektów fragmentu, którego obiekty są właśnie przekazywane silnikowi.
+     *
+     * Pozwala silnikowi zarezerwować bufory fragmentu przy pierwszym obiekcie w upload().
+     */
+    size_t getObjectCount(Chunk chunk) const;
+
+    /**
+     * @brief Zwraca nazwę pliku fragmentu o podanych współrzędnych siatki.
+     */
+    static std::string chunkFileName(int x, int z);
+
+private:
+    /**
+     * @brief Stan fragmentu.
+     */
+    enum class State {
+        Unloaded,    /**< Fragment tylko na dysku. */
+        Queued,      /**< Czeka na wątek wejścia-wyjścia. */
+        Loading,     /**< Wczytywany przez wątek wejścia-wyjścia. */
+        Loaded,      /**< Rekordy w pamięci, obiekty przekazywane silnikowi. */
+        Resident     /**< Wszystkie obiekty przekazane silnikowi. */
+    };
+
+    /**
+     * @struct Entry
+     * @brief Fragment w katalogu świata.
+     *
+     * Stan fragmentów Queued i Loading zmieniany jest tylko pod blokadą `mutex`; wątki
+     * wejścia-wyjścia czytają poza tym jedynie stałą ścieżkę pliku.
+     */
+    struct Entry {
+        glm::ivec2 cell;                        /**< Współrzędne fragmentu w siatce (x, z). */
+        std::string path;                       /**< Ścieżka do pliku fragmentu. */
+        size_t bytes = 0;                       /**< Szacowana pamięć fragmentu w silniku. */
+        State state = State::Unloaded;          /**< Stan fragmentu. */
+        float distance = 0.0f;                  /**< Odległość od obserwatora w ostatnim update(). */
+        std::vector<SceneObject> objects;       /**< Rekordy wczytanego fragmentu. */
+        std::vector<SceneMaterial> materials;   /**< Materiały wczytanego fragmentu. */
+        size_t uploaded = 0;                    /**< Liczba obiektów przekazanych silnikowi. */
+    };
+
+    /**
+     * @struct Result
+     * @brief Fragment odczytany przez wątek wejścia-wyjścia.
+     */
+    struct Result {
+        Chunk chunk;                            /**< Fragment. */
+        std::vector<SceneObject> objects;       /**< Rekordy obiektów. */
+        std::vector<SceneMaterial> materials;   /**< Materiały. */
+    };
+
+    /**
+     * @brief Pętla wątku wejścia-wyjścia.
+     */
+    void ioLoop();
+
+    /**
+     * @brief Oznacza fragment do zwolnienia przez unload().
+     */
+    void release(Chunk chunk);
+
+    float loadRadius;
+    float unloadRadius;
+    size_t memoryBudget;
+    std::vector<Entry> chunks;
+    std::vector<Chunk> uploads;
+    std::vector<Chunk> unloads;
+    size_t usedBytes = 0;
+    size_t residentCount = 0;
+    size_t pendingCount = 0;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<Chunk> requests;
+    std::vector<Result> results;
+    std::vector<std::thread> threads;
+    bool running = true;
+};
+
+#endif // CHUNKSTREAMER_H
@@ -0,0 +1,124 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <glm/glm.hpp>
+
+#include "BoundingBox.h"
+#include "ObjectPool.h"
+#include "PhysicsWorld.h"
+#include "SceneGraph.h"
+#include "ScenePicker.h"
+#include "SpatialHash.h"
+
+class ShapeObject;
+
+/**
+ * @struct Renderable
+ * @brief Geometria encji - obiekt posiadający bufory wierzchołków i teksturę.
+ *
+ * Systemy odrzucania czytają granice z komponentu Bounds; do obiektu sięgają dopiero przy
+ * rysowaniu albo przesyłaniu wierzchołków.
+ */
+struct Renderable {
+    ShapeObject* shape;      /**< Obiekt z geometrią (właścicielem jest encja albo pula - komponent Pooled). */
+};
+
+/**
+ * @struct Bounds
+ * @brief Prostopadłościan otaczający encji w przestrzeni świata.
+ */
+struct Bounds {
+    BoundingBox box;         /**< Aktualne granice. */
+};
+
+/**
+ * @struct StaticGeometry
+ * @brief Znacznik nieruchomej geometrii scalanej w paczki StaticBatch.
+ */
+struct StaticGeometry {};
+
+/**
+ * @struct DynamicBody
+ * @brief Znacznik ruchomego obiektu rysowanego przez GpuScene.
+ */
+struct DynamicBody {};
+
+/**
+ * @struct Pooled
+ * @brief Uchwyt obiektu w puli - geometria encji należy do puli, a nie do encji.
+ */
+struct Pooled {
+    PoolHandle handle;       /**< Uchwyt obiektu z komponentu Renderable w puli. */
+};
+
+/**
+ * @struct Thrown
+ * @brief Znacznik sześcianu wrzuconego do sceny przez gracza - tylko takie usuwa kliknięcie.
+ */
+struct Thrown {};
+
+/**
+ * @struct PhysicsBody
+ * @brief Powiązanie encji z ciałem sztywnym - pozycja i orientacja ruchomych encji pochodzą z symulacji.
+ */
+struct PhysicsBody {
+    PhysicsWorld::Body body; /**< Ciało w PhysicsWorld. */
+};
+
+/**
+ * @struct Collidable
+ * @brief Zderzacz encji w siatce kolizyjnej (SpatialHash).
+ */
+struct Collidable {
+    SpatialHash::Collider collider; /**< Uchwyt zderzacza. */
+};
+
+/**
+ * @struct Pickable
+ * @brief Obiekt encji w indeksie wybierania promieniem (ScenePicker).
+ */
+struct Pickable {
+    ScenePicker::Target target; /**< Uchwyt obiektu. */
+};
+
+/**
+ * @struct SceneLink
+ * @brief Powiązanie encji z węzłem grafu sceny, z którego pobierana jest jej pozycja.
+ */
+struct SceneLink {
+    SceneGraph::Node node;   /**< Węzeł grafu sceny. */
+};
+
+/**
+ * @struct Light
+ * @brief Komponent punktowego źródła światła.
+ *
+ * Przechowuje pozycję, kolor oraz zasięg dookólnej mapy cieni. Pole `slot` wyznacza kafelki
+ * światła w atlasie cieni (ShadowAtlas) lub warstwy w tablicy map sześciennych (OmniShadowMap).
+ */
+struct Light {
+    glm::vec3 position;      /**< Pozycja światła w przestrzeni 3D. */
+    glm::vec3 color;         /**< Kolor światła. */
+    float farPlane;          /**< Zasięg dookólnej mapy cieni. */
+    float radius;            /**< Promień wpływu, poza którym osłabione światło spada poniżej progu. */
+    int shadowResolution;    /**< Bok kafelka ściany w atlasie cieni wybrany w bieżącej klatce. */
+    int slot;                /**< Indeks światła w atlasie cieni i tablicy map sześciennych. */
+    bool visible;            /**< Czy sfera wpływu przecina frustum kamery w bieżącej klatce. */
+};
+
+/**
+ * @struct Camera
+ * @brief Komponent kamery - stan obserwatora (Observer).
+ */
+struct Camera {
+    glm::vec3 position;      /**< Pozycja kamery. */
+    glm::vec3 target;        /**< Punkt, na który patrzy kamera. */
+    glm::vec3 up;            /**< Wektor określający górę. */
+    float pitch;             /**< Kąt nachylenia w stopniach. */
+    float yaw;               /**< Kąt obrotu w stopniach. */
+    float fov;               /**< Pionowy kąt widzenia w stopniach. */
+    float nearPlane;         /**< Odległość bliskiej płaszczyzny obcinania. */
+    float farPlane;          /**< Odległość dalekiej płaszczyzny obcinania. */
+};
+
+#endif // COMPONENTS_H
@@ -4,6 +4,9 @@
 #include <vector>
 #include <array>
 #include "ShapeObject.h"
+#include "VertexFormat.h"
+
+#include <glm/gtc/quaternion.hpp>
 
 #include <iostream>
 
@@ -17,6 +20,28 @@
  */
 class Cube : public ShapeObject {
 public:
+    /**
+     * @brief Liczba wierzchołków sześcianu (po 4 na ścianę, każda ściana ma własne UV i normalną).
+     */
+    static constexpr size_t VERTEX_COUNT = 24;
+
+    /**
+     * @brief Wyznacza wierzchołki sześcianu o podanej pozie bez tworzenia obiektu.
+     *
+     * Używana przez setPose() i przy scalaniu sześcianów fragmentów świata w paczki statyczne.
+     *
+     * @param center Środek sześcianu.
+     * @param orientation Orientacja sześcianu.
+     * @param halfSize Połowa długości krawędzi.
+     * @param vertices Tablica na VERTEX_COUNT * VERTEX_FLOATS wartości (pozycja, UV, normalna).
+     */
+    static void computeVertices(const glm::vec3& center, const glm::quat& orientation, float halfSize, float* vertices);
+
+    /**
+     * @brief Zwraca indeksy trójkątów wspólne dla wszystkich sześcianów (po 6 na ścianę).
+     */
+    static const std::vector<unsigned int>& getCubeIndices();
+
     /**
      * @brief Identyfikator VAO (Vertex Array Object) OpenGL.
      */
@@ -35,7 +60,7 @@ public:
     /**
      * @brief Konstruktor tworzący sześcian o określonym rozmiarze i kolorze.
      *
-     * @param size Rozmiar sześcianu (długość krawędzi).
+     * @param size Połowa długości krawędzi sześcianu.
      * @param x Współrzędna X środka sześcianu.
      * @param y Współrzędna Y środka sześcianu.
      * @param z Współrzędna Z środka sześcianu.
@@ -43,17 +68,42 @@ public:
      */
     Cube(float size, float x, float y, float z, GLuint texture);
 
+    /**
+     * @brief Oddaje VAO/VBO/EBO sześcianu na listę wolnych buforów.
+     */
+    ~Cube() override;
+
+    Cube(const Cube&) = delete;
+    Cube& operator=(const Cube&) = delete;
+
+    /**
+     * @brief Usuwa bufory OpenGL czekające na liście wolnych buforów.
+     *
+     * Wywoływana przy zamykaniu silnika, póki kontekst OpenGL jeszcze istnieje.
+     */
+    static void deleteFreeBuffers();
+
+    /**
+     * @brief Zwraca liczbę zestawów buforów czekających na ponowne użycie.
+     */
+    static size_t getFreeBufferCount();
+
     /**
      * @brief Konfiguruje bufory wierzchołków i indeksów dla OpenGL.
      *
      * Metoda przygotowuje dane wierzchołkowe, współrzędne tekstur oraz indeksy
-     * dla poprawnego renderowania sześcianu.
+     * dla poprawnego renderowania sześcianu. Jeśli na liście wolnych buforów czeka zestaw
+     * po usuniętym sześcianie, zostaje użyty ponownie - indeksy wszystkich sześcianów są
+     * identyczne, więc wystarczy nadpisać wierzchołki.
      */
     void setupBuffers();
 
     /**
      * @brief Rysuje sześcian przy użyciu podanego programu cieniującego i macierzy transformacji.
      *
+     * Każda ściana rysowana jest ze swoją teksturą; sąsiednie ściany z tą samą teksturą
+     * rysowane są jednym wywołaniem.
+     *
      * @param shaderProgram Identyfikator programu cieniującego OpenGL.
      * @param model Macierz modelu, określająca transformację obiektu w przestrzeni świata.
      * @param view Macierz widoku, określająca pozycję kamery i jej orientację.
@@ -76,6 +126,17 @@ public:
      */
     void rotate(float angle, const glm::vec3& axis) override;
 
+    /**
+     * @brief Ustawia położenie i orientację sześcianu (np. z symulacji fizyki).
+     *
+     * Wierzchołki są przeliczane od wzorcowego sześcianu, a nie od bieżących, więc wielokrotne
+     * wywołania nie kumulują błędów.
+     *
+     * @param position Środek sześcianu.
+     * @param orientation Orientacja sześcianu.
+     */
+    void setPose(const glm::vec3& position, const glm::quat& orientation);
+
     /**
      * @brief Obraca sześcian wokół osi przechodzącej przez dany punkt.
      *
@@ -101,6 +162,44 @@ public:
      */
     void rotateAround(float angle, const glm::vec3& axis);
 
+    /**
+     * @brief Zwraca prostopadłościan otaczający sześcian w przestrzeni świata.
+     *
+     * @return Aktualny prostopadłościan otaczający.
+     */
+    const BoundingBox& getBounds() const override;
+
+    /**
+     * @brief Zwraca dane wierzchołków sześcianu w przestrzeni świata.
+     *
+     * @return Widok przeplatanych danych wierzchołków.
+     */
+    std::span<const float> getVertices() const override;
+
+    /**
+     * @brief Zwraca indeksy trójkątów sześcianu.
+     *
+     * @return Wektor indeksów.
+     */
+    const std::vector<unsigned int>& getIndices() const override;
+
+    /**
+     * @brief Zwraca teksturę sześcianu.
+     *
+     * @return Identyfikator tekstury OpenGL.
+     */
+    GLuint getTexture() const override;
+
+    /**
+     * @brief Czy wszystkie ściany sześcianu mają tę samą teksturę.
+     */
+    bool hasSingleTexture() const override;
+
+    /**
+     * @brief Zwraca połowę długości krawędzi sześcianu.
+     */
+    float getHalfSize() const;
+
     /**
      * @brief Ustawia teksturę dla jednej ze ścian sześcianu.
      *
@@ -111,19 +210,52 @@ public:
 
 private:
     /**
-     * @brief Wektor przechowujący współrzędne wierzchołków sześcianu.
+     * @struct Buffers
+     * @brief Zestaw obiektów OpenGL jednego sześcianu na liście wolnych buforów.
+     */
+    struct Buffers {
+        GLuint vao;          /**< VAO z ustawionymi atrybutami. */
+        GLuint vbo;          /**< VBO o rozmiarze 24 wierzchołków. */
+        GLuint ebo;          /**< EBO z indeksami sześcianu. */
+        GLenum indexType;    /**< Typ indeksów w EBO. */
+    };
+
+    /**
+     * @brief Bufory usuniętych sześcianów czekające na ponowne użycie.
+     */
+    static std::vector<Buffers> freeBuffers;
+
+    /**
+     * @brief Pakuje wierzchołki (VertexFormat) i przesyła je do VBO po transformacji.
+     */
+    void uploadVertices();
+
+    /**
+     * @brief Czy VBO sześcianu jest nieaktualne - przesyłane dopiero przy draw().
+     *
+     * Ruchome sześciany rysowane są z buforów GpuScene, więc ich własne VBO nie jest przy ruchu aktualizowane.
+     */
+    bool verticesDirty = false;
+
+    /**
+     * @brief Połowa długości krawędzi sześcianu.
+     */
+    float halfSize;
+
+    /**
+     * @brief Prostopadłościan otaczający, odświeżany po każdej zmianie wierzchołków.
      */
-    std::vector<float> vertices;
+    BoundingBox bounds;
 
     /**
-     * @brief Wektor przechowujący współrzędne tekstur dla wierzchołków.
+     * @brief Typ indeksów w EBO (16-bitowe, gdy liczba wierzchołków na to pozwala).
      */
-    std::vector<float> texCoords;
+    GLenum indexType = GL_UNSIGNED_INT;
 
     /**
-     * @brief Wektor przechowujący indeksy wierzchołków do renderowania za pomocą EBO.
+     * @brief Współrzędne wierzchołków sześcianu, przechowywane w obiekcie (bez alokacji na stercie).
      */
-    std::vector<unsigned int> indices;
+    std::array<float, VERTEX_COUNT * VERTEX_FLOATS> vertices;
 
     /**
      * @brief Tablica przechowująca identyfikatory tekstur dla każdej ściany sześcianu.
@@ -0,0 +1,24 @@
+#ifndef DRAWCOMMAND_H
+#define DRAWCOMMAND_H
+
+#include <GL/glew.h>
+
+/**
+ * @struct DrawElementsIndirectCommand
+ * @brief Polecenie rysowania odczytywane przez `glDrawElementsIndirect` z bufora GPU.
+ *
+ * Układ pól odpowiada specyfikacji OpenGL (pięć 32-bitowych liczb, 20 bajtów), dzięki czemu
+ * ta sama tablica może być wypełniana na CPU i modyfikowana przez compute shader (std430).
+ * Ustawienie `instanceCount = 0` pomija obiekt bez zmiany pozostałych pól.
+ */
+struct DrawElementsIndirectCommand {
+    GLuint count;           /**< Liczba indeksów do narysowania. */
+    GLuint instanceCount;   /**< Liczba instancji (0 = obiekt odrzucony). */
+    GLuint firstIndex;      /**< Pierwszy indeks w buforze indeksów. */
+    GLint baseVertex;       /**< Wartość dodawana do każdego indeksu. */
+    GLuint baseInstance;    /**< Pierwsza instancja. */
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect command layout must match OpenGL");
+
+#endif // DRAWCOMMAND_H
@@ -0,0 +1,105 @@
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <iostream>
+
+/**
+ * @class DynamicResolution
+ * @brief Pozaekranowy cel renderowania o zmiennej skali, dopasowywanej do czasu klatki GPU.
+ *
+ * Tekstury koloru i głębokości mają rozmiar okna, a scena renderowana jest do ich lewego
+ * dolnego fragmentu o boku `skala * okno`. Zmiana skali nie wymaga więc ponownej alokacji.
+ * Regulator porównuje zmierzony czas klatki GPU z docelowym i zmienia skalę proporcjonalnie
+ * do pierwiastka ich stosunku (koszt cieniowania rośnie z liczbą pikseli), z tłumieniem
+ * i martwą strefą, aby skala nie oscylowała przy opóźnionych o kilka klatek pomiarach.
+ * Na koniec klatki obraz jest skalowany do okna przez `glBlitFramebuffer` z filtrem liniowym.
+ */
+class DynamicResolution {
+public:
+    /**
+     * @brief Konstruktor tworzący bufor ramki z teksturami koloru i głębokości.
+     *
+     * @param width Szerokość okna w pikselach.
+     * @param height Wysokość okna w pikselach.
+     * @param targetFrameTime Docelowy czas klatki GPU w milisekundach.
+     * @param minScale Najmniejsza dopuszczalna skala rozdzielczości.
+     */
+    DynamicResolution(int width, int height, float targetFrameTime = 16.0f, float minScale = 0.5f);
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~DynamicResolution();
+
+    /**
+     * @brief Dopasowuje rozmiar tekstur do nowego rozmiaru okna.
+     *
+     * @param width Szerokość okna w pikselach.
+     * @param height Wysokość okna w pikselach.
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Aktualizuje skalę na podstawie ostatniego zmierzonego czasu klatki GPU.
+     *
+     * @param gpuFrameTime Czas klatki GPU w milisekundach (0 = brak pomiaru).
+     */
+    void update(double gpuFrameTime);
+
+    /**
+     * @brief Podpina pozaekranowy bufor ramki i ustawia viewport na bieżącą rozdzielczość.
+     */
+    void bindForWriting() const;
+
+    /**
+     * @brief Skaluje wyrenderowany fragment do domyślnego bufora ramki (okna).
+     */
+    void resolve() const;
+
+    /**
+     * @brief Włącza lub wyłącza regulację; wyłączenie przywraca pełną rozdzielczość.
+     *
+     * @param enabled Czy skala ma być dopasowywana.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Sprawdza, czy regulacja jest włączona.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Zwraca bieżącą skalę rozdzielczości (0 - 1).
+     */
+    float getScale() const;
+
+    /**
+     * @brief Zwraca bieżący rozmiar renderowania w pikselach.
+     */
+    glm::ivec2 getRenderSize() const;
+
+    /**
+     * @brief Pobiera identyfikator tekstury głębokości.
+     */
+    GLuint getDepthTexture() const;
+
+private:
+    /**
+     * @brief Tworzy tekstury o rozmiarze okna i podpina je do bufora ramki.
+     */
+    void createTextures();
+
+    GLuint fbo = 0;
+    GLuint colorTexture = 0;
+    GLuint depthTexture = 0;
+    int width;
+    int height;
+    float targetFrameTime;
+    float minScale;
+    float scale = 1.0f;
+    bool enabled = true;
+};
+
+#endif // DYNAMICRESOLUTION_H
@@ -2,6 +2,9 @@
 #define ENGINE_H
 
 #include <iostream>
+#include <algorithm>
+#include <deque>
+#include <random>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
 
@@ -12,24 +15,64 @@
 
 
 #include "Shader.h"
+#include "Profiler.h"
 
 #include "Observer.h"
 #include "Cube.h"
 #include "BitmapHandler.h"
 #include "Wall.h"
+#include "CascadedShadowMap.h"
+#include "OmniShadowMap.h"
+#include "ShadowAtlas.h"
+#include "Frustum.h"
+#include "DynamicResolution.h"
+#include "HiZOcclusion.h"
+#include "GpuScene.h"
+#include "StreamBuffer.h"
+#include "Model.h"
+#include "StaticBatch.h"
+#include "SceneGraph.h"
+#include "World.h"
+#include "Components.h"
+#include "JobSystem.h"
+#include "ObjectPool.h"
+#include "PhysicsWorld.h"
+#include "SpatialHash.h"
+#include "ScenePicker.h"
+#include "SceneFile.h"
+#include "ChunkStreamer.h"
+#include "FrameCapture.h"
 
 /**
- * @struct Light
- * @brief Struktura reprezentująca źródło światła w scenie.
- *
- * Przechowuje pozycję, kolor oraz mapę cieni potrzebną do obliczania efektów oświetlenia.
+ * @struct GpuLight
+ * @brief Światło w układzie std140 bloku `LightBlock` fragment shadera.
+ */
+struct GpuLight {
+    glm::vec3 position;      /**< Pozycja światła. */
+    float padding0;          /**< Wyrównanie do 16 bajtów. */
+    glm::vec3 color;         /**< Kolor światła. */
+    float farPlane;          /**< Zasięg dookólnej mapy cieni. */
+    float radius;            /**< Promień wpływu. */
+    int shadowIndex;         /**< Indeks światła w tablicy map sześciennych. */
+    float padding1[2];       /**< Wyrównanie tablicy kafelków do 16 bajtów. */
+    glm::vec4 shadowTiles[6];/**< Kafelki ścian w atlasie cieni. */
+};
+
+static_assert(sizeof(GpuLight) == 144, "GpuLight must match the std140 layout of Light");
+
+/**
+ * @brief Pozycja kolejki cieni światła - obiekt i maska ścian mapy sześciennej, na które rzuca cień.
  */
-struct Light {
-    glm::vec3 position;      /**< Pozycja światła w przestrzeni 3D. */
+using ShadowDraw = GpuScene::MaskedDraw;
+
+/**
+ * @struct DirectionalLight
+ * @brief Struktura reprezentująca światło kierunkowe (słońce) z cieniami kaskadowymi.
+ */
+struct DirectionalLight {
+    glm::vec3 direction;     /**< Kierunek padania światła (od światła do sceny). */
     glm::vec3 color;         /**< Kolor światła. */
-    GLuint shadowFBO;        /**< Identyfikator FBO dla shadow mappingu. */
-    GLuint shadowMap;        /**< Identyfikator tekstury cieni. */
-    glm::mat4 lightSpaceMatrix; /**< Macierz przestrzeni światła do rzutowania cieni. */
+    bool enabled;            /**< Czy światło (i jego kaskady cieni) jest aktywne. */
 };
 
 /**
@@ -107,6 +150,202 @@ private:
      */
     static void displayCallback();
 
+    /**
+     * @brief Renderuje dookólne mapy cieni wszystkich świateł punktowych.
+     *
+     * Każde światło wymaga jednego przejścia po scenie; obiekty rysowane są tylko do ścian
+     * mapy sześciennej, w których frustum się znajdują.
+     */
+    static void renderShadowMaps();
+
+    /**
+     * @brief Wyznacza promień wpływu światła z jego koloru i współczynników osłabienia.
+     *
+     * @param color Kolor (natężenie) światła.
+     * @param cutoff Próg jasności, poniżej którego wkład światła jest pomijany.
+     * @return Promień wpływu lub 0, gdy światło nigdy nie przekracza progu.
+     */
+    static float computeInfluenceRadius(const glm::vec3& color, float cutoff);
+
+    /**
+     * @brief Odrzuca niewidoczne obiekty wspólnych buforów sceny (GpuScene) na GPU.
+     *
+     * Test frustum i test zasłonięcia względem piramidy Hi-Z poprzedniej klatki zapisują
+     * wynik w buforze poleceń multi-draw używanym przez renderScene().
+     *
+     * @param viewProjection Iloczyn macierzy projekcji i widoku kamery.
+     */
+    static void cullScene(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Odrzuca światła, których sfera wpływu nie przecina frustum kamery.
+     *
+     * Odrzucone światła nie mają przebiegu cieni ani nie są przesyłane do shadera.
+     *
+     * @param viewProjection Iloczyn macierzy projekcji i widoku kamery.
+     */
+    static void cullLights(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Odrzuca obiekty dla wszystkich widoków równolegle w systemie zadań.
+     *
+     * Zadanie kamery odrzuca światła i buduje listę obiektów dla GpuScene; po nim (zależność
+     * przez licznik) każde widoczne światło dostaje własne zadanie budujące kolejkę cieni.
+     *
+     * @param viewProjection Iloczyn macierzy projekcji i widoku kamery.
+     */
+    static void cullViews(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Buduje kolejkę cieni światła - ruchome obiekty, których granice sięgają jego ścian.
+     *
+     * @param light Światło (kopia z bieżącej klatki).
+     */
+    static void buildShadowQueue(const Light& light);
+
+    /**
+     * @brief Aktualizuje graf sceny i przepisuje macierze świata do modelu i świateł.
+     *
+     * W trybie testu obciążenia obraca korzeń ~100 tys. węzłów, więc każdy z nich jest przeliczany.
+     */
+    static void updateSceneGraph();
+
+    /**
+     * @brief Tworzy sześcian z puli (z buforami OpenGL z listy wolnych buforów) i jego encję.
+     *
+     * @param center Środek sześcianu.
+     * @param orientation Orientacja sześcianu.
+     * @param halfSize Połowa długości krawędzi.
+     * @param texture Tekstura sześcianu (0 - tekstura drewna).
+     * @return Encja sześcianu.
+     */
+    static Entity spawnCube(const glm::vec3& center, const glm::quat& orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), float halfSize = 1.0f, GLuint texture = 0);
+
+    /**
+     * @brief Tworzy encję nieruchomego sześcianu fragmentu świata - statyczne ciało, zderzacz i cel wyboru.
+     *
+     * Geometria sześcianu trafia do paczki statycznej fragmentu, więc encja nie ma obiektu
+     * z puli ani własnych buforów; jak ściany ma statyczne ciało fizyczne (rzucone sześciany
+     * na nim lądują), blokuje kamerę i można ją wybrać promieniem.
+     *
+     * @param center Środek sześcianu.
+     * @param orientation Orientacja sześcianu.
+     * @param halfSize Połowa długości krawędzi.
+     * @return Encja sześcianu.
+     */
+    static Entity spawnScenery(const glm::vec3& center, const glm::quat& orientation, float halfSize);
+
+    /**
+     * @brief Usuwa encję sześcianu wraz z jej zderzaczem, celem wyboru i ciałem fizyki.
+     *
+     * Sześcian z puli wraca do puli; encje już usunięte są pomijane.
+     */
+    static void despawnCube(Entity entity);
+
+    /**
+     * @brief Test obciążenia puli: w każdej klatce tworzy serię sześcianów i usuwa najstarsze.
+     */
+    static void updateSpawnStorm();
+
+    /**
+     * @brief Wykonuje kroki symulacji fizyki o stałej długości i przenosi pozy aktywnych ciał na sześciany.
+     */
+    static void updatePhysics();
+
+    /**
+     * @brief Przekazuje pozycję obserwatora do ChunkStreamer, usuwa obiekty i paczki zwolnionych
+     *        fragmentów i dopisuje do paczek wczytanych fragmentów tyle sześcianów, ile mieści
+     *        budżet bajtów przesyłanych w klatce.
+     */
+    static void updateStreaming();
+
+    /**
+     * @brief Wybiera obiekt spod kursora i usuwa go, jeśli jest sześcianem z puli.
+     *
+     * @param x Współrzędna X kursora w oknie.
+     * @param y Współrzędna Y kursora w oknie.
+     */
+    static void pickCube(int x, int y);
+
+    /**
+     * @brief Wczytuje teksturę materiału albo zwraca wczytaną wcześniej teksturę o tej samej ścieżce.
+     *
+     * @param path Ścieżka do tekstury.
+     * @return Identyfikator tekstury OpenGL.
+     */
+    static GLuint loadMaterial(const std::string& path);
+
+    /**
+     * @brief Tworzy encję punktowego światła zawieszoną w węźle grafu sceny pod lightRigNode.
+     *
+     * @param position Pozycja światła.
+     * @param color Kolor światła.
+     */
+    static void addLight(const glm::vec3& position, const glm::vec3& color);
+
+    /**
+     * @brief Wyznacza cienkie pudło ściany (środek, orientację i półwymiary) z jej wierzchołków.
+     */
+    static void getWallBox(const ShapeObject& wall, glm::vec3& center, glm::quat& orientation, glm::vec3& halfExtents);
+
+    /**
+     * @brief Zapisuje scenę (ściany, sześciany, materiały, światła i kamerę) do pliku SceneFile.
+     *
+     * @param path Ścieżka do pliku sceny.
+     */
+    static void saveScene(const std::string& path);
+
+    /**
+     * @brief Włącza lub wyłącza nagrywanie klatek do katalogu CAPTURE_DIRECTORY.
+     *
+     * @param format CAPTURE_FORMAT_PNG (sekwencja plików) lub CAPTURE_FORMAT_Y4M (jeden plik wideo).
+     */
+    static void toggleCapture(uint32_t format);
+
+    /**
+     * @brief Odtwarza scenę z pliku SceneFile.
+     *
+     * Sześciany, światła i kamera tworzone są od razu; ściany trafiają do `walls`, bo przed
+     * utworzeniem encji muszą zostać scalone w StaticBatch.
+     *
+     * @param path Ścieżka do pliku sceny.
+     * @param walls Wyjściowa lista ścian.
+     * @return false, jeśli pliku nie ma albo ma niepoprawny format.
+     */
+    static bool loadScene(const std::string& path, std::vector<ShapeObject*>& walls);
+
+    /**
+     * @brief Dobiera rozmiary kafelków świateł na podstawie pokrycia ekranu i układa atlas cieni.
+     */
+    static void updateShadowAtlas();
+
+    /**
+     * @brief Renderuje kaskady mapy cieni światła kierunkowego.
+     *
+     * @param aspect Stosunek szerokości do wysokości obrazu kamery.
+     */
+    static void renderCascadeShadowMaps(float aspect);
+
+    /**
+     * @brief Wypełnia bufor głębokości bez cieniowania (przebieg wstępny).
+     *
+     * Po nim przebieg koloru rysowany jest z testem `GL_EQUAL`, więc pełne oświetlenie
+     * liczone jest tylko raz dla każdego widocznego piksela.
+     *
+     * @param view Macierz widoku kamery.
+     * @param projection Macierz projekcji kamery.
+     */
+    static void renderDepthPrepass(const glm::mat4& view, const glm::mat4& projection);
+
+    /**
+     * @brief Rysuje wszystkie obiekty sceny (ściany, sześciany, znaczniki świateł) podanym programem.
+     *
+     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param view Macierz widoku kamery.
+     * @param projection Macierz projekcji kamery.
+     */
+    static void renderScene(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection);
+
     /**
      * @brief Obsługa zdarzeń klawiatury (przekierowanie do `keyboard`).
      *
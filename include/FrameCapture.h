@@ -0,0 +1,167 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Format zapisu: sekwencja plików PNG (frame_000000.png, ...) w katalogu.
+ */
+constexpr uint32_t CAPTURE_FORMAT_PNG = 0;
+
+/**
+ * @brief Format zapisu: jeden plik wideo Y4M (YUV 4:2:0, bez kompresji).
+ */
+constexpr uint32_t CAPTURE_FORMAT_Y4M = 1;
+
+/**
+ * @class FrameCapture
+ * @brief Asynchroniczny zapis klatek na dysk bez blokowania wątku renderowania.
+ *
+ * Obraz kopiowany jest przez `glReadPixels` do jednego z pierścienia buforów GL_PIXEL_PACK_BUFFER,
+ * a za kopią stawiany jest `glFenceSync`. W kolejnych klatkach płoty sprawdzane są bez czekania;
+ * bufor, którego kopia się zakończyła, trafia do wątku zapisu, który czyta piksele wprost z trwale
+ * zmapowanej pamięci bufora, koduje je i oddaje bufor do ponownego użycia. Gdy wszystkie bufory są
+ * zajęte (GPU lub dysk nie nadąża), klatka jest pomijana i liczona jako utracona - wątek
+ * renderowania nigdy nie czeka.
+ */
+class FrameCapture {
+public:
+    /**
+     * @brief Konstruktor.
+     *
+     * @param slotCount Liczba buforów w pierścieniu (klatek w locie między GPU a dyskiem).
+     */
+    explicit FrameCapture(int slotCount = 4);
+
+    /**
+     * @brief Destruktor - dokańcza zapis przechwyconych klatek i zwalnia bufory.
+     */
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * @brief Rozpoczyna nagrywanie.
+     *
+     * @param path Katalog na pliki PNG albo ścieżka pliku Y4M.
+     * @param format CAPTURE_FORMAT_PNG lub CAPTURE_FORMAT_Y4M.
+     * @param width Szerokość obrazu (domyślnego bufora ramki).
+     * @param height Wysokość obrazu.
+     * @param framesPerSecond Liczba klatek na sekundę zapisywana w nagłówku Y4M.
+     * @return false, jeśli nie można utworzyć wyjścia, bufory są niedostępne albo poprzednie
+     *         nagranie wciąż jest zapisywane.
+     */
+    bool start(const std::string& path, uint32_t format, int width, int height, int framesPerSecond);
+
+    /**
+     * @brief Kończy nagrywanie; kopie w locie są odbierane w kolejnych wywołaniach capture().
+     */
+    void stop();
+
+    /**
+     * @brief Odbiera zakończone kopie i zleca kopię bieżącej klatki (wywoływane po narysowaniu
+     *        klatki do domyślnego bufora ramki, przed zamianą buforów).
+     */
+    void capture();
+
+    /**
+     * @brief Czy nagrywanie jest włączone.
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief Czy nagrywanie jest włączone albo na GPU pozostały jeszcze kopie do odebrania.
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Zwraca liczbę klatek przekazanych do zapisu w bieżącym nagraniu.
+     */
+    size_t getCapturedCount() const;
+
+    /**
+     * @brief Zwraca liczbę klatek zapisanych na dysk w bieżącym nagraniu.
+     */
+    size_t getWrittenCount() const;
+
+    /**
+     * @brief Zwraca liczbę klatek pominiętych z braku wolnego bufora.
+     */
+    size_t getDroppedCount() const;
+
+private:
+    /**
+     * @brief Maksymalna liczba buforów w pierścieniu.
+     */
+    static const int MAX_SLOTS = 8;
+
+    /**
+     * @struct Slot
+     * @brief Bufor kopii jednej klatki.
+     */
+    struct Slot {
+        GLuint buffer = 0;                      /**< Bufor GL_PIXEL_PACK_BUFFER. */
+        const unsigned char* mapped = nullptr;  /**< Trwałe mapowanie bufora. */
+        GLsync fence = nullptr;                 /**< Płot za kopią klatki. */
+    };
+
+    /**
+     * @brief Pętla wątku zapisu.
+     */
+    void writerLoop();
+
+    /**
+     * @brief Przekazuje wątkowi zapisu bufory, których kopia się zakończyła.
+     *
+     * @param wait Czy czekać na płoty (tylko przy niszczeniu obiektu).
+     */
+    void collect(bool wait);
+
+    /**
+     * @brief Dołącza wątek zapisu, jeśli zakończył pracę (albo czeka na niego, gdy `wait`).
+     */
+    void joinWriter(bool wait);
+
+    /**
+     * @brief Usuwa bufory pierścienia.
+     */
+    void releaseBuffers();
+
+    int slotCount;
+    Slot slots[MAX_SLOTS];
+    size_t bufferSize = 0;
+    std::deque<int> pending;
+
+    std::string path;
+    uint32_t format = CAPTURE_FORMAT_Y4M;
+    int width = 0;
+    int height = 0;
+    std::ofstream video;
+    bool recording = false;
+    bool stopping = false;
+    size_t capturedCount = 0;
+    size_t droppedCount = 0;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<int> freeSlots;
+    std::deque<int> frames;
+    bool finishing = false;
+    std::thread writer;
+    std::atomic<bool> writerDone{ true };
+    std::atomic<size_t> writtenCount{ 0 };
+};
+
+#endif // FRAMECAPTURE_H
@@ -0,0 +1,53 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+#include "BoundingBox.h"
+
+/**
+ * @class Frustum
+ * @brief Ostrosłup widzenia opisany sześcioma płaszczyznami w przestrzeni świata.
+ *
+ * Płaszczyzny wyznaczane są bezpośrednio z macierzy (rzut * widok), dzięki czemu ta sama klasa
+ * służy do odrzucania obiektów i świateł dla kamery oraz dla widoków świateł.
+ */
+class Frustum {
+public:
+    /**
+     * @brief Konstruktor domyślny tworzący frustum bez płaszczyzn (wszystko widoczne).
+     */
+    Frustum() = default;
+
+    /**
+     * @brief Konstruktor wyznaczający płaszczyzny z macierzy rzutu i widoku.
+     *
+     * @param viewProjection Iloczyn macierzy projekcji i widoku.
+     */
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Sprawdza, czy sfera przecina frustum lub leży w jego wnętrzu.
+     *
+     * @param center Środek sfery.
+     * @param radius Promień sfery.
+     * @return true, jeśli sfera może być widoczna.
+     */
+    bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+    /**
+     * @brief Sprawdza, czy prostopadłościan przecina frustum lub leży w jego wnętrzu.
+     *
+     * @param box Prostopadłościan otaczający.
+     * @return true, jeśli prostopadłościan może być widoczny.
+     */
+    bool intersectsBox(const BoundingBox& box) const;
+
+private:
+    /**
+     * @brief Płaszczyzny (normalna skierowana do wnętrza, odległość w w): lewa, prawa, dolna, górna, bliska, daleka.
+     */
+    glm::vec4 planes[6] = {};
+};
+
+#endif // FRUSTUM_H
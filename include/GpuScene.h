@@ -0,0 +1,254 @@
+#ifndef GPUSCENE_H
+#define GPUSCENE_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ShapeObject.h"
+#include "DrawCommand.h"
+#include "StreamBuffer.h"
+#include "VertexFormat.h"
+
+/**
+ * @class GpuScene
+ * @brief Geometria wszystkich obiektów sceny we wspólnych buforach, rysowana przez multi-draw indirect.
+ *
+ * Wierzchołki i indeksy ruchomych obiektów (sześcianów) przechowywane są w jednym VBO/EBO z jednym VAO.
+ * Każdy materiał (tekstura) ma ciągły zakres slotów z zapasem wolnych miejsc, a slot to
+ * polecenie `DrawElementsIndirectCommand` (z `baseInstance` równym indeksowi slotu), rekord
+ * w buforze SSBO z danymi obiektu (prostopadłościan otaczający) i zakres wierzchołków i indeksów.
+ * Compute shader odrzucania zapisuje widoczność bezpośrednio w poleceniach, a każdy przebieg
+ * rysowany jest jednym wywołaniem `glMultiDrawElementsIndirect` na materiał - liczba wywołań
+ * nie zależy od liczby obiektów.
+ *
+ * Obiekty rozpoznawane są po ShapeObject::getId(), więc obiekt z puli utworzony pod adresem
+ * zwolnionego dostaje nowy slot. Nowy obiekt zajmuje wolny slot swojego materiału i przesyła tylko
+ * swoje dane i polecenie; usunięty obiekt zeruje liczbę indeksów polecenia i oddaje slot na listę
+ * wolnych. Przesunięte obiekty (wykryte przez ShapeObject::getRevision()) aktualizują wyłącznie swój
+ * zakres wierzchołków. Bufory są przebudowywane tylko, gdy materiałowi zabraknie slotów albo pojawi
+ * się nowy materiał - pojemność rośnie wtedy dwukrotnie. Nowe dane zapisywane są do trwale
+ * zmapowanego bufora pierścieniowego (StreamBuffer) i kopiowane na GPU przez `glCopyBufferSubData`,
+ * więc aktualizacja nie czeka na rysowanie poprzednich klatek.
+ *
+ * Wierzchołki przechowywane są w układzie VertexFormat (PackedVertex), a indeksy - lokalne
+ * dla każdego obiektu dzięki `baseVertex` - jako 16-bitowe, jeśli mieści się w nich największy obiekt.
+ *
+ * Przebiegi cieni korzystają z tych samych buforów: drawDepth() rysuje kopię poleceń bez
+ * odrzucania, a drawMasked() - podzbiór obiektów pogrupowany według maski ścian.
+ *
+ * Obiekty z różnymi teksturami na ścianach (ShapeObject::hasSingleTexture()) nie mieszczą się
+ * w podziale na materiały - rysowane są osobno, własnym draw(), i nie podlegają odrzucaniu na GPU.
+ */
+class GpuScene {
+public:
+    /**
+     * @struct MaskedDraw
+     * @brief Obiekt rysowany z własną wartością uniformu maski (np. ścian mapy sześciennej).
+     */
+    struct MaskedDraw {
+        ShapeObject* object;        /**< Obiekt zsynchronizowany przez sync(). */
+        int mask;                   /**< Wartość uniformu maski. */
+    };
+
+    /**
+     * @brief Konstruktor tworzący wspólne bufory i VAO.
+     */
+    GpuScene();
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~GpuScene();
+
+    /**
+     * @brief Uzgadnia bufory GPU z bieżącym zbiorem obiektów.
+     *
+     * @param objects Obiekty sceny (kolejność nie ma znaczenia dla rysowania).
+     */
+    void sync(const std::vector<ShapeObject*>& objects);
+
+    /**
+     * @brief Rysuje wszystkie widoczne obiekty - jedno wywołanie multi-draw na materiał.
+     *
+     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param view Macierz widoku.
+     * @param projection Macierz projekcji.
+     */
+    void draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) const;
+
+    /**
+     * @brief Rysuje wszystkie obiekty bez odrzucania do mapy głębi - jedno wywołanie multi-draw.
+     *
+     * Przebiegi głębi nie próbkują tekstur, więc wszystkie materiały rysowane są razem z kopii
+     * poleceń, której nie nadpisuje compute shader odrzucania kamery.
+     *
+     * @param shaderProgram Program głębi (uniform `model`).
+     */
+    void drawDepth(GLuint shaderProgram) const;
+
+    /**
+     * @brief Rysuje wybrane obiekty do mapy głębi - jedno wywołanie multi-draw na wartość maski.
+     *
+     * Polecenia obiektów sortowane są według maski i zapisywane do osobnego bufora poleceń.
+     *
+     * @param shaderProgram Program głębi (uniform `model`).
+     * @param maskLocation Położenie uniformu maski w programie.
+     * @param draws Obiekty z maskami (kolejność zostaje zmieniona).
+     */
+    void drawMasked(GLuint shaderProgram, GLint maskLocation, std::vector<MaskedDraw>& draws);
+
+    /**
+     * @brief Pobiera bufor SSBO z danymi obiektów.
+     */
+    GLuint getObjectBuffer() const;
+
+    /**
+     * @brief Pobiera bufor poleceń rysowania pośredniego.
+     */
+    GLuint getCommandBuffer() const;
+
+    /**
+     * @brief Zwraca liczbę slotów w buforach (zajętych i wolnych) - zakres pracy odrzucania.
+     */
+    GLuint getObjectCount() const;
+
+    /**
+     * @brief Zwraca liczbę wywołań rysowania na przebieg (materiały i obiekty rysowane osobno).
+     */
+    size_t getDrawCallCount() const;
+
+    /**
+     * @brief Pobiera bufor pierścieniowy używany do aktualizacji obiektów (liczniki przestojów i przepełnień).
+     */
+    const StreamBuffer& getStagingBuffer() const;
+
+private:
+    /**
+     * @struct ObjectSlot
+     * @brief Położenie obiektu we wspólnych buforach.
+     */
+    struct ObjectSlot {
+        const ShapeObject* object;  /**< Obiekt sceny albo nullptr dla wolnego slotu. */
+        uint64_t id;                /**< Identyfikator obiektu (ShapeObject::getId()), nie jego adres. */
+        uint64_t revision;          /**< Wersja wierzchołków przesłana do GPU. */
+        uint64_t syncStamp;         /**< Numer ostatniego sync(), w którym obiekt był w scenie. */
+        GLuint material;            /**< Indeks materiału, do którego należy slot. */
+        GLint baseVertex;           /**< Pierwszy wierzchołek slotu w VBO. */
+        GLuint firstIndex;          /**< Pierwszy indeks slotu w EBO. */
+        GLuint vertexCapacity;      /**< Liczba wierzchołków zarezerwowana dla slotu. */
+        GLuint indexCapacity;       /**< Liczba indeksów zarezerwowana dla slotu. */
+    };
+
+    /**
+     * @struct MaterialRange
+     * @brief Ciągły zakres slotów rysowanych z jedną teksturą.
+     */
+    struct MaterialRange {
+        GLuint texture;                 /**< Tekstura materiału. */
+        GLsizei first;                  /**< Pierwszy slot zakresu. */
+        GLsizei count;                  /**< Liczba slotów zakresu (zajętych i wolnych). */
+        std::vector<GLuint> freeSlots;  /**< Wolne sloty zakresu. */
+    };
+
+    /**
+     * @struct GpuObject
+     * @brief Dane obiektu w układzie std430.
+     */
+    struct GpuObject {
+        glm::vec4 boundsMin;
+        glm::vec4 boundsMax;
+    };
+
+    /**
+     * @brief Kopiuje dane do bufora docelowego przez bufor pierścieniowy.
+     *
+     * Gdy region pierścienia jest pełny, dane przesyłane są przez `glBufferSubData`
+     * (a pierścień powiększa się w następnej klatce).
+     *
+     * @param destination Bufor docelowy.
+     * @param offset Przesunięcie w buforze docelowym.
+     * @param data Dane do przesłania.
+     * @param size Rozmiar danych w bajtach.
+     */
+    void upload(GLuint destination, GLintptr offset, const void* data, size_t size);
+
+    /**
+     * @brief Kopiuje zapisany już zakres bufora pierścieniowego do bufora docelowego.
+     *
+     * @param destination Bufor docelowy.
+     * @param offset Przesunięcie w buforze docelowym.
+     * @param stagingOffset Przesunięcie danych w buforze pierścieniowym.
+     * @param size Rozmiar danych w bajtach.
+     */
+    void copyFromStaging(GLuint destination, GLintptr offset, GLintptr stagingOffset, size_t size);
+
+    /**
+     * @brief Umieszcza nowy obiekt w wolnym slocie jego materiału.
+     *
+     * @param object Obiekt sceny.
+     * @return false, gdy materiał nie istnieje albo nie ma wolnego slotu o wystarczającej pojemności.
+     */
+    bool allocate(const ShapeObject* object);
+
+    /**
+     * @brief Zwalnia slot obiektu usuniętego ze sceny.
+     *
+     * @param slot Indeks slotu.
+     */
+    void release(GLuint slot);
+
+    /**
+     * @brief Przesyła wierzchołki i prostopadłościan obiektu ze slotu.
+     *
+     * @param slot Indeks slotu.
+     */
+    void uploadGeometry(GLuint slot);
+
+    /**
+     * @brief Przesyła indeksy i polecenie rysowania slotu.
+     *
+     * @param slot Indeks slotu.
+     */
+    void uploadCommand(GLuint slot);
+
+    /**
+     * @brief Zapisuje polecenie slotu do bufora poleceń kamery i do kopii bez odrzucania.
+     *
+     * @param slot Indeks slotu.
+     * @param command Polecenie rysowania.
+     */
+    void writeCommand(GLuint slot, const DrawElementsIndirectCommand& command);
+
+    /**
+     * @brief Układa obiekty według materiału z zapasem slotów i przesyła całą geometrię oraz polecenia.
+     *
+     * @param objects Obiekty sceny.
+     */
+    void rebuild(const std::vector<ShapeObject*>& objects);
+
+    GLuint vao = 0;
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0;
+    GLuint objectBuffer = 0;
+    GLuint commandBuffer = 0;
+    GLuint depthCommandBuffer = 0;
+    GLuint maskedCommandBuffer = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    StreamBuffer staging;
+    uint64_t syncStamp = 0;
+    std::vector<ShapeObject*> separateObjects;
+    std::vector<const ShapeObject*> addedObjects;
+    std::vector<ObjectSlot> slots;
+    std::unordered_map<uint64_t, GLuint> slotOfObject;
+    std::vector<MaterialRange> materials;
+    std::vector<GpuObject> gpuObjects;
+    std::vector<PackedVertex> packedScratch;
+    std::vector<DrawElementsIndirectCommand> maskedCommands;
+    std::vector<std::pair<int, GLsizei>> maskedRuns;
+};
+
+#endif // GPUSCENE_H
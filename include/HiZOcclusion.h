@@ -0,0 +1,93 @@
+#ifndef HIZOCCLUSION_H
+#define HIZOCCLUSION_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+
+/**
+ * @class HiZOcclusion
+ * @brief Odrzucanie zasłoniętych obiektów na GPU przy użyciu hierarchicznego bufora Z (Hi-Z).
+ *
+ * Po zakończeniu klatki compute shader kopiuje bufor głębokości do poziomu 0 tekstury `R32F`
+ * i buduje kolejne poziomy mipmap, zapisując w każdym tekselu największą (najdalszą) głębokość
+ * z obszaru 2x2 poziomu niższego. W następnej klatce drugi compute shader rzutuje prostopadłościan
+ * otaczający każdego obiektu macierzą poprzedniej klatki, wybiera poziom, na którym zajmuje on
+ * najwyżej 2x2 teksele, i porównuje jego najbliższą głębokość z zapisaną. Wynik (wraz z testem
+ * frustum bieżącej kamery) trafia do pola `instanceCount` poleceń rysowania pośredniego (GpuScene), więc
+ * zasłonięte obiekty nie są w ogóle rasteryzowane, a CPU nie czeka na odczyt wyników.
+ */
+class HiZOcclusion {
+public:
+    /**
+     * @brief Konstruktor tworzący piramidę Hi-Z i programy obliczeniowe.
+     *
+     * @param width Szerokość bufora głębokości w pikselach.
+     * @param height Wysokość bufora głębokości w pikselach.
+     */
+    HiZOcclusion(int width, int height);
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~HiZOcclusion();
+
+    /**
+     * @brief Dopasowuje piramidę do nowego rozmiaru bufora głębokości.
+     *
+     * Do czasu zbudowania nowej piramidy test zasłonięcia jest wyłączony.
+     *
+     * @param width Szerokość bufora głębokości w pikselach.
+     * @param height Wysokość bufora głębokości w pikselach.
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Buduje piramidę Hi-Z z bufora głębokości zakończonej klatki.
+     *
+     * @param depthTexture Tekstura głębokości klatki.
+     * @param renderSize Rozmiar wypełnionego fragmentu tekstury (rozdzielczość dynamiczna).
+     * @param viewProjection Macierz rzutu i widoku, z którą klatka została wyrenderowana.
+     */
+    void buildPyramid(GLuint depthTexture, const glm::ivec2& renderSize, const glm::mat4& viewProjection);
+
+    /**
+     * @brief Uruchamia test widoczności obiektów na GPU.
+     *
+     * Wynik zapisywany jest w polu `instanceCount` poleceń w buforze `commandBuffer`.
+     *
+     * @param objectBuffer Bufor SSBO z prostopadłościanami otaczającymi obiektów.
+     * @param commandBuffer Bufor poleceń rysowania pośredniego (w tej samej kolejności).
+     * @param objectCount Liczba obiektów.
+     * @param viewProjection Macierz rzutu i widoku bieżącej klatki.
+     * @param testOcclusion false = wyłącznie test frustum.
+     */
+    void cull(GLuint objectBuffer, GLuint commandBuffer, GLuint objectCount, const glm::mat4& viewProjection, bool testOcclusion);
+
+    /**
+     * @brief Pobiera teksturę piramidy Hi-Z.
+     *
+     * @return Identyfikator tekstury `GL_TEXTURE_2D` z mipmapami.
+     */
+    GLuint getPyramidTexture() const;
+
+private:
+    /**
+     * @brief Tworzy teksturę piramidy o bieżącym rozmiarze.
+     */
+    void createPyramid();
+
+    Shader* buildShader;
+    Shader* cullShader;
+    GLuint pyramidTexture = 0;
+    int width;
+    int height;
+    int levelCount = 1;
+    bool pyramidValid = false;
+    glm::vec2 pyramidScale = glm::vec2(1.0f);
+    glm::mat4 pyramidViewProjection = glm::mat4(1.0f);
+};
+
+#endif // HIZOCCLUSION_H
@@ -0,0 +1,170 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JobCounter
+ * @brief Licznik niedokończonych zadań, na który można czekać lub od którego mogą zależeć inne zadania.
+ *
+ * Każde zadanie uruchomione z licznikiem zwiększa go przy zleceniu i zmniejsza po wykonaniu.
+ * Zadania zlecone przez JobSystem::runAfter() czekają w liczniku, aż spadnie on do zera.
+ */
+class JobCounter {
+public:
+    /**
+     * @brief Sprawdza, czy wszystkie zadania licznika zostały wykonane.
+     *
+     * Przed zniszczeniem licznika należy na niego poczekać przez JobSystem::wait().
+     */
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    /**
+     * @struct Continuation
+     * @brief Zadanie czekające na wyzerowanie licznika.
+     */
+    struct Continuation {
+        std::function<void()> function;    /**< Funkcja zadania. */
+        JobCounter* counter;                /**< Licznik zadania zależnego (może być pusty). */
+    };
+
+    std::atomic<int> pending{ 0 };
+    std::mutex mutex;
+    std::vector<Continuation> continuations;
+};
+
+/**
+ * @class JobSystem
+ * @brief Harmonogram zadań z kradzieżą pracy (work stealing) na wątkach roboczych.
+ *
+ * Każdy wątek (także wątek, który utworzył system - indeks 0) ma własną kolejkę dwustronną:
+ * właściciel zdejmuje najnowsze zadania z końca (ciepłe w pamięci podręcznej), a bezczynne wątki
+ * kradną najstarsze z początku cudzych kolejek. Czekanie na licznik nie blokuje wątku - w tym
+ * czasie wykonuje on inne zadania, więc zadania mogą bezpiecznie czekać na swoje podzadania.
+ *
+ * Kolejki chronione są krótkimi blokadami; zadania powinny więc być rzędu mikrosekund lub
+ * dłuższe - parallelFor() dzieli zakres na porcje co najmniej `grain` elementów.
+ */
+class JobSystem {
+public:
+    /**
+     * @brief Tworzy system z podaną liczbą wątków (łącznie z wątkiem wywołującym).
+     *
+     * @param threadCount Liczba wątków; 0 oznacza liczbę wątków sprzętowych.
+     */
+    explicit JobSystem(unsigned int threadCount = 0);
+
+    /**
+     * @brief Kończy wątki robocze po wykonaniu zleconych zadań.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Zleca zadanie.
+     *
+     * @param job Funkcja zadania.
+     * @param counter Licznik zmniejszany po wykonaniu zadania (opcjonalny).
+     */
+    void run(std::function<void()> job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Zleca zadanie, które zostanie uruchomione po wykonaniu wszystkich zadań licznika zależności.
+     *
+     * @param dependency Licznik, na który czeka zadanie.
+     * @param job Funkcja zadania.
+     * @param counter Licznik zmniejszany po wykonaniu zadania (opcjonalny).
+     */
+    void runAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Czeka na wykonanie zadań licznika, w międzyczasie wykonując inne zadania.
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Wykonuje funkcję dla zakresu [0, count) podzielonego na porcje i czeka na zakończenie.
+     *
+     * @param count Liczba elementów.
+     * @param grain Minimalna liczba elementów w porcji.
+     * @param body Funkcja wywoływana dla porcji [begin, end).
+     */
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+
+    /**
+     * @brief Zwraca liczbę wątków (łącznie z wątkiem głównym).
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * @brief Zwraca liczbę zadań skradzionych z cudzych kolejek od utworzenia systemu.
+     */
+    size_t getStealCount() const;
+
+private:
+    /**
+     * @struct Job
+     * @brief Zlecone zadanie z licznikiem.
+     */
+    struct Job {
+        std::function<void()> function;    /**< Funkcja zadania. */
+        JobCounter* counter;                /**< Licznik zadania (może być pusty). */
+    };
+
+    /**
+     * @struct WorkerQueue
+     * @brief Kolejka zadań jednego wątku.
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    /**
+     * @brief Pętla wątku roboczego.
+     */
+    void workerLoop(unsigned int index);
+
+    /**
+     * @brief Wstawia zadanie do kolejki bieżącego wątku i budzi uśpiony wątek.
+     */
+    void push(Job job);
+
+    /**
+     * @brief Pobiera zadanie z własnej kolejki albo kradnie je z innej.
+     */
+    bool pop(unsigned int index, Job& job);
+
+    /**
+     * @brief Wykonuje zadanie i rozlicza jego licznik (uruchamiając zadania zależne).
+     */
+    void execute(Job& job);
+
+    /**
+     * @brief Zwraca indeks kolejki bieżącego wątku (0 dla wątków spoza systemu).
+     */
+    unsigned int currentIndex() const;
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<size_t> queuedJobs{ 0 };
+    std::atomic<size_t> stealCount{ 0 };
+    std::atomic<bool> running{ true };
+};
+
+#endif // JOBSYSTEM_H
@@ -0,0 +1,69 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Plik zmapowany do pamięci tylko do odczytu (mmap / MapViewOfFile).
+ *
+ * Strony pliku wczytywane są przez system dopiero przy pierwszym dostępie, więc otwarcie
+ * nawet bardzo dużego pliku kosztuje tyle samo. Mapowanie zwalniane jest w destruktorze.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Konstruktor pustego (niezmapowanego) pliku.
+     */
+    MappedFile() = default;
+
+    /**
+     * @brief Destruktor zwalniający mapowanie.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Mapuje plik.
+     *
+     * @param path Ścieżka do pliku.
+     * @return true, jeśli plik istnieje, nie jest pusty i został zmapowany.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Zwalnia mapowanie pliku.
+     */
+    void close();
+
+    /**
+     * @brief Zwraca początek zmapowanych danych (nullptr, gdy plik nie jest otwarty).
+     */
+    const unsigned char* getData() const;
+
+    /**
+     * @brief Zwraca rozmiar pliku w bajtach.
+     */
+    size_t getSize() const;
+
+    /**
+     * @brief Sprawdza, czy tablica `count` rekordów po `stride` bajtów od `offset` mieści się w pliku.
+     *
+     * Wartości pochodzą z nagłówka pliku, więc mogą być dowolne - sprawdzenie nie przepełnia się.
+     */
+    bool containsRange(uint64_t offset, uint64_t count, uint64_t stride) const;
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
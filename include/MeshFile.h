@@ -0,0 +1,177 @@
+#ifndef MESHFILE_H
+#define MESHFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/**
+ * @brief Sygnatura pliku siatki ("E3DM").
+ */
+constexpr char MESH_FILE_MAGIC[4] = { 'E', '3', 'D', 'M' };
+
+/**
+ * @brief Bieżąca wersja formatu siatki.
+ */
+constexpr uint32_t MESH_FILE_VERSION = 2;
+
+/**
+ * @brief Format wierzchołków: 8 wartości float (pozycja, UV, normalna).
+ */
+constexpr uint32_t MESH_VERTEX_FORMAT_FLOAT = 0;
+
+/**
+ * @brief Format wierzchołków: PackedVertex (pozycja float, UV half, normalna 2_10_10_10).
+ */
+constexpr uint32_t MESH_VERTEX_FORMAT_PACKED = 1;
+
+/**
+ * @brief Największa liczba poziomów szczegółowości (LOD) zapisywanych w pliku.
+ */
+constexpr uint32_t MAX_MESH_LODS = 4;
+
+/**
+ * @brief Wyrównanie sekcji danych w pliku (w bajtach).
+ */
+constexpr uint64_t MESH_FILE_ALIGNMENT = 16;
+
+/**
+ * @struct MeshFileHeader
+ * @brief Nagłówek binarnego pliku siatki.
+ *
+ * Plik składa się z nagłówka i czterech sekcji wyrównanych do 16 bajtów: przeplatanych
+ * wierzchołków (pozycja, UV, normalna - w formacie wskazanym przez `vertexFormat`), indeksów
+ * (16- lub 32-bitowych), opisów podsiatek i poziomów szczegółowości. Wszystkie poziomy LOD
+ * współdzielą wierzchołki; każdy ma własny zakres podsiatek (a więc i indeksów). Położenie sekcji zapisane jest w nagłówku, więc po zmapowaniu pliku
+ * dane można przekazać do OpenGL bez żadnego parsowania.
+ */
+struct MeshFileHeader {
+    char magic[4];              /**< Sygnatura MESH_FILE_MAGIC. */
+    uint32_t version;           /**< Wersja formatu. */
+    uint32_t vertexCount;       /**< Liczba wierzchołków. */
+    uint32_t indexCount;        /**< Liczba indeksów. */
+    uint32_t submeshCount;      /**< Liczba podsiatek. */
+    uint32_t vertexStride;      /**< Rozmiar jednego wierzchołka w bajtach. */
+    uint32_t vertexFormat;      /**< Układ atrybutów wierzchołka (MESH_VERTEX_FORMAT_FLOAT lub MESH_VERTEX_FORMAT_PACKED). */
+    uint32_t indexSize;         /**< Rozmiar indeksu w bajtach. */
+    float boundsMin[3];         /**< Najmniejszy narożnik prostopadłościanu otaczającego. */
+    float boundsMax[3];         /**< Największy narożnik prostopadłościanu otaczającego. */
+    uint64_t vertexOffset;      /**< Początek sekcji wierzchołków. */
+    uint64_t indexOffset;       /**< Początek sekcji indeksów. */
+    uint64_t submeshOffset;     /**< Początek sekcji podsiatek. */
+    uint64_t lodOffset;         /**< Początek sekcji poziomów szczegółowości. */
+    uint32_t lodCount;          /**< Liczba poziomów szczegółowości (co najmniej 1). */
+    uint32_t reserved;          /**< Wyrównanie nagłówka (zero). */
+};
+
+/**
+ * @struct MeshSubmesh
+ * @brief Zakres indeksów rysowany z jednym materiałem.
+ */
+struct MeshSubmesh {
+    uint32_t firstIndex;        /**< Pierwszy indeks podsiatki. */
+    uint32_t indexCount;        /**< Liczba indeksów podsiatki. */
+    float boundsMin[3];         /**< Najmniejszy narożnik podsiatki. */
+    float boundsMax[3];         /**< Największy narożnik podsiatki. */
+    char material[32];          /**< Nazwa materiału (zakończona zerem). */
+};
+
+/**
+ * @struct MeshLod
+ * @brief Poziom szczegółowości - zakres podsiatek i jego błąd geometryczny.
+ */
+struct MeshLod {
+    uint32_t firstSubmesh;      /**< Pierwsza podsiatka poziomu. */
+    uint32_t submeshCount;      /**< Liczba podsiatek poziomu. */
+    uint32_t indexCount;        /**< Łączna liczba indeksów poziomu. */
+    float error;                /**< Największe odchylenie od pełnej siatki (w jednostkach modelu). */
+};
+
+/**
+ * @struct MeshData
+ * @brief Siatka w pamięci - wynik importu, wejście zapisu do pliku.
+ */
+struct MeshData {
+    std::vector<float> vertices;            /**< Przeplatane wierzchołki (8 wartości float). */
+    std::vector<uint32_t> indices;          /**< Indeksy trójkątów. */
+    std::vector<MeshSubmesh> submeshes;     /**< Podsiatki wszystkich poziomów szczegółowości. */
+    std::vector<MeshLod> lods;              /**< Poziomy szczegółowości (pusty = jeden poziom ze wszystkimi podsiatkami). */
+};
+
+/**
+ * @class MeshFile
+ * @brief Zapis i odczyt binarnego formatu siatki; odczyt przez mapowanie pliku do pamięci.
+ *
+ * Odczyt nie kopiuje ani nie interpretuje danych - sprawdzany jest tylko nagłówek, a wskaźniki
+ * do sekcji wskazują bezpośrednio na zmapowany plik (MappedFile).
+ */
+class MeshFile {
+public:
+    /**
+     * @brief Konstruktor pustego (niezmapowanego) pliku.
+     */
+    MeshFile() = default;
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    /**
+     * @brief Mapuje plik siatki i sprawdza jego nagłówek.
+     *
+     * @param path Ścieżka do pliku.
+     * @return true, jeśli plik ma poprawny format i wersję.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Zwalnia mapowanie pliku.
+     */
+    void close();
+
+    /**
+     * @brief Zwraca nagłówek zmapowanego pliku.
+     */
+    const MeshFileHeader& getHeader() const;
+
+    /**
+     * @brief Zwraca wskaźnik na sekcję wierzchołków.
+     */
+    const void* getVertexData() const;
+
+    /**
+     * @brief Zwraca wskaźnik na sekcję indeksów.
+     */
+    const void* getIndexData() const;
+
+    /**
+     * @brief Zwraca wskaźnik na tablicę podsiatek.
+     */
+    const MeshSubmesh* getSubmeshes() const;
+
+    /**
+     * @brief Zwraca wskaźnik na tablicę poziomów szczegółowości (od najdokładniejszego).
+     */
+    const MeshLod* getLods() const;
+
+    /**
+     * @brief Zapisuje siatkę do pliku binarnego.
+     *
+     * W formacie spakowanym wierzchołki zapisywane są jako PackedVertex, a indeksy jako
+     * 16-bitowe, jeśli liczba wierzchołków na to pozwala.
+     *
+     * @param path Ścieżka do pliku wyjściowego.
+     * @param mesh Dane siatki.
+     * @param vertexFormat Format wierzchołków w pliku.
+     * @return true, jeśli zapis się powiódł.
+     */
+    static bool write(const std::string& path, const MeshData& mesh, uint32_t vertexFormat = MESH_VERTEX_FORMAT_PACKED);
+
+private:
+    MappedFile file;
+    const unsigned char* data = nullptr;
+};
+
+#endif // MESHFILE_H
@@ -0,0 +1,82 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MeshFile.h"
+
+/**
+ * @brief Rozmiar symulowanej pamięci podręcznej wierzchołków po transformacji (FIFO).
+ */
+constexpr size_t VERTEX_CACHE_SIZE = 16;
+
+/**
+ * @struct MeshOptimizationStats
+ * @brief Wynik optymalizacji siatki - raportowany przez konwerter.
+ */
+struct MeshOptimizationStats {
+    size_t verticesBefore = 0;  /**< Liczba wierzchołków przed optymalizacją. */
+    size_t verticesAfter = 0;   /**< Liczba wierzchołków po scaleniu i usunięciu nieużywanych. */
+    float acmrBefore = 0.0f;    /**< Średnia liczba chybień pamięci podręcznej na trójkąt przed optymalizacją. */
+    float acmrAfter = 0.0f;     /**< Średnia liczba chybień pamięci podręcznej na trójkąt po optymalizacji. */
+};
+
+/**
+ * @class MeshOptimizer
+ * @brief Optymalizacja zaimportowanej siatki pod kątem pamięci podręcznej wierzchołków i lokalności odczytu.
+ *
+ * Etapy (wykonywane na CPU podczas importu):
+ * 1. scalanie wierzchołków o identycznych danych,
+ * 2. zmiana kolejności trójkątów algorytmem Tipsify (Sander i in. 2007) - osobno w każdej
+ *    podsiatce, więc zakresy indeksów podsiatek pozostają bez zmian,
+ * 3. zmiana kolejności wierzchołków według pierwszego użycia, tak aby kolejne trójkąty
+ *    odczytywały sąsiednie wierzchołki z bufora.
+ *
+ * Skuteczność mierzona jest współczynnikiem ACMR dla kolejki FIFO o rozmiarze VERTEX_CACHE_SIZE.
+ */
+class MeshOptimizer {
+public:
+    /**
+     * @brief Wykonuje wszystkie etapy optymalizacji.
+     *
+     * @param mesh Siatka modyfikowana w miejscu.
+     * @return Statystyki przed i po optymalizacji.
+     */
+    static MeshOptimizationStats optimize(MeshData& mesh);
+
+    /**
+     * @brief Scala wierzchołki o identycznych danych i przepisuje indeksy.
+     *
+     * @param mesh Siatka modyfikowana w miejscu.
+     */
+    static void deduplicateVertices(MeshData& mesh);
+
+    /**
+     * @brief Zmienia kolejność trójkątów w każdej podsiatce algorytmem Tipsify.
+     *
+     * @param mesh Siatka modyfikowana w miejscu.
+     * @param cacheSize Docelowy rozmiar pamięci podręcznej wierzchołków.
+     */
+    static void optimizeVertexCache(MeshData& mesh, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+    /**
+     * @brief Układa wierzchołki w kolejności pierwszego użycia i usuwa nieużywane.
+     *
+     * @param mesh Siatka modyfikowana w miejscu.
+     */
+    static void optimizeVertexFetch(MeshData& mesh);
+
+    /**
+     * @brief Oblicza ACMR (average cache miss ratio) dla pamięci podręcznej FIFO.
+     *
+     * @param indices Indeksy trójkątów.
+     * @param vertexCount Liczba wierzchołków siatki.
+     * @param cacheSize Rozmiar pamięci podręcznej.
+     * @return Średnia liczba przetworzonych wierzchołków na trójkąt (od 0.5 do 3).
+     */
+    static float computeAcmr(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE);
+};
+
+#endif // MESHOPTIMIZER_H
@@ -0,0 +1,34 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "MeshFile.h"
+
+/**
+ * @class MeshSimplifier
+ * @brief Generowanie łańcucha poziomów szczegółowości (LOD) metryką błędu kwadrykowego (Garland-Heckbert).
+ *
+ * Upraszczanie wykonuje zwijanie półkrawędzi: wierzchołek przesuwany jest na pozycję sąsiada,
+ * więc wszystkie poziomy współdzielą bufor wierzchołków, a kolejne poziomy to tylko nowe zakresy
+ * indeksów. Krawędzie brzegowe, szwy atrybutów (ta sama pozycja z innym UV lub normalną) oraz
+ * granice między podsiatkami są blokowane, a zwinięcia odwracające trójkąty odrzucane.
+ *
+ * Błąd poziomu to pierwiastek największego kosztu zwinięcia - przybliżona odległość od
+ * pełnej siatki w jednostkach modelu, z której Model wylicza błąd w pikselach.
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief Dopisuje do siatki kolejne poziomy szczegółowości.
+     *
+     * Poziom 0 to dotychczasowe podsiatki. Każdy następny ma docelowo `reduction` razy mniej
+     * trójkątów od poprzedniego; generowanie kończy się wcześniej, gdy siatki nie da się
+     * już istotnie uprościć.
+     *
+     * @param mesh Siatka bez poziomów szczegółowości, modyfikowana w miejscu.
+     * @param maxLods Największa liczba poziomów (łącznie z poziomem 0).
+     * @param reduction Stosunek liczby trójkątów kolejnych poziomów.
+     */
+    static void generateLods(MeshData& mesh, uint32_t maxLods = MAX_MESH_LODS, float reduction = 0.5f);
+};
+
+#endif // MESHSIMPLIFIER_H
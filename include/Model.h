@@ -0,0 +1,100 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <string>
+#include <vector>
+
+#include "DrawableObject.h"
+#include "BoundingBox.h"
+#include "MeshFile.h"
+#include "VertexFormat.h"
+
+/**
+ * @class Model
+ * @brief Siatka wczytana z binarnego pliku siatki (MeshFile) i narysowana z macierzą modelu.
+ *
+ * Plik jest mapowany do pamięci, a jego sekcje wierzchołków i indeksów przekazywane wprost do
+ * `glBufferData` - bez parsowania i kopiowania po stronie CPU. Po przesłaniu mapowanie jest
+ * zwalniane; w pamięci zostają tylko zakresy podsiatek. Pliki w formacie spakowanym
+ * (MESH_VERTEX_FORMAT_PACKED) używają tego samego układu atrybutów co reszta sceny (VertexFormat).
+ *
+ * Jeśli plik zawiera kilka poziomów szczegółowości, selectLod() wybiera co klatkę najprostszy
+ * poziom, którego błąd geometryczny po rzutowaniu na ekran nie przekracza zadanej liczby pikseli.
+ */
+class Model : public DrawableObject {
+public:
+    /**
+     * @brief Konstruktor pustego modelu (bez buforów).
+     *
+     * @param texture Tekstura używana przez wszystkie podsiatki.
+     */
+    explicit Model(GLuint texture);
+
+    /**
+     * @brief Destruktor zwalniający bufory OpenGL.
+     */
+    ~Model();
+
+    /**
+     * @brief Wczytuje plik siatki i przesyła go do GPU.
+     *
+     * @param path Ścieżka do pliku `.mesh`.
+     * @return true, jeśli plik został wczytany.
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Rysuje wszystkie podsiatki modelu.
+     *
+     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param model Macierz modelu.
+     * @param view Macierz widoku.
+     * @param projection Macierz projekcji.
+     */
+    void draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) override;
+
+    /**
+     * @brief Zwraca prostopadłościan otaczający w przestrzeni modelu.
+     */
+    const BoundingBox& getBounds() const;
+
+    /**
+     * @brief Wybiera poziom szczegółowości na podstawie błędu w przestrzeni ekranu.
+     *
+     * @param model Macierz modelu.
+     * @param cameraPosition Pozycja obserwatora.
+     * @param projection Macierz projekcji obserwatora.
+     * @param viewportHeight Wysokość obrazu w pikselach.
+     * @param maxPixelError Największy dopuszczalny błąd w pikselach.
+     */
+    void selectLod(const glm::mat4& model, const glm::vec3& cameraPosition, const glm::mat4& projection, float viewportHeight, float maxPixelError);
+
+    /**
+     * @brief Zwraca indeks bieżącego poziomu szczegółowości (0 = pełna siatka).
+     */
+    size_t getLod() const;
+
+    /**
+     * @brief Zwraca liczbę poziomów szczegółowości.
+     */
+    size_t getLodCount() const;
+
+    /**
+     * @brief Zwraca liczbę trójkątów bieżącego poziomu szczegółowości.
+     */
+    size_t getTriangleCount() const;
+
+private:
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    GLuint texture;
+    GLenum indexType = GL_UNSIGNED_INT;
+    GLsizei indexSize = sizeof(GLuint);
+    BoundingBox bounds;
+    std::vector<MeshSubmesh> submeshes;
+    std::vector<MeshLod> lods;
+    size_t currentLod = 0;
+};
+
+#endif // MODEL_H
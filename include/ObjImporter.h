@@ -0,0 +1,29 @@
+#ifndef OBJIMPORTER_H
+#define OBJIMPORTER_H
+
+#include <string>
+
+#include "MeshFile.h"
+
+/**
+ * @class ObjImporter
+ * @brief Import siatek w formacie Wavefront OBJ (używany przez konwerter offline).
+ *
+ * Obsługuje pozycje, współrzędne tekstur, normalne i ściany o dowolnej liczbie wierzchołków
+ * (dzielone na trójkąty wachlarzem), w tym indeksy ujemne. Każde `usemtl` rozpoczyna nową
+ * podsiatkę. Wierzchołki o tej samej trójce (pozycja, UV, normalna) są scalane, a brakujące
+ * normalne zastępowane normalną ściany.
+ */
+class ObjImporter {
+public:
+    /**
+     * @brief Wczytuje plik OBJ.
+     *
+     * @param path Ścieżka do pliku OBJ.
+     * @param mesh Siatka wynikowa.
+     * @return true, jeśli plik został wczytany i zawiera co najmniej jeden trójkąt.
+     */
+    static bool load(const std::string& path, MeshData& mesh);
+};
+
+#endif // OBJIMPORTER_H
@@ -0,0 +1,157 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct PoolHandle
+ * @brief Uchwyt obiektu z puli - indeks slotu i numer generacji.
+ *
+ * Generacja slotu rośnie przy każdym zwolnieniu, więc uchwyt do zwolnionego obiektu nie wskaże
+ * obiektu utworzonego później w tym samym slocie. Domyślny uchwyt (generacja 0) jest pusty.
+ */
+struct PoolHandle {
+    uint32_t index = 0;         /**< Indeks slotu w puli. */
+    uint32_t generation = 0;    /**< Generacja slotu w chwili utworzenia obiektu. */
+
+    bool operator==(const PoolHandle& other) const = default;
+};
+
+/**
+ * @class ObjectPool
+ * @brief Pula obiektów w blokach o stałym rozmiarze z listą wolnych slotów.
+ *
+ * Pamięć przydzielana jest blokami po BLOCK_SIZE slotów i nie jest zwalniana aż do zniszczenia
+ * puli, więc tworzenie i usuwanie obiektów nie fragmentuje sterty, a adresy obiektów są stałe.
+ * Zwolnione sloty trafiają na stos wolnych slotów - następny obiekt zajmie ostatnio zwolniony,
+ * wciąż ciepły w pamięci podręcznej slot.
+ *
+ * @tparam T Typ obiektów.
+ * @tparam BLOCK_SIZE Liczba slotów w bloku.
+ */
+template <typename T, size_t BLOCK_SIZE = 256>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+
+    /**
+     * @brief Niszczy wszystkie żywe obiekty i zwalnia bloki.
+     */
+    ~ObjectPool() {
+        for (uint32_t index = 0; index < blocks.size() * BLOCK_SIZE; index++) {
+            Slot& slot = slotAt(index);
+            if (slot.alive) {
+                reinterpret_cast<T*>(slot.storage)->~T();
+            }
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Tworzy obiekt w wolnym slocie (dokłada blok, gdy wolnych slotów brak).
+     *
+     * @param args Argumenty konstruktora obiektu.
+     * @return Uchwyt obiektu.
+     */
+    template <typename... Args>
+    PoolHandle create(Args&&... args) {
+        if (freeSlots.empty()) {
+            grow();
+        }
+        uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+
+        Slot& slot = slotAt(index);
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.alive = true;
+        liveCount++;
+        return { index, slot.generation };
+    }
+
+    /**
+     * @brief Niszczy obiekt i zwraca jego slot do puli.
+     *
+     * @return false, jeśli uchwyt jest nieaktualny.
+     */
+    bool destroy(PoolHandle handle) {
+        T* object = get(handle);
+        if (!object) {
+            return false;
+        }
+        object->~T();
+
+        Slot& slot = slotAt(handle.index);
+        slot.alive = false;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        liveCount--;
+        return true;
+    }
+
+    /**
+     * @brief Zwraca obiekt wskazywany przez uchwyt.
+     *
+     * @return Wskaźnik do obiektu albo nullptr, jeśli obiekt został już zwolniony.
+     */
+    T* get(PoolHandle handle) {
+        if (handle.index >= blocks.size() * BLOCK_SIZE) {
+            return nullptr;
+        }
+        Slot& slot = slotAt(handle.index);
+        if (!slot.alive || slot.generation != handle.generation) {
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(slot.storage);
+    }
+
+    /**
+     * @brief Zwraca liczbę żywych obiektów.
+     */
+    size_t getLiveCount() const {
+        return liveCount;
+    }
+
+    /**
+     * @brief Zwraca liczbę slotów we wszystkich blokach.
+     */
+    size_t getCapacity() const {
+        return blocks.size() * BLOCK_SIZE;
+    }
+
+private:
+    /**
+     * @struct Slot
+     * @brief Miejsce na jeden obiekt wraz z generacją.
+     */
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];    /**< Pamięć obiektu. */
+        uint32_t generation = 1;                        /**< Bieżąca generacja slotu. */
+        bool alive = false;                             /**< Czy slot zawiera obiekt. */
+    };
+
+    void grow() {
+        uint32_t first = static_cast<uint32_t>(blocks.size() * BLOCK_SIZE);
+        blocks.push_back(std::make_unique<Slot[]>(BLOCK_SIZE));
+        // Odwrotna kolejka, żeby sloty wydawane były od najniższego indeksu
+        for (uint32_t i = BLOCK_SIZE; i > 0; i--) {
+            freeSlots.push_back(first + i - 1);
+        }
+    }
+
+    Slot& slotAt(uint32_t index) {
+        return blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    std::vector<uint32_t> freeSlots;
+    size_t liveCount = 0;
+};
+
+#endif // OBJECTPOOL_H
@@ -4,24 +4,31 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "TransformableObject.h"
+#include "World.h"
+#include "Components.h"
+#include "Ray.h"
+
+class SpatialHash;
 
 /**
  * @class Observer
  * @brief Klasa reprezentująca obserwatora (kamerę) w przestrzeni 3D.
  *
  * Klasa ta dziedziczy po TransformableObject, co umożliwia jej translację i rotację w przestrzeni 3D.
- * Implementuje mechanizmy pozwalające na ruch kamery oraz zmianę kierunku patrzenia.
+ * Implementuje mechanizmy pozwalające na ruch kamery oraz zmianę kierunku patrzenia. Sam stan
+ * kamery (pozycja, kąty, parametry projekcji) jest komponentem Camera encji w świecie (World).
  */
 class Observer : public TransformableObject {
 public:
     /**
-     * @brief Konstruktor tworzący obserwatora w określonej pozycji i z określonym kierunkiem patrzenia.
+     * @brief Konstruktor tworzący encję obserwatora w określonej pozycji i z określonym kierunkiem patrzenia.
      *
+     * @param world Świat, w którym tworzona jest encja kamery.
      * @param position Początkowa pozycja obserwatora.
      * @param target Punkt, na który patrzy obserwator.
      * @param up Wektor określający górę (zwykle {0, 1, 0}).
      */
-    Observer(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up);
+    Observer(World& world, const glm::vec3& position, const glm::vec3& target, const glm::vec3& up);
 
     /**
      * @brief Zwraca macierz widoku obliczoną na podstawie pozycji i kierunku patrzenia.
@@ -30,6 +37,20 @@ public:
      */
     glm::mat4 getViewMatrix() const;
 
+    /**
+     * @brief Zwraca promień przechodzący przez punkt okna (np. pozycję kursora myszy).
+     *
+     * Punkt jest odrzutowywany przez odwrotność macierzy widoku i projekcji na bliską i daleką
+     * płaszczyznę obcinania; promień zaczyna się na bliskiej płaszczyźnie.
+     *
+     * @param x Współrzędna X w pikselach okna (od lewej).
+     * @param y Współrzędna Y w pikselach okna (od góry, jak w GLUT).
+     * @param width Szerokość okna.
+     * @param height Wysokość okna.
+     * @return Promień w przestrzeni świata.
+     */
+    Ray getPickRay(int x, int y, int width, int height) const;
+
     /**
      * @brief Przesuwa obserwatora wzdłuż podanego wektora kierunku.
      *
@@ -101,6 +122,24 @@ public:
      */
     void moveRight(float distance);
 
+    /**
+     * @brief Przesuwa obserwatora w górę (wzdłuż osi Y świata) o określoną odległość.
+     *
+     * @param distance Odległość przesunięcia.
+     */
+    void moveUp(float distance);
+
+    /**
+     * @brief Włącza kolizje kamery z geometrią poziomu.
+     *
+     * Ruch przez moveForward(), moveRight() i moveUp() jest wtedy przesunięciem sfery z poślizgiem
+     * po zderzaczach siatki; translate() nadal przesuwa kamerę bez kolizji.
+     *
+     * @param spatialHash Siatka zderzaczy (nullptr wyłącza kolizje).
+     * @param radius Promień sfery otaczającej kamerę.
+     */
+    void setCollision(SpatialHash* spatialHash, float radius);
+
     /**
      * @brief Pobiera aktualny kąt nachylenia (pitch) obserwatora.
      *
@@ -129,6 +168,35 @@ public:
      */
     void setYaw(float newYaw);
 
+    /**
+     * @brief Zwraca macierz projekcji perspektywicznej obserwatora.
+     *
+     * @param aspect Stosunek szerokości do wysokości obrazu.
+     * @return Macierz projekcji.
+     */
+    glm::mat4 getProjectionMatrix(float aspect) const;
+
+    /**
+     * @brief Pobiera pionowy kąt widzenia.
+     *
+     * @return Kąt widzenia w stopniach.
+     */
+    float getFov() const;
+
+    /**
+     * @brief Pobiera odległość bliskiej płaszczyzny obcinania.
+     *
+     * @return Odległość bliskiej płaszczyzny.
+     */
+    float getNearPlane() const;
+
+    /**
+     * @brief Pobiera odległość dalekiej płaszczyzny obcinania.
+     *
+     * @return Odległość dalekiej płaszczyzny.
+     */
+    float getFarPlane() const;
+
     /**
      * @brief Aktualizuje wektor celu na podstawie wartości pitch i yaw.
      *
@@ -137,31 +205,41 @@ public:
      */
     void updateTarget();
 
+    /**
+     * @brief Zwraca encję przechowującą stan kamery.
+     */
+    Entity getEntity() const;
+
 private:
     /**
-     * @brief Aktualna pozycja obserwatora w przestrzeni 3D.
+     * @brief Zwraca komponent kamery obserwatora.
+     */
+    Camera& camera() const;
+
+    /**
+     * @brief Przesuwa kamerę z uwzględnieniem kolizji, jeśli są włączone.
      */
-    glm::vec3 position;
+    void move(const glm::vec3& displacement);
 
     /**
-     * @brief Aktualny punkt, na który patrzy obserwator.
+     * @brief Świat, w którym żyje encja kamery.
      */
-    glm::vec3 target;
+    World& world;
 
     /**
-     * @brief Wektor określający górę (up direction).
+     * @brief Encja z komponentem Camera.
      */
-    glm::vec3 up;
+    Entity entity;
 
     /**
-     * @brief Kąt nachylenia (pitch) obserwatora w stopniach.
+     * @brief Siatka zderzaczy, z którymi koliduje kamera.
      */
-    float pitch;
+    SpatialHash* collision = nullptr;
 
     /**
-     * @brief Kąt obrotu (yaw) obserwatora w stopniach.
+     * @brief Promień sfery otaczającej kamerę.
      */
-    float yaw;
+    float collisionRadius = 0.0f;
 };
 
 #endif // OBSERVER_H
@@ -0,0 +1,97 @@
+#ifndef OMNISHADOWMAP_H
+#define OMNISHADOWMAP_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+
+#include "BoundingBox.h"
+
+/**
+ * @class OmniShadowMap
+ * @brief Dookólne mapy cieni świateł punktowych przechowywane w `GL_TEXTURE_CUBE_MAP_ARRAY`.
+ *
+ * Każde światło zajmuje sześć kolejnych warstw (ściany sześcianu). Bufor ramki ma podpiętą
+ * całą tablicę jako warstwowy załącznik głębokości, więc geometry shader może wybrać ścianę
+ * przez `gl_Layer` i wszystkie sześć ścian renderowanych jest w jednym przejściu po scenie.
+ * Głębokość zapisywana jest liniowo jako odległość od światła podzielona przez zasięg.
+ */
+class OmniShadowMap {
+public:
+    /**
+     * @brief Liczba ścian mapy sześciennej.
+     */
+    static const int FACE_COUNT = 6;
+
+    /**
+     * @brief Konstruktor tworzący tablicę map sześciennych i warstwowy bufor ramki.
+     *
+     * @param resolution Rozdzielczość jednej ściany w tekselach.
+     * @param lightCount Liczba świateł, dla których rezerwowane są warstwy.
+     */
+    OmniShadowMap(int resolution, int lightCount);
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~OmniShadowMap();
+
+    /**
+     * @brief Podpina bufor ramki z całą tablicą jako celem renderowania i ustawia viewport.
+     */
+    void bindForWriting() const;
+
+    /**
+     * @brief Pobiera identyfikator tekstury `GL_TEXTURE_CUBE_MAP_ARRAY`.
+     *
+     * @return Identyfikator tekstury.
+     */
+    GLuint getTexture() const;
+
+    /**
+     * @brief Pobiera rozdzielczość jednej ściany.
+     *
+     * @return Rozdzielczość w tekselach.
+     */
+    int getResolution() const;
+
+    /**
+     * @brief Pobiera liczbę świateł, dla których zarezerwowano warstwy.
+     *
+     * @return Liczba świateł.
+     */
+    int getLightCount() const;
+
+    /**
+     * @brief Wyznacza macierze (rzut * widok) sześciu ścian dla światła punktowego.
+     *
+     * Kolejność i wektory "up" odpowiadają konwencji ścian `GL_TEXTURE_CUBE_MAP_POSITIVE_X` ...
+     *
+     * @param position Pozycja światła.
+     * @param farPlane Zasięg mapy cieni.
+     * @param matrices Tablica wyjściowa sześciu macierzy.
+     */
+    static void computeFaceMatrices(const glm::vec3& position, float farPlane, glm::mat4 matrices[FACE_COUNT]);
+
+    /**
+     * @brief Wyznacza maskę ścian, w których frustum może znaleźć się obiekt.
+     *
+     * Sfera opisana na obiekcie testowana jest z czterema bocznymi płaszczyznami ostrosłupa
+     * każdej ściany (kąt 90°) oraz z zasięgiem światła.
+     *
+     * @param bounds Prostopadłościan otaczający obiekt.
+     * @param position Pozycja światła.
+     * @param farPlane Zasięg mapy cieni.
+     * @return Maska bitowa ścian (bit i = ściana i), 0 gdy obiekt nie rzuca cienia.
+     */
+    static int computeFaceMask(const BoundingBox& bounds, const glm::vec3& position, float farPlane);
+
+private:
+    GLuint fbo = 0;
+    GLuint cubeArray = 0;
+    int resolution;
+    int lightCount;
+};
+
+#endif // OMNISHADOWMAP_H
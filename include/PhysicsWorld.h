@@ -0,0 +1,268 @@
+#ifndef PHYSICSWORLD_H
+#define PHYSICSWORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class JobSystem;
+
+/**
+ * @class PhysicsWorld
+ * @brief Symulacja brył sztywnych w kształcie prostopadłościanów.
+ *
+ * Krok symulacji składa się z trzech faz:
+ * - faza szeroka: przeczesywanie (sweep and prune) posortowanych przedziałów AABB wzdłuż osi
+ *   o największej wariancji środków - tablica sortowana jest przez wstawianie, bo między
+ *   krokami kolejność prawie się nie zmienia,
+ * - faza wąska: test osi rozdzielających (SAT) pudło-pudło z obcinaniem ściany incydentnej
+ *   oraz kontakty pudło-płaszczyzna; pary liczone są równolegle na JobSystem,
+ * - solver: impulsy sekwencyjne z tarciem i ciepłym startem, rozwiązywane osobno dla każdej
+ *   wyspy (grupy stykających się ciał), więc wyspy liczone są równolegle.
+ *
+ * Wyspa, której wszystkie ciała są prawie nieruchome przez TIME_TO_SLEEP sekund, zasypia -
+ * uśpione ciała nie są całkowane, a pary uśpionych ciał pomijane. Ciało budzi się, gdy
+ * dotknie go ciało aktywne.
+ *
+ * Ciała o masie 0 są statyczne (np. ściany). Uchwyty ciał są stałe do czasu usunięcia ciała.
+ */
+class PhysicsWorld {
+public:
+    /**
+     * @brief Uchwyt ciała.
+     */
+    using Body = uint32_t;
+
+    /**
+     * @brief Konstruktor tworzący pusty świat.
+     *
+     * @param gravity Przyspieszenie grawitacyjne.
+     */
+    explicit PhysicsWorld(const glm::vec3& gravity = glm::vec3(0.0f, -9.81f, 0.0f));
+
+    /**
+     * @brief Dodaje prostopadłościan.
+     *
+     * @param position Środek pudła.
+     * @param orientation Orientacja pudła.
+     * @param halfExtents Połowy długości krawędzi.
+     * @param mass Masa; 0 oznacza ciało statyczne.
+     * @return Uchwyt ciała.
+     */
+    Body addBox(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& halfExtents, float mass);
+
+    /**
+     * @brief Usuwa ciało i budzi ciała, które go dotykały.
+     */
+    void removeBody(Body body);
+
+    /**
+     * @brief Dodaje statyczną, nieskończoną płaszczyznę dot(normal, x) = offset.
+     *
+     * Półprzestrzeń za płaszczyzną (przeciwnie do normalnej) jest pełna.
+     */
+    void addPlane(const glm::vec3& normal, float offset);
+
+    /**
+     * @brief Ustawia prędkość ciała i je budzi.
+     *
+     * @param body Ciało dynamiczne.
+     * @param linear Prędkość liniowa.
+     * @param angular Prędkość kątowa (rad/s).
+     */
+    void setVelocity(Body body, const glm::vec3& linear, const glm::vec3& angular = glm::vec3(0.0f));
+
+    /**
+     * @brief Wykonuje krok symulacji.
+     *
+     * @param dt Krok czasu w sekundach.
+     * @param jobs System zadań dla fazy wąskiej i solvera (opcjonalny).
+     */
+    void step(float dt, JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Zwraca pozycję środka ciała.
+     */
+    glm::vec3 getPosition(Body body) const;
+
+    /**
+     * @brief Zwraca orientację ciała.
+     */
+    glm::quat getOrientation(Body body) const;
+
+    /**
+     * @brief Sprawdza, czy ciało jest aktywne (nie śpi i nie jest statyczne).
+     */
+    bool isAwake(Body body) const;
+
+    /**
+     * @brief Zwraca liczbę ciał.
+     */
+    size_t getBodyCount() const;
+
+    /**
+     * @brief Zwraca liczbę aktywnych ciał po ostatnim kroku.
+     */
+    size_t getAwakeCount() const;
+
+    /**
+     * @brief Zwraca liczbę par z fazy szerokiej w ostatnim kroku.
+     */
+    size_t getPairCount() const;
+
+    /**
+     * @brief Zwraca liczbę punktów kontaktu w ostatnim kroku.
+     */
+    size_t getContactCount() const;
+
+    /**
+     * @brief Zwraca liczbę wysp rozwiązanych w ostatnim kroku.
+     */
+    size_t getIslandCount() const;
+
+    /**
+     * @brief Maksymalna liczba punktów kontaktu jednej pary.
+     */
+    static constexpr int MAX_CONTACTS = 4;
+
+private:
+    /**
+     * @struct RigidBody
+     * @brief Stan ciała sztywnego.
+     */
+    struct RigidBody {
+        glm::vec3 position;             /**< Środek masy. */
+        glm::quat orientation;          /**< Orientacja. */
+        glm::vec3 linearVelocity;       /**< Prędkość liniowa. */
+        glm::vec3 angularVelocity;      /**< Prędkość kątowa. */
+        glm::vec3 halfExtents;          /**< Połowy długości krawędzi. */
+        glm::mat3 rotation;             /**< Macierz orientacji (kolumny to osie pudła). */
+        glm::mat3 inverseInertiaWorld;  /**< Odwrotny tensor bezwładności w przestrzeni świata. */
+        glm::vec3 inverseInertia;       /**< Odwrotne momenty bezwładności w osiach pudła. */
+        glm::vec3 boundsMin;            /**< Minimum AABB. */
+        glm::vec3 boundsMax;            /**< Maksimum AABB. */
+        float inverseMass;              /**< Odwrotność masy (0 dla ciał statycznych). */
+        float sleepTime;                /**< Czas spędzony poniżej progów prędkości. */
+        bool awake;                     /**< Czy ciało jest symulowane. */
+        bool alive;                     /**< Czy uchwyt jest zajęty. */
+    };
+
+    /**
+     * @struct Plane
+     * @brief Statyczna płaszczyzna.
+     */
+    struct Plane {
+        glm::vec3 normal;    /**< Normalna skierowana na zewnątrz bryły. */
+        float offset;        /**< Odległość od początku układu wzdłuż normalnej. */
+    };
+
+    /**
+     * @struct Pair
+     * @brief Para z fazy szerokiej; `b` jest indeksem płaszczyzny, gdy `plane` jest ustawione.
+     */
+    struct Pair {
+        uint64_t key;        /**< Klucz pary - porządek sortowania i wyszukiwania kontaktów. */
+        Body a;              /**< Pierwsze ciało (mniejszy uchwyt). */
+        uint32_t b;          /**< Drugie ciało albo płaszczyzna. */
+        bool plane;          /**< Czy druga strona jest płaszczyzną. */
+    };
+
+    /**
+     * @struct Contact
+     * @brief Punkt kontaktu ze skumulowanymi impulsami (przenoszonymi między krokami).
+     */
+    struct Contact {
+        glm::vec3 position;      /**< Punkt kontaktu w przestrzeni świata. */
+        glm::vec3 localA;        /**< Punkt kontaktu w układzie ciała A (do dopasowania między krokami). */
+        float penetration;       /**< Głębokość przenikania (ujemna przy separacji w marginesie). */
+        float normalImpulse;     /**< Skumulowany impuls normalny. */
+        float tangentImpulse[2]; /**< Skumulowane impulsy tarcia. */
+    };
+
+    /**
+     * @struct Manifold
+     * @brief Kontakty jednej pary; normalna wskazuje od A do B.
+     */
+    struct Manifold {
+        uint64_t key;                        /**< Klucz pary (do ciepłego startu). */
+        Body a;                              /**< Ciało A. */
+        Body b;                              /**< Ciało B (nieużywane dla płaszczyzny). */
+        bool plane;                          /**< Czy B jest płaszczyzną. */
+        int contactCount;                    /**< Liczba kontaktów. */
+        glm::vec3 normal;                    /**< Normalna kontaktu. */
+        glm::vec3 tangents[2];               /**< Kierunki tarcia. */
+        Contact contacts[MAX_CONTACTS];      /**< Punkty kontaktu. */
+    };
+
+    /**
+     * @struct Proxy
+     * @brief AABB ciała w tablicy fazy szerokiej, posortowanej po początku przedziału na osi przeczesywania.
+     */
+    struct Proxy {
+        glm::vec3 min;       /**< Minimum AABB. */
+        glm::vec3 max;       /**< Maksimum AABB. */
+        Body body;           /**< Ciało. */
+        bool awake;          /**< Czy ciało jest aktywne. */
+    };
+
+    /**
+     * @brief Przelicza macierz orientacji, bezwładność w świecie i AABB ciała.
+     */
+    static void updateDerived(RigidBody& body);
+
+    /**
+     * @brief Usuwa z pamięci kontaktów pary usuniętych ciał i budzi ich sąsiadów.
+     */
+    void flushRemovals();
+
+    /**
+     * @brief Faza szeroka - wypełnia `pairs` posortowanymi parami nakładających się AABB.
+     */
+    void findPairs(JobSystem* jobs);
+
+    /**
+     * @brief Faza wąska dla jednej pary, z ciepłym startem z kontaktów poprzedniego kroku.
+     */
+    void collide(const Pair& pair, Manifold& manifold) const;
+
+    /**
+     * @brief Łączy ciała w wyspy i wypełnia tablice wysp.
+     */
+    void buildIslands();
+
+    /**
+     * @brief Rozwiązuje kontakty i całkuje ruch ciał jednej wyspy.
+     */
+    void solveIsland(size_t island, float dt);
+
+    glm::vec3 gravity;
+    std::vector<RigidBody> bodies;
+    std::vector<Body> freeBodies;
+    std::vector<Body> removedBodies;
+    std::vector<Plane> planes;
+
+    std::vector<Proxy> proxies;
+    std::vector<Proxy> awakeProxies;
+    std::vector<Proxy> restingProxies;
+    int sweepAxis = 0;
+    bool proxiesDirty = true;
+
+    std::vector<Pair> pairs;
+    std::vector<Manifold> manifolds;
+    std::vector<Manifold> previousManifolds;
+
+    std::vector<uint32_t> islandParent;
+    std::vector<uint32_t> islandBodyStart;
+    std::vector<Body> islandBodies;
+    std::vector<uint32_t> islandManifoldStart;
+    std::vector<uint32_t> islandManifolds;
+    std::vector<uint32_t> solverIndex;
+
+    size_t awakeCount = 0;
+    size_t contactCount = 0;
+};
+
+#endif // PHYSICSWORLD_H
@@ -0,0 +1,145 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <iostream>
+
+/**
+ * @class Profiler
+ * @brief Klasa mierząca czasy przebiegów renderowania na GPU oraz czas klatki na CPU.
+ *
+ * Czasy GPU mierzone są zapytaniami `GL_TIMESTAMP`, które odczytywane są z opóźnieniem
+ * kilku klatek, dzięki czemu pomiar nie blokuje potoku renderowania. Wyniki są
+ * uśredniane i okresowo wypisywane na konsolę razem z licznikami ustawionymi przez silnik.
+ */
+class Profiler {
+public:
+    /**
+     * @brief Konstruktor profilera.
+     *
+     * @param reportInterval Odstęp (w sekundach) pomiędzy kolejnymi raportami na konsoli.
+     */
+    Profiler(double reportInterval = 1.0);
+
+    /**
+     * @brief Destruktor zwalniający obiekty zapytań OpenGL.
+     */
+    ~Profiler();
+
+    /**
+     * @brief Rozpoczyna pomiar klatki.
+     *
+     * Odczytuje gotowe wyniki sprzed `FRAME_LATENCY` klatek i rozpoczyna nowy pomiar.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Kończy pomiar klatki i w razie potrzeby wypisuje raport.
+     */
+    void endFrame();
+
+    /**
+     * @brief Rozpoczyna pomiar nazwanego przebiegu renderowania.
+     *
+     * Przebiegi mogą być zagnieżdżane.
+     *
+     * @param name Nazwa przebiegu.
+     */
+    void beginPass(const std::string& name);
+
+    /**
+     * @brief Kończy pomiar ostatnio rozpoczętego przebiegu.
+     */
+    void endPass();
+
+    /**
+     * @brief Ustawia wartość licznika wypisywanego w raporcie.
+     *
+     * @param name Nazwa licznika.
+     * @param value Wartość licznika.
+     */
+    void setCounter(const std::string& name, double value);
+
+    /**
+     * @brief Zwraca ostatni zmierzony czas przebiegu na GPU.
+     *
+     * @param name Nazwa przebiegu.
+     * @return Czas w milisekundach lub 0, jeśli przebieg nie był jeszcze zmierzony.
+     */
+    double getPassTime(const std::string& name) const;
+
+    /**
+     * @brief Zwraca ostatni zmierzony czas całej klatki na GPU.
+     *
+     * @return Czas w milisekundach.
+     */
+    double getGpuFrameTime() const;
+
+private:
+    /**
+     * @brief Liczba klatek, o którą opóźniony jest odczyt zapytań.
+     */
+    static const int FRAME_LATENCY = 3;
+
+    /**
+     * @struct PassQuery
+     * @brief Para zapytań mierzących początek i koniec przebiegu.
+     */
+    struct PassQuery {
+        std::string name;   /**< Nazwa przebiegu. */
+        GLuint startQuery;  /**< Zapytanie znacznika czasu na początku przebiegu. */
+        GLuint endQuery;    /**< Zapytanie znacznika czasu na końcu przebiegu. */
+    };
+
+    /**
+     * @struct FrameQueries
+     * @brief Zapytania należące do jednej klatki w pierścieniu.
+     */
+    struct FrameQueries {
+        std::vector<PassQuery> passes; /**< Pula zapytań przebiegów (ponownie używana). */
+        size_t usedPasses = 0;         /**< Liczba przebiegów zarejestrowanych w klatce. */
+        GLuint frameStart = 0;         /**< Znacznik czasu początku klatki. */
+        GLuint frameEnd = 0;           /**< Znacznik czasu końca klatki. */
+        bool pending = false;          /**< Czy klatka czeka na odczyt wyników. */
+    };
+
+    /**
+     * @struct Stat
+     * @brief Zgromadzone statystyki jednego przebiegu.
+     */
+    struct Stat {
+        double last = 0.0;   /**< Ostatni zmierzony czas (ms). */
+        double total = 0.0;  /**< Suma czasów od ostatniego raportu (ms). */
+        int samples = 0;     /**< Liczba pomiarów od ostatniego raportu. */
+    };
+
+    /**
+     * @brief Odczytuje wyniki zapytań z podanej klatki, jeśli są dostępne.
+     *
+     * @param frame Klatka do odczytu.
+     */
+    void resolve(FrameQueries& frame);
+
+    /**
+     * @brief Wypisuje raport na konsolę i zeruje statystyki okresowe.
+     */
+    void report();
+
+    FrameQueries frames[FRAME_LATENCY];
+    std::vector<size_t> openPasses;
+    std::map<std::string, Stat> stats;
+    std::map<std::string, double> counters;
+    Stat gpuFrame;
+    Stat cpuFrame;
+    int frameIndex = 0;
+    int droppedFrames = 0;
+    double reportInterval;
+    std::chrono::steady_clock::time_point frameStartTime;
+    std::chrono::steady_clock::time_point lastReportTime;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,22 @@
+#ifndef RAY_H
+#define RAY_H
+
+#include <glm/glm.hpp>
+
+/**
+ * @struct Ray
+ * @brief Półprosta w przestrzeni świata.
+ */
+struct Ray {
+    glm::vec3 origin;        /**< Początek promienia. */
+    glm::vec3 direction;     /**< Znormalizowany kierunek. */
+
+    /**
+     * @brief Zwraca punkt promienia w podanej odległości od początku.
+     */
+    glm::vec3 at(float distance) const {
+        return origin + direction * distance;
+    }
+};
+
+#endif // RAY_H
@@ -0,0 +1,181 @@
+#ifndef SCENEFILE_H
+#define SCENEFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/**
+ * @brief Sygnatura pliku sceny ("E3DS").
+ */
+constexpr char SCENE_FILE_MAGIC[4] = { 'E', '3', 'D', 'S' };
+
+/**
+ * @brief Bieżąca wersja formatu sceny.
+ */
+constexpr uint32_t SCENE_FILE_VERSION = 1;
+
+/**
+ * @brief Wyrównanie sekcji danych w pliku (w bajtach).
+ */
+constexpr uint64_t SCENE_FILE_ALIGNMENT = 16;
+
+/**
+ * @brief Rodzaj obiektu: ściana (prostokąt o półwymiarach x, y).
+ */
+constexpr uint32_t SCENE_OBJECT_WALL = 0;
+
+/**
+ * @brief Rodzaj obiektu: sześcian z symulacją fizyczną (półwymiar x).
+ */
+constexpr uint32_t SCENE_OBJECT_CUBE = 1;
+
+/**
+ * @brief Indeks materiału oznaczający brak materiału.
+ */
+constexpr uint32_t SCENE_NO_MATERIAL = 0xFFFFFFFFu;
+
+/**
+ * @struct SceneCamera
+ * @brief Zapisany stan kamery (odpowiednik komponentu Camera).
+ */
+struct SceneCamera {
+    float position[3];          /**< Pozycja kamery. */
+    float pitch;                /**< Kąt nachylenia w stopniach. */
+    float yaw;                  /**< Kąt obrotu w stopniach. */
+    float fov;                  /**< Pionowy kąt widzenia w stopniach. */
+    float nearPlane;            /**< Odległość bliskiej płaszczyzny obcinania. */
+    float farPlane;             /**< Odległość dalekiej płaszczyzny obcinania. */
+};
+
+/**
+ * @struct SceneFileHeader
+ * @brief Nagłówek binarnego pliku sceny.
+ *
+ * Plik składa się z nagłówka (ze stanem kamery) i trzech sekcji wyrównanych do 16 bajtów:
+ * obiektów, materiałów i świateł. Rekordy mają stały rozmiar i są zapisane w układzie pamięci
+ * maszyny (little-endian), więc po zmapowaniu pliku sekcje są gotowymi tablicami - odczyt
+ * nie parsuje ani nie kopiuje danych, a strony wczytywane są dopiero przy pierwszym dostępie.
+ */
+struct SceneFileHeader {
+    char magic[4];              /**< Sygnatura SCENE_FILE_MAGIC. */
+    uint32_t version;           /**< Wersja formatu. */
+    uint32_t objectCount;       /**< Liczba obiektów. */
+    uint32_t materialCount;     /**< Liczba materiałów. */
+    uint32_t lightCount;        /**< Liczba świateł. */
+    uint32_t reserved;          /**< Wyrównanie nagłówka (zero). */
+    SceneCamera camera;         /**< Stan kamery. */
+    uint64_t objectOffset;      /**< Początek sekcji obiektów. */
+    uint64_t materialOffset;    /**< Początek sekcji materiałów. */
+    uint64_t lightOffset;       /**< Początek sekcji świateł. */
+};
+
+/**
+ * @struct SceneObject
+ * @brief Obiekt sceny - rodzaj, transformacja (pozycja środka, orientacja, półwymiary) i materiał.
+ */
+struct SceneObject {
+    float position[3];          /**< Środek obiektu. */
+    uint32_t kind;              /**< Rodzaj obiektu (SCENE_OBJECT_WALL lub SCENE_OBJECT_CUBE). */
+    float orientation[4];       /**< Orientacja jako kwaternion (x, y, z, w). */
+    float halfExtents[3];       /**< Półwymiary w układzie obiektu. */
+    uint32_t material;          /**< Indeks materiału albo SCENE_NO_MATERIAL. */
+};
+
+/**
+ * @struct SceneMaterial
+ * @brief Materiał - ścieżka tekstury.
+ */
+struct SceneMaterial {
+    char texture[64];           /**< Ścieżka do tekstury (zakończona zerem). */
+};
+
+/**
+ * @struct SceneLight
+ * @brief Punktowe źródło światła.
+ */
+struct SceneLight {
+    float position[3];          /**< Pozycja światła w przestrzeni świata. */
+    float color[3];             /**< Kolor światła. */
+};
+
+/**
+ * @struct SceneData
+ * @brief Scena w pamięci - wejście zapisu do pliku.
+ */
+struct SceneData {
+    std::vector<SceneObject> objects;       /**< Obiekty. */
+    std::vector<SceneMaterial> materials;   /**< Materiały. */
+    std::vector<SceneLight> lights;         /**< Światła. */
+    SceneCamera camera = {};                /**< Stan kamery. */
+};
+
+/**
+ * @class SceneFile
+ * @brief Zapis i odczyt binarnego formatu sceny; odczyt przez mapowanie pliku do pamięci.
+ *
+ * Sprawdzany jest tylko nagłówek i granice sekcji, więc czas otwarcia nie zależy od liczby
+ * obiektów. Indeksy materiałów nie są sprawdzane przy otwarciu - odczytujący porównuje je
+ * z getHeader().materialCount.
+ */
+class SceneFile {
+public:
+    /**
+     * @brief Konstruktor pustego (niezmapowanego) pliku.
+     */
+    SceneFile() = default;
+
+    SceneFile(const SceneFile&) = delete;
+    SceneFile& operator=(const SceneFile&) = delete;
+
+    /**
+     * @brief Mapuje plik sceny i sprawdza jego nagłówek.
+     *
+     * @param path Ścieżka do pliku.
+     * @return true, jeśli plik ma poprawny format i wersję.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Zwalnia mapowanie pliku.
+     */
+    void close();
+
+    /**
+     * @brief Zwraca nagłówek zmapowanego pliku.
+     */
+    const SceneFileHeader& getHeader() const;
+
+    /**
+     * @brief Zwraca wskaźnik na tablicę obiektów.
+     */
+    const SceneObject* getObjects() const;
+
+    /**
+     * @brief Zwraca wskaźnik na tablicę materiałów.
+     */
+    const SceneMaterial* getMaterials() const;
+
+    /**
+     * @brief Zwraca wskaźnik na tablicę świateł.
+     */
+    const SceneLight* getLights() const;
+
+    /**
+     * @brief Zapisuje scenę do pliku binarnego.
+     *
+     * @param path Ścieżka do pliku wyjściowego.
+     * @param scene Dane sceny.
+     * @return true, jeśli zapis się powiódł.
+     */
+    static bool write(const std::string& path, const SceneData& scene);
+
+private:
+    MappedFile file;
+    const unsigned char* data = nullptr;
+};
+
+#endif // SCENEFILE_H
@@ -0,0 +1,159 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class JobSystem;
+
+/**
+ * @class SceneGraph
+ * @brief Hierarchia transformacji przechowywana jako struktura tablic (SoA).
+ *
+ * Każdy węzeł ma transformację lokalną (przesunięcie, obrót jako kwaternion, skala) i macierz
+ * świata 3x4 wyliczaną względem rodzica. Wszystkie składowe leżą w osobnych tablicach float,
+ * a węzły ułożone są poziomami głębokości - rodzic zawsze przed dzieckiem, a węzły jednego
+ * poziomu nie zależą od siebie. Dzięki temu update() przelicza macierze świata czwórkami
+ * węzłów instrukcjami SSE (z wersją skalarną dla pozostałych).
+ *
+ * Zmiana transformacji lokalnej oznacza węzeł jako brudny; przy aktualizacji flaga przechodzi
+ * na potomków, a czwórki bez brudnych węzłów są pomijane. Uchwyty węzłów (Node) są stałe,
+ * choć pozycja węzła w tablicach zmienia się przy przestawianiu hierarchii.
+ */
+class SceneGraph {
+public:
+    /**
+     * @brief Uchwyt węzła.
+     */
+    using Node = uint32_t;
+
+    /**
+     * @brief Niejawny korzeń hierarchii o jednostkowej macierzy świata.
+     */
+    static constexpr Node ROOT = 0;
+
+    /**
+     * @brief Konstruktor tworzący graf z samym korzeniem.
+     */
+    SceneGraph();
+
+    /**
+     * @brief Tworzy węzeł z jednostkową transformacją lokalną.
+     *
+     * @param parent Rodzic nowego węzła.
+     * @return Uchwyt węzła.
+     */
+    Node createNode(Node parent = ROOT);
+
+    /**
+     * @brief Przepina węzeł (wraz z poddrzewem) do innego rodzica.
+     *
+     * @param node Przepinany węzeł.
+     * @param parent Nowy rodzic.
+     * @return false, jeśli rodzic leży w poddrzewie węzła (powstałby cykl).
+     */
+    bool setParent(Node node, Node parent);
+
+    /**
+     * @brief Ustawia przesunięcie węzła względem rodzica.
+     */
+    void setPosition(Node node, const glm::vec3& position);
+
+    /**
+     * @brief Przesuwa węzeł względem rodzica.
+     */
+    void translate(Node node, const glm::vec3& direction);
+
+    /**
+     * @brief Ustawia obrót węzła względem rodzica.
+     *
+     * @param node Węzeł.
+     * @param angle Kąt obrotu w stopniach.
+     * @param axis Oś obrotu.
+     */
+    void setRotation(Node node, float angle, const glm::vec3& axis);
+
+    /**
+     * @brief Dokłada obrót do bieżącego obrotu węzła (w układzie rodzica).
+     *
+     * @param node Węzeł.
+     * @param angle Kąt obrotu w stopniach.
+     * @param axis Oś obrotu.
+     */
+    void rotate(Node node, float angle, const glm::vec3& axis);
+
+    /**
+     * @brief Ustawia skalę węzła.
+     */
+    void setScale(Node node, const glm::vec3& scale);
+
+    /**
+     * @brief Zwraca przesunięcie węzła względem rodzica.
+     */
+    glm::vec3 getPosition(Node node) const;
+
+    /**
+     * @brief Przelicza macierze świata brudnych węzłów i ich potomków.
+     *
+     * @param jobs System zadań, między którego wątki dzielone są duże poziomy (opcjonalny).
+     */
+    void update(JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Zwraca macierz świata węzła z ostatniej aktualizacji.
+     */
+    glm::mat4 getWorldMatrix(Node node) const;
+
+    /**
+     * @brief Zwraca pozycję węzła w przestrzeni świata z ostatniej aktualizacji.
+     */
+    glm::vec3 getWorldPosition(Node node) const;
+
+    /**
+     * @brief Zwraca liczbę węzłów (bez korzenia).
+     */
+    size_t getNodeCount() const;
+
+    /**
+     * @brief Zwraca liczbę węzłów przeliczonych w ostatniej aktualizacji.
+     */
+    size_t getUpdatedCount() const;
+
+private:
+    /**
+     * @brief Ustawia węzły poziomami głębokości i przebudowuje zakresy poziomów.
+     */
+    void rebuildOrder();
+
+    /**
+     * @brief Przelicza macierze świata węzłów [first, first + szerokość typu Lane).
+     */
+    template <typename Lane>
+    void updateLanes(size_t first);
+
+    /**
+     * @brief Propaguje flagi i przelicza brudne węzły z zakresu [first, last) jednego poziomu.
+     *
+     * @return Liczba przeliczonych węzłów.
+     */
+    size_t updateRange(size_t first, size_t last);
+
+    std::vector<uint32_t> parents;          /**< Indeks rodzica (w kolejności tablic). */
+    std::vector<uint32_t> depths;           /**< Głębokość węzła (korzeń = 0). */
+    std::vector<uint8_t> dirty;             /**< Czy transformacja lokalna lub rodzica się zmieniła. */
+    std::vector<float> position[3];         /**< Przesunięcie lokalne (x, y, z). */
+    std::vector<float> rotation[4];         /**< Obrót lokalny jako kwaternion (x, y, z, w). */
+    std::vector<float> scale[3];            /**< Skala lokalna (x, y, z). */
+    std::vector<float> world[12];           /**< Macierz świata 3x4 zapisana kolumnami. */
+    std::vector<uint32_t> handleToIndex;    /**< Pozycja węzła w tablicach dla uchwytu. */
+    std::vector<uint32_t> indexToHandle;    /**< Uchwyt węzła na danej pozycji. */
+    std::vector<size_t> levelStarts;        /**< Początki kolejnych poziomów głębokości. */
+    bool orderDirty = false;
+    bool levelsDirty = false;
+    size_t updatedCount = 0;
+};
+
+#endif // SCENEGRAPH_H
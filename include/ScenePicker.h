@@ -0,0 +1,110 @@
+#ifndef SCENEPICKER_H
+#define SCENEPICKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "AabbTree.h"
+#include "Ray.h"
+#include "World.h"
+
+/**
+ * @class ScenePicker
+ * @brief Wybieranie obiektów sceny promieniem (np. spod kursora myszy).
+ *
+ * Obiekty są prostopadłościanami (OBB) zapisanymi w dynamicznym drzewie AABB (AabbTree), więc
+ * zapytanie odwiedza O(log n) węzłów, a dokładny test promienia z OBB wykonywany jest tylko dla
+ * liści, których AABB leży na drodze promienia bliżej niż dotychczasowe trafienie.
+ */
+class ScenePicker {
+public:
+    /**
+     * @brief Uchwyt obiektu.
+     */
+    using Target = uint32_t;
+
+    /**
+     * @struct Hit
+     * @brief Najbliższe trafienie promienia.
+     */
+    struct Hit {
+        Entity entity;       /**< Trafiona encja. */
+        float distance;      /**< Odległość od początku promienia. */
+        int face;            /**< Ściana pudła: 0 = przód, 1 = tył, 2 = lewa, 3 = prawa, 4 = góra, 5 = dół (jak w Cube::setTextureForSide). */
+        glm::vec3 position;  /**< Punkt trafienia. */
+        glm::vec3 normal;    /**< Normalna trafionej ściany. */
+    };
+
+    /**
+     * @brief Dodaje obiekt w kształcie prostopadłościanu.
+     *
+     * @param entity Encja obiektu.
+     * @param center Środek prostopadłościanu.
+     * @param orientation Orientacja prostopadłościanu.
+     * @param halfExtents Połowy długości krawędzi.
+     * @return Uchwyt obiektu.
+     */
+    Target add(Entity entity, const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents);
+
+    /**
+     * @brief Przenosi obiekt w nowe położenie.
+     */
+    void update(Target target, const glm::vec3& center, const glm::quat& orientation);
+
+    /**
+     * @brief Usuwa obiekt.
+     */
+    void remove(Target target);
+
+    /**
+     * @brief Wyszukuje najbliższy obiekt trafiony promieniem.
+     *
+     * Obiekty, w których leży początek promienia, są pomijane.
+     *
+     * @param ray Promień.
+     * @param maxDistance Zasięg promienia.
+     * @param hit Wynik - wypełniany, gdy zwrócono true.
+     * @return true, jeśli promień trafił obiekt.
+     */
+    bool pick(const Ray& ray, float maxDistance, Hit& hit);
+
+    /**
+     * @brief Zwraca liczbę obiektów.
+     */
+    size_t getTargetCount() const;
+
+    /**
+     * @brief Zwraca liczbę węzłów drzewa odwiedzonych w ostatnim zapytaniu.
+     */
+    size_t getVisitedCount() const;
+
+private:
+    /**
+     * @struct Box
+     * @brief Obiekt - prostopadłościan z liściem w drzewie.
+     */
+    struct Box {
+        glm::vec3 center;            /**< Środek. */
+        glm::mat3 rotation;          /**< Macierz orientacji (kolumny to osie pudła). */
+        glm::vec3 halfExtents;       /**< Połowy długości krawędzi. */
+        AabbTree::Proxy proxy;       /**< Liść w drzewie. */
+        Entity entity;               /**< Encja obiektu. */
+        bool alive;                  /**< Czy uchwyt jest zajęty. */
+    };
+
+    /**
+     * @brief Zwraca AABB prostopadłościanu.
+     */
+    static BoundingBox computeBounds(const Box& box);
+
+    AabbTree tree;
+    std::vector<Box> boxes;
+    std::vector<Target> freeTargets;
+    size_t targetCount = 0;
+};
+
+#endif // SCENEPICKER_H
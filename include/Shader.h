@@ -13,7 +13,7 @@
  *
  * Klasa Shader umożliwia ładowanie, kompilację i używanie programów cieniujących
  * w OpenGL. Obsługuje zarówno podstawowy zestaw (vertex + fragment shader), jak
- * i opcjonalny geometry shader.
+ * i opcjonalny geometry shader oraz samodzielne compute shadery.
  */
 class Shader {
 public:
@@ -34,6 +34,13 @@ public:
      */
     Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath);
 
+    /**
+     * @brief Konstruktor ładujący i kompilujący program obliczeniowy (compute shader).
+     *
+     * @param computePath Ścieżka do pliku z kodem compute shadera.
+     */
+    explicit Shader(const std::string& computePath);
+
     /**
      * @brief Destruktor zwalniający zasoby programu cieniującego.
      */
@@ -72,7 +79,7 @@ private:
      * @brief Kompiluje shader na podstawie kodu źródłowego.
      *
      * @param source Kod źródłowy shadera.
-     * @param type Typ shadera (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER).
+     * @param type Typ shadera (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER, GL_COMPUTE_SHADER).
      * @return Identyfikator skompilowanego shadera lub 0 w przypadku błędu.
      */
     GLuint compileShader(const std::string& source, GLenum type);
@@ -0,0 +1,155 @@
+#ifndef SHADOWATLAS_H
+#define SHADOWATLAS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <iostream>
+
+/**
+ * @class ShadowAtlas
+ * @brief Wspólny atlas głębokości, z którego przydzielane są kafelki map cieni świateł.
+ *
+ * Pamięć map cieni jest stała (jedna tekstura `atlasSize x atlasSize`) niezależnie od liczby
+ * świateł. Co klatkę każde światło zgłasza żądany rozmiar kafelka (potęga dwójki), a pakowacz
+ * układa sześć kafelków na światło (ściany sześcianu) wzdłuż krzywej Mortona, zaczynając od
+ * największych. Dzięki temu każdy kafelek trafia w wyrównany kwadrat, a przydział jest liniowy.
+ * Gdy żądania nie mieszczą się w atlasie, największe kafelki są zmniejszane o połowę.
+ */
+class ShadowAtlas {
+public:
+    /**
+     * @brief Liczba kafelków przydzielanych jednemu światłu (ściany mapy sześciennej).
+     */
+    static const int FACES_PER_OWNER = 6;
+
+    /**
+     * @struct Tile
+     * @brief Prostokąt atlasu przydzielony jednej ścianie mapy cieni.
+     */
+    struct Tile {
+        int owner;  /**< Indeks światła, do którego należy kafelek. */
+        int face;   /**< Indeks ściany mapy sześciennej. */
+        int x;      /**< Położenie X lewego dolnego rogu (teksele). */
+        int y;      /**< Położenie Y lewego dolnego rogu (teksele). */
+        int size;   /**< Bok kafelka (teksele). */
+    };
+
+    /**
+     * @brief Konstruktor tworzący teksturę atlasu i bufor ramki.
+     *
+     * @param atlasSize Bok atlasu w tekselach (potęga dwójki).
+     * @param minTileSize Najmniejszy przydzielany kafelek (potęga dwójki).
+     * @param maxTileSize Największy przydzielany kafelek (potęga dwójki).
+     */
+    ShadowAtlas(int atlasSize, int minTileSize, int maxTileSize);
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~ShadowAtlas();
+
+    /**
+     * @brief Zamienia pokrycie ekranu na żądany rozmiar kafelka.
+     *
+     * @param coverage Część wysokości ekranu zajmowana przez zasięg światła (0 - 1).
+     * @return Rozmiar kafelka zaokrąglony w dół do potęgi dwójki.
+     */
+    int tileSizeForCoverage(float coverage) const;
+
+    /**
+     * @brief Układa kafelki dla wszystkich świateł w bieżącej klatce.
+     *
+     * @param requestedSizes Żądany rozmiar kafelka dla każdego światła.
+     * @return true, jeśli wszystkie światła otrzymały kafelki.
+     */
+    bool pack(const std::vector<int>& requestedSizes);
+
+    /**
+     * @brief Podpina bufor ramki atlasu i czyści głębokość całego atlasu.
+     */
+    void bindForWriting() const;
+
+    /**
+     * @brief Ustawia tablicę viewportów 0 - 5 na kafelki ścian danego światła.
+     *
+     * Geometry shader wybiera ścianę przez `gl_ViewportIndex`.
+     *
+     * @param owner Indeks światła.
+     * @return false, jeśli światło nie otrzymało miejsca w atlasie.
+     */
+    bool setFaceViewports(int owner) const;
+
+    /**
+     * @brief Zwraca kafelek ściany światła w jednostkach tekstury (xy = początek, zw = rozmiar).
+     *
+     * @param owner Indeks światła.
+     * @param face Indeks ściany.
+     * @return Prostokąt w przestrzeni UV lub zerowy wektor, gdy brak kafelka.
+     */
+    glm::vec4 getTileRect(int owner, int face) const;
+
+    /**
+     * @brief Zwraca rozmiar kafelka przydzielonego światłu.
+     *
+     * @param owner Indeks światła.
+     * @return Bok kafelka w tekselach lub 0, gdy brak kafelka.
+     */
+    int getOwnerTileSize(int owner) const;
+
+    /**
+     * @brief Zwraca wszystkie kafelki ułożone w bieżącej klatce (do inspekcji).
+     *
+     * @return Wektor kafelków.
+     */
+    const std::vector<Tile>& getTiles() const;
+
+    /**
+     * @brief Zwraca zajętą część powierzchni atlasu.
+     *
+     * @return Wartość z przedziału 0 - 1.
+     */
+    float getOccupancy() const;
+
+    /**
+     * @brief Wypisuje układ atlasu (światło, ściana, położenie, rozmiar).
+     *
+     * @param out Strumień wyjściowy.
+     */
+    void printLayout(std::ostream& out) const;
+
+    /**
+     * @brief Pobiera identyfikator tekstury atlasu.
+     *
+     * @return Identyfikator tekstury `GL_TEXTURE_2D`.
+     */
+    GLuint getTexture() const;
+
+    /**
+     * @brief Pobiera bok atlasu.
+     *
+     * @return Bok atlasu w tekselach.
+     */
+    int getSize() const;
+
+private:
+    /**
+     * @brief Zamienia indeks na krzywej Mortona na współrzędne komórki.
+     *
+     * @param index Indeks komórki.
+     * @return Współrzędne (x, y) komórki.
+     */
+    static glm::ivec2 decodeMorton(unsigned int index);
+
+    GLuint fbo = 0;
+    GLuint depthTexture = 0;
+    int atlasSize;
+    int minTileSize;
+    int maxTileSize;
+    std::vector<Tile> tiles;
+    std::vector<int> ownerTileSize;
+    std::vector<int> ownerFirstTile;
+    size_t usedCells = 0;
+};
+
+#endif // SHADOWATLAS_H
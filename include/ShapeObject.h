@@ -3,6 +3,11 @@
 
 #include "DrawableObject.h"
 #include "TransformableObject.h"
+#include "BoundingBox.h"
+
+#include <atomic>
+#include <cstdint>
+#include <span>
 
 /**
  * @class ShapeObject
@@ -76,6 +81,92 @@ public:
      * @param axis Wektor osi obrotu.
      */
     virtual void rotateAround(float angle, const glm::vec3& axis) = 0;
+
+    /**
+     * @brief Zwraca prostopadłościan otaczający obiekt w przestrzeni świata.
+     *
+     * @return Aktualny prostopadłościan otaczający.
+     */
+    virtual const BoundingBox& getBounds() const = 0;
+
+    /**
+     * @brief Zwraca dane wierzchołków w przestrzeni świata (pozycja, UV, normalna - 8 wartości).
+     *
+     * @return Widok przeplatanych danych wierzchołków, ważny do następnej transformacji obiektu.
+     */
+    virtual std::span<const float> getVertices() const = 0;
+
+    /**
+     * @brief Zwraca indeksy trójkątów obiektu.
+     *
+     * @return Wektor indeksów.
+     */
+    virtual const std::vector<unsigned int>& getIndices() const = 0;
+
+    /**
+     * @brief Zwraca teksturę (materiał), z którą rysowany jest obiekt.
+     *
+     * @return Identyfikator tekstury OpenGL.
+     */
+    virtual GLuint getTexture() const = 0;
+
+    /**
+     * @brief Czy cały obiekt rysowany jest jedną teksturą (getTexture()).
+     *
+     * Obiekty z różnymi teksturami na ścianach nie mogą trafić do wspólnych buforów rysowanych
+     * z jedną teksturą na materiał (GpuScene) - rysowane są osobno przez draw().
+     */
+    virtual bool hasSingleTexture() const { return true; }
+
+    /**
+     * @brief Zwalnia bufory OpenGL obiektu, zachowując wierzchołki w pamięci CPU.
+     *
+     * Wywoływana dla obiektów scalonych w StaticBatch, które nie są już rysowane osobno.
+     */
+    virtual void releaseBuffers() {}
+
+    /**
+     * @brief Zwraca identyfikator obiektu, unikalny w obrębie procesu.
+     *
+     * W przeciwieństwie do adresu obiektu nie powtarza się, gdy pula (ObjectPool) utworzy
+     * nowy obiekt w miejscu zwolnionego.
+     *
+     * @return Identyfikator nadany przy konstrukcji.
+     */
+    uint64_t getId() const { return id; }
+
+    /**
+     * @brief Zwraca wersję geometrii, zmienianą przy każdej transformacji.
+     *
+     * Wersje pochodzą z jednego, rosnącego licznika całego procesu, więc nowy obiekt nigdy nie
+     * otrzyma wersji widzianej wcześniej przez bufory współdzielone (GpuScene).
+     *
+     * @return Numer bieżącej wersji wierzchołków.
+     */
+    uint64_t getRevision() const { return revision; }
+
+protected:
+    /**
+     * @brief Nadaje obiektowi unikalny identyfikator i początkową wersję geometrii.
+     */
+    ShapeObject() : id(nextStamp()), revision(id) {}
+
+    /**
+     * @brief Oznacza zmianę wierzchołków obiektu, nadając mu nową wersję.
+     */
+    void markChanged() { revision = nextStamp(); }
+
+private:
+    /**
+     * @brief Pobiera kolejną wartość globalnego licznika identyfikatorów i wersji.
+     */
+    static uint64_t nextStamp() {
+        static std::atomic<uint64_t> counter{ 0 };
+        return ++counter;
+    }
+
+    uint64_t id;        /**< Unikalny identyfikator obiektu. */
+    uint64_t revision;  /**< Bieżąca wersja geometrii obiektu. */
 };
 
 #endif // SHAPEOBJECT_H
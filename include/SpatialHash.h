@@ -0,0 +1,207 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "BoundingBox.h"
+#include "World.h"
+
+/**
+ * @class SpatialHash
+ * @brief Jednorodna siatka kolizyjna z haszowaniem komórek dla prostopadłościanów (OBB).
+ *
+ * Przestrzeń dzielona jest na sześcienne komórki o boku cellSize; komórka (x, y, z) trafia do
+ * jednego z kubełków przez funkcję skrótu, więc siatka nie ma granic, a pamięć nie zależy od
+ * rozmiaru świata. Zderzacz jest wpisany do każdej komórki, którą przecina jego AABB. Gdy wpisów
+ * przybywa, tablica kubełków jest podwajana, więc średnia długość kubełka pozostaje stała.
+ *
+ * Zapytanie odwiedza tylko komórki objęte obszarem zapytania i dokładnie testuje zderzacze
+ * z ich kubełków, więc jego koszt zależy od liczby obiektów w pobliżu, a nie od liczby wszystkich
+ * obiektów. Zderzacze statyczne (ściany) wpisywane są raz, dynamiczne (sześciany) przenoszone
+ * przez update() tylko wtedy, gdy zmieni się zakres ich komórek.
+ *
+ * Zapytania korzystają ze znaczników odwiedzin, więc nie mogą być wykonywane równolegle.
+ */
+class SpatialHash {
+public:
+    /**
+     * @brief Uchwyt zderzacza.
+     */
+    using Collider = uint32_t;
+
+    /**
+     * @struct Hit
+     * @brief Wynik przesunięcia sfery - pierwszy napotkany zderzacz.
+     */
+    struct Hit {
+        Collider collider;   /**< Trafiony zderzacz. */
+        Entity entity;       /**< Encja trafionego zderzacza. */
+        float time;          /**< Ułamek przesunięcia (0-1), przy którym sfera dotyka zderzacza. */
+        glm::vec3 normal;    /**< Normalna powierzchni w punkcie styku, skierowana do sfery. */
+    };
+
+    /**
+     * @brief Konstruktor tworzący pustą siatkę.
+     *
+     * @param cellSize Bok komórki - najlepiej rzędu rozmiaru typowego obiektu dynamicznego.
+     * @param bucketCount Początkowa liczba kubełków tablicy haszującej (zaokrąglana w górę do potęgi 2).
+     */
+    explicit SpatialHash(float cellSize = 2.0f, size_t bucketCount = 4096);
+
+    /**
+     * @brief Dodaje zderzacz w kształcie prostopadłościanu.
+     *
+     * @param entity Encja, do której należy zderzacz (zwracana w wynikach zapytań).
+     * @param center Środek prostopadłościanu.
+     * @param orientation Orientacja prostopadłościanu.
+     * @param halfExtents Połowy długości krawędzi.
+     * @return Uchwyt zderzacza.
+     */
+    Collider add(Entity entity, const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents);
+
+    /**
+     * @brief Przenosi zderzacz w nowe położenie.
+     */
+    void update(Collider collider, const glm::vec3& center, const glm::quat& orientation);
+
+    /**
+     * @brief Usuwa zderzacz z siatki.
+     */
+    void remove(Collider collider);
+
+    /**
+     * @brief Wyszukuje zderzacze, których AABB przecina podany prostopadłościan.
+     *
+     * @param box Obszar zapytania.
+     * @param results Wynikowe uchwyty (lista jest czyszczona).
+     */
+    void queryBox(const BoundingBox& box, std::vector<Collider>& results);
+
+    /**
+     * @brief Wyszukuje zderzacze przecinające sferę (test dokładny względem OBB).
+     *
+     * @param center Środek sfery.
+     * @param radius Promień sfery.
+     * @param results Wynikowe uchwyty (lista jest czyszczona).
+     */
+    void querySphere(const glm::vec3& center, float radius, std::vector<Collider>& results);
+
+    /**
+     * @brief Przesuwa sferę od start do end i zwraca pierwszy napotkany zderzacz.
+     *
+     * Sfera testowana jest jako promień względem prostopadłościanu powiększonego o promień sfery,
+     * więc przy krawędziach i narożnikach test jest nieco zachowawczy. Zderzacze, w których sfera
+     * już tkwi, zatrzymują tylko ruch w głąb.
+     *
+     * @param start Początkowy środek sfery.
+     * @param end Końcowy środek sfery.
+     * @param radius Promień sfery.
+     * @param hit Wynik - wypełniany, gdy zwrócono true.
+     * @return true, jeśli sfera napotkała zderzacz po drodze.
+     */
+    bool sweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, Hit& hit);
+
+    /**
+     * @brief Przesuwa sferę z poślizgiem po napotkanych powierzchniach.
+     *
+     * Po każdym zderzeniu pozostała część przesunięcia rzutowana jest na płaszczyznę styku,
+     * więc kamera sunie wzdłuż ściany zamiast się na niej zatrzymywać.
+     *
+     * @param start Początkowy środek sfery.
+     * @param displacement Żądane przesunięcie.
+     * @param radius Promień sfery.
+     * @return Końcowy środek sfery.
+     */
+    glm::vec3 slideSphere(const glm::vec3& start, const glm::vec3& displacement, float radius);
+
+    /**
+     * @brief Zwraca encję zderzacza.
+     */
+    Entity getEntity(Collider collider) const;
+
+    /**
+     * @brief Zwraca AABB zderzacza.
+     */
+    const BoundingBox& getBounds(Collider collider) const;
+
+    /**
+     * @brief Zwraca liczbę zderzaczy.
+     */
+    size_t getColliderCount() const;
+
+    /**
+     * @brief Zwraca liczbę zderzaczy sprawdzonych dokładnie w ostatnim zapytaniu.
+     */
+    size_t getCandidateCount() const;
+
+private:
+    /**
+     * @struct Box
+     * @brief Zderzacz - prostopadłościan z zakresem komórek, w których jest wpisany.
+     */
+    struct Box {
+        glm::vec3 center;        /**< Środek. */
+        glm::mat3 rotation;      /**< Macierz orientacji (kolumny to osie pudła). */
+        glm::vec3 halfExtents;   /**< Połowy długości krawędzi. */
+        BoundingBox bounds;      /**< AABB w przestrzeni świata. */
+        glm::ivec3 cellMin;      /**< Najmniejsza komórka zajmowana przez AABB. */
+        glm::ivec3 cellMax;      /**< Największa komórka zajmowana przez AABB. */
+        Entity entity;           /**< Encja właściciela. */
+        uint32_t stamp;          /**< Numer ostatniego zapytania, które odwiedziło zderzacz. */
+        bool alive;              /**< Czy uchwyt jest zajęty. */
+    };
+
+    /**
+     * @brief Przelicza AABB i zakres komórek zderzacza.
+     */
+    void updateBounds(Box& box) const;
+
+    /**
+     * @brief Wpisuje zderzacz do kubełków komórek z jego zakresu.
+     */
+    void insert(Collider collider);
+
+    /**
+     * @brief Wypisuje zderzacz z kubełków komórek z jego zakresu.
+     */
+    void erase(Collider collider);
+
+    /**
+     * @brief Podwaja tablicę kubełków i wpisuje wszystkie zderzacze od nowa.
+     */
+    void grow();
+
+    /**
+     * @brief Zwraca kubełek komórki.
+     */
+    size_t bucketOf(int x, int y, int z) const;
+
+    /**
+     * @brief Zwraca komórkę zawierającą punkt.
+     */
+    glm::ivec3 cellOf(const glm::vec3& point) const;
+
+    /**
+     * @brief Wywołuje visit dla każdego żywego zderzacza z komórek obszaru, każdy najwyżej raz.
+     */
+    template <typename Visit>
+    void forEachCandidate(const BoundingBox& area, Visit&& visit);
+
+    float cellSize;
+    float inverseCellSize;
+    size_t bucketMask;
+    std::vector<std::vector<Collider>> buckets;
+    std::vector<Box> boxes;
+    std::vector<Collider> freeColliders;
+    size_t entryCount = 0;
+    size_t colliderCount = 0;
+    uint32_t queryStamp = 0;
+    size_t candidateCount = 0;
+};
+
+#endif // SPATIALHASH_H
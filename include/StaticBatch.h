@@ -0,0 +1,161 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <vector>
+
+#include "ShapeObject.h"
+#include "BoundingBox.h"
+#include "Frustum.h"
+#include "VertexFormat.h"
+
+/**
+ * @class StaticBatch
+ * @brief Scalona geometria nieruchomych obiektów (ściany, geometria poziomu) - jedno wywołanie rysowania na materiał.
+ *
+ * Przy wczytywaniu poziomu wierzchołki wszystkich statycznych obiektów (już w przestrzeni
+ * świata) kopiowane są do jednego VBO/EBO i grupowane według komórki siatki (środka obiektu)
+ * i tekstury. Każda grupa (paczka) ma własny prostopadłościan otaczający, więc może być
+ * odrzucona przez frustum kamery albo maskę ścian mapy cieni tak jak pojedynczy obiekt - podział
+ * na komórki sprawia, że paczki nie obejmują całego poziomu. Obiekty po zbudowaniu paczki nie
+ * mogą się już przesuwać - zmiany ich wierzchołków nie są śledzone.
+ *
+ * Geometria wczytywana porcjami (fragmenty świata) dopisywana jest przez reserve(), append()
+ * i flush(): bufory alokowane są raz w pełnym rozmiarze, a każde flush() przesyła tylko
+ * dopisane od poprzedniego wywołania wierzchołki i indeksy.
+ */
+class StaticBatch {
+public:
+    /**
+     * @brief Konstruktor tworzący pusty bufor paczek.
+     *
+     * @param cellSize Bok komórki siatki, według której obiekty dzielone są na paczki.
+     */
+    explicit StaticBatch(float cellSize = 16.0f);
+
+    /**
+     * @brief Destruktor zwalniający zasoby OpenGL.
+     */
+    ~StaticBatch();
+
+    StaticBatch(const StaticBatch&) = delete;
+    StaticBatch& operator=(const StaticBatch&) = delete;
+
+    /**
+     * @brief Scala obiekty w paczki według komórki i materiału i przesyła je do GPU.
+     *
+     * Obiekty nie są później rysowane osobno, więc wywołujący może zwolnić ich bufory
+     * (ShapeObject::releaseBuffers()).
+     *
+     * @param objects Statyczne obiekty sceny.
+     */
+    void build(const std::vector<ShapeObject*>& objects);
+
+    /**
+     * @brief Usuwa paczki i alokuje bufory na geometrię dopisywaną przez append().
+     *
+     * Typ indeksów wybierany jest od razu według liczby wierzchołków, więc dopisywanie nie
+     * wymaga przenoszenia przesłanych już danych.
+     *
+     * @param maxVertices Maksymalna liczba wierzchołków.
+     * @param maxIndices Maksymalna liczba indeksów.
+     */
+    void reserve(size_t maxVertices, size_t maxIndices);
+
+    /**
+     * @brief Dopisuje obiekt do buforów przygotowanych przez reserve().
+     *
+     * Kolejne obiekty z tą samą teksturą trafiają do jednej paczki, więc obiekty powinny
+     * przychodzić posortowane po materiale. Dane trafiają do GPU dopiero przy flush().
+     *
+     * @param texture Tekstura obiektu.
+     * @param vertices Wierzchołki w przestrzeni świata (8 wartości float na wierzchołek).
+     * @param indices Indeksy trójkątów względem pierwszego wierzchołka obiektu.
+     * @return false, gdy obiekt nie mieści się w zarezerwowanych buforach.
+     */
+    bool append(GLuint texture, std::span<const float> vertices, const std::vector<unsigned int>& indices);
+
+    /**
+     * @brief Przesyła do GPU obiekty dopisane od poprzedniego wywołania.
+     *
+     * @return Liczba przesłanych bajtów.
+     */
+    size_t flush();
+
+    /**
+     * @brief Rysuje paczki przecinające frustum.
+     *
+     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param view Macierz widoku.
+     * @param projection Macierz projekcji.
+     * @param frustum Frustum, względem którego odrzucane są paczki.
+     * @return Liczba narysowanych paczek.
+     */
+    size_t draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection, const Frustum& frustum = Frustum()) const;
+
+    /**
+     * @brief Rysuje jedną paczkę.
+     *
+     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param batch Indeks paczki.
+     * @param view Macierz widoku.
+     * @param projection Macierz projekcji.
+     */
+    void drawBatch(GLuint shaderProgram, size_t batch, const glm::mat4& view, const glm::mat4& projection) const;
+
+    /**
+     * @brief Zwraca liczbę paczek.
+     */
+    size_t getBatchCount() const;
+
+    /**
+     * @brief Zwraca rozmiar jednego indeksu w EBO w bajtach (2 lub 4).
+     */
+    size_t getIndexSize() const;
+
+    /**
+     * @brief Zwraca prostopadłościan otaczający paczki.
+     *
+     * @param batch Indeks paczki.
+     */
+    const BoundingBox& getBounds(size_t batch) const;
+
+private:
+    /**
+     * @struct Batch
+     * @brief Zakres indeksów jednej komórki rysowany z jedną teksturą.
+     */
+    struct Batch {
+        GLuint texture;         /**< Tekstura materiału. */
+        GLuint firstIndex;      /**< Pierwszy indeks paczki w EBO. */
+        GLsizei indexCount;     /**< Liczba indeksów paczki. */
+        BoundingBox bounds;     /**< Prostopadłościan otaczający wszystkie obiekty paczki. */
+    };
+
+    /**
+     * @brief Ustawia macierze programu i podpina VAO.
+     */
+    void bind(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) const;
+
+    /**
+     * @brief Wywołuje rysowanie zakresu indeksów paczki z jej teksturą.
+     */
+    void drawRange(const Batch& batch) const;
+
+    float cellSize;
+    size_t vertexCapacity = 0;
+    size_t indexCapacity = 0;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    std::vector<PackedVertex> pendingVertices;
+    std::vector<unsigned int> pendingIndices;
+    GLuint vao = 0;
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    std::vector<Batch> batches;
+};
+
+#endif // STATICBATCH_H
@@ -0,0 +1,127 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+#include <GL/glew.h>
+#include <chrono>
+#include <iostream>
+
+/**
+ * @class StreamBuffer
+ * @brief Pierścieniowy bufor danych zmiennych co klatkę, trwale zmapowany do pamięci CPU.
+ *
+ * Bufor tworzony jest przez `glBufferStorage` z flagami `GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT`
+ * i mapowany raz na cały czas życia. Dzieli się na kilka regionów (domyślnie trzy) - w każdej
+ * klatce CPU zapisuje do kolejnego regionu, a na koniec klatki stawiany jest `glFenceSync`.
+ * Przed ponownym użyciem regionu czekamy na jego płot; jeśli GPU wciąż go czyta, zdarzenie
+ * liczone jest jako przestój (wraz z czasem oczekiwania). W przeciwieństwie do `glBufferSubData`
+ * zapis nigdy nie wymusza niejawnej synchronizacji sterownika.
+ *
+ * Region rośnie: reserve() powiększa go z góry, a rezerwacje odrzucone w klatce z powodu
+ * przepełnienia powiększają go (do potęgi dwójki) w następnym beginFrame(). Powiększenie tworzy
+ * bufor od nowa, więc przesunięcia z wcześniejszych klatek tracą ważność.
+ *
+ * Bez GL_ARB_buffer_storage bufor tworzony jest zwykłym `glBufferData`, a allocate() zawsze
+ * zwraca nullptr - wywołujący przesyłają wtedy dane przez `glBufferSubData` do getBuffer().
+ */
+class StreamBuffer {
+public:
+    /**
+     * @brief Konstruktor tworzący bufor i mapujący go na stałe.
+     *
+     * @param target Cel, do którego bufor będzie podpinany (np. `GL_UNIFORM_BUFFER`).
+     * @param regionSize Rozmiar jednego regionu w bajtach.
+     * @param regionCount Liczba regionów (klatek w locie).
+     */
+    StreamBuffer(GLenum target, size_t regionSize, int regionCount = 3);
+
+    /**
+     * @brief Destruktor zwalniający płoty i bufor.
+     */
+    ~StreamBuffer();
+
+    /**
+     * @brief Powiększa region do co najmniej podanego rozmiaru (wywoływać poza klatką).
+     *
+     * @param size Wymagany rozmiar regionu w bajtach.
+     */
+    void reserve(size_t size);
+
+    /**
+     * @brief Przechodzi do kolejnego regionu, czekając na zakończenie jego odczytu przez GPU.
+     *
+     * Jeśli w poprzedniej klatce region się przepełnił, najpierw powiększa bufor.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Rezerwuje miejsce w bieżącym regionie.
+     *
+     * @param size Rozmiar danych w bajtach.
+     * @param alignment Wymagane wyrównanie przesunięcia (np. `GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT`).
+     * @param offset Przesunięcie zarezerwowanego miejsca względem początku bufora.
+     * @return Wskaźnik do zapisu lub nullptr, gdy region jest pełny albo bufor nie jest zmapowany.
+     */
+    void* allocate(size_t size, size_t alignment, GLintptr& offset);
+
+    /**
+     * @brief Stawia płot za ostatnim poleceniem korzystającym z bieżącego regionu.
+     */
+    void endFrame();
+
+    /**
+     * @brief Pobiera identyfikator bufora.
+     */
+    GLuint getBuffer() const;
+
+    /**
+     * @brief Zwraca liczbę klatek, w których trzeba było czekać na GPU.
+     */
+    size_t getStallCount() const;
+
+    /**
+     * @brief Zwraca łączny czas oczekiwania na GPU w milisekundach.
+     */
+    double getStallTime() const;
+
+    /**
+     * @brief Zwraca liczbę rezerwacji odrzuconych z powodu przepełnienia regionu.
+     */
+    size_t getOverflowCount() const;
+
+    /**
+     * @brief Zwraca bieżący rozmiar regionu w bajtach.
+     */
+    size_t getRegionSize() const;
+
+private:
+    /**
+     * @brief Tworzy i mapuje bufor o bieżącym rozmiarze regionu.
+     */
+    void create();
+
+    /**
+     * @brief Zwalnia płoty, odmapowuje i usuwa bufor.
+     */
+    void destroy();
+
+    /**
+     * @brief Maksymalna liczba regionów.
+     */
+    static const int MAX_REGIONS = 4;
+
+    GLenum target;
+    GLuint buffer = 0;
+    unsigned char* mapped = nullptr;
+    size_t regionSize;
+    int regionCount;
+    int region = 0;
+    size_t cursor = 0;
+    size_t demand = 0;
+    bool overflowed = false;
+    GLsync fences[MAX_REGIONS] = {};
+    size_t stallCount = 0;
+    double stallTime = 0.0;
+    size_t overflowCount = 0;
+};
+
+#endif // STREAMBUFFER_H
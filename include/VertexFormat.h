@@ -0,0 +1,111 @@
+#ifndef VERTEXFORMAT_H
+#define VERTEXFORMAT_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Liczba wartości float na wierzchołek w danych źródłowych (pozycja, UV, normalna).
+ */
+constexpr size_t VERTEX_FLOATS = 8;
+
+/**
+ * @brief Największa liczba wierzchołków, którą można adresować indeksami 16-bitowymi.
+ */
+constexpr size_t SHORT_INDEX_LIMIT = 65536;
+
+/**
+ * @struct PackedVertex
+ * @brief Skompresowany wierzchołek przesyłany do GPU (20 bajtów zamiast 32).
+ *
+ * Pozycja pozostaje w pełnej precyzji (wierzchołki ścian i sześcianów są w przestrzeni świata,
+ * więc half-float dawałby widoczne szczeliny), współrzędne tekstur zapisane są jako dwa
+ * half-floaty, a normalna jako znormalizowane `GL_INT_2_10_10_10_REV`.
+ */
+struct PackedVertex {
+    float position[3];      /**< Pozycja (x, y, z). */
+    uint32_t texCoord;      /**< Współrzędne tekstury (u, v) jako dwa half-floaty. */
+    uint32_t normal;        /**< Normalna jako 10-bitowe składowe snorm (x, y, z). */
+};
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must be tightly packed");
+
+/**
+ * @class VertexFormat
+ * @brief Jedna definicja układu wierzchołków używana przez wszystkie siatki.
+ *
+ * Obiekty przechowują na CPU wierzchołki jako 8 wartości float (łatwe transformacje), a przed
+ * przesłaniem pakują je do PackedVertex. Ten sam układ atrybutów ustawiany jest w każdym VAO
+ * (Cube, Wall, GpuScene, Model) i zapisywany w plikach siatek. Indeksy przesyłane są jako
+ * 16-bitowe, gdy liczba wierzchołków na to pozwala.
+ */
+class VertexFormat {
+public:
+    /**
+     * @brief Pakuje jeden wierzchołek.
+     *
+     * @param vertex Wskaźnik na 8 wartości float (pozycja, UV, normalna).
+     * @return Skompresowany wierzchołek.
+     */
+    static PackedVertex pack(const float* vertex);
+
+    /**
+     * @brief Pakuje tablicę przeplatanych wierzchołków.
+     *
+     * @param vertices Wierzchołki źródłowe (8 wartości float na wierzchołek).
+     * @return Skompresowane wierzchołki.
+     */
+    static std::vector<PackedVertex> pack(std::span<const float> vertices);
+
+    /**
+     * @brief Sprawdza, czy siatkę o podanej liczbie wierzchołków można indeksować 16 bitami.
+     *
+     * @param vertexCount Liczba wierzchołków siatki.
+     */
+    static bool fitsShortIndices(size_t vertexCount);
+
+    /**
+     * @brief Zawęża indeksy do 16 bitów (wywoływać tylko, gdy fitsShortIndices() zwraca true).
+     *
+     * @param indices Indeksy 32-bitowe.
+     * @return Indeksy 16-bitowe.
+     */
+    static std::vector<uint16_t> packIndices(const std::vector<uint32_t>& indices);
+
+    /**
+     * @brief Ustawia atrybuty 0-2 bieżącego VAO dla bufora PackedVertex podpiętego pod `GL_ARRAY_BUFFER`.
+     */
+    static void setupAttributes() {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoord));
+        glEnableVertexAttribArray(1);
+
+        glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+        glEnableVertexAttribArray(2);
+    }
+
+    /**
+     * @brief Przesyła indeksy do podpiętego `GL_ELEMENT_ARRAY_BUFFER` w najmniejszym pasującym typie.
+     *
+     * @param indices Indeksy 32-bitowe.
+     * @param vertexCount Liczba wierzchołków, do których odwołują się indeksy.
+     * @param usage Wskazówka użycia bufora (np. `GL_STATIC_DRAW`).
+     * @return Typ indeksów do `glDrawElements` (`GL_UNSIGNED_SHORT` lub `GL_UNSIGNED_INT`).
+     */
+    static GLenum uploadIndices(const std::vector<uint32_t>& indices, size_t vertexCount, GLenum usage) {
+        if (fitsShortIndices(vertexCount)) {
+            std::vector<uint16_t> shortIndices = packIndices(indices);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(), usage);
+            return GL_UNSIGNED_SHORT;
+        }
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), usage);
+        return GL_UNSIGNED_INT;
+    }
+};
+
+#endif // VERTEXFORMAT_H
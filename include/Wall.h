@@ -4,6 +4,7 @@
 #include <vector>
 #include <array>
 #include "ShapeObject.h"
+#include "VertexFormat.h"
 
 #include <iostream>
 
@@ -53,6 +54,11 @@ public:
      */
     void setupBuffers();
 
+    /**
+     * @brief Usuwa VAO/VBO/EBO ściany; wierzchołki zostają (kolizje, zapis sceny).
+     */
+    void releaseBuffers() override;
+
     /**
      * @brief Rysuje ścianę przy użyciu podanego programu cieniującego i macierzy transformacji.
      *
@@ -103,7 +109,50 @@ public:
      */
     void rotateAround(float angle, const glm::vec3& axis);
 
+    /**
+     * @brief Zwraca prostopadłościan otaczający ścianę w przestrzeni świata.
+     *
+     * @return Aktualny prostopadłościan otaczający.
+     */
+    const BoundingBox& getBounds() const override;
+
+    /**
+     * @brief Zwraca dane wierzchołków ściany w przestrzeni świata.
+     *
+     * @return Wektor przeplatanych danych wierzchołków.
+     */
+    std::span<const float> getVertices() const override;
+
+    /**
+     * @brief Zwraca indeksy trójkątów ściany.
+     *
+     * @return Wektor indeksów.
+     */
+    const std::vector<unsigned int>& getIndices() const override;
+
+    /**
+     * @brief Zwraca teksturę ściany.
+     *
+     * @return Identyfikator tekstury OpenGL.
+     */
+    GLuint getTexture() const override;
+
 private:
+    /**
+     * @brief Pakuje wierzchołki (VertexFormat) i przesyła je do VBO po transformacji.
+     */
+    void uploadVertices();
+
+    /**
+     * @brief Prostopadłościan otaczający, odświeżany po każdej zmianie wierzchołków.
+     */
+    BoundingBox bounds;
+
+    /**
+     * @brief Typ indeksów w EBO (16-bitowe, gdy liczba wierzchołków na to pozwala).
+     */
+    GLenum indexType = GL_UNSIGNED_INT;
+
     /**
      * @brief Wektor przechowujący współrzędne wierzchołków ściany.
      */
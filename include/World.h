@@ -0,0 +1,286 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct Entity
+ * @brief Uchwyt encji - indeks rekordu i numer generacji.
+ *
+ * Generacja rośnie przy każdym usunięciu encji, więc uchwyt do usuniętej encji nie wskaże
+ * przypadkiem nowej encji, która odziedziczyła ten sam indeks. Domyślny uchwyt (generacja 0)
+ * nigdy nie jest żywy.
+ */
+struct Entity {
+    uint32_t index = 0;         /**< Indeks rekordu encji. */
+    uint32_t generation = 0;    /**< Generacja rekordu w chwili utworzenia uchwytu. */
+
+    bool operator==(const Entity& other) const = default;
+};
+
+/**
+ * @class World
+ * @brief Magazyn encji i komponentów oparty na archetypach (ECS).
+ *
+ * Encje o tym samym zestawie komponentów należą do jednego archetypu, w którym każdy typ
+ * komponentu ma własną, gęstą tablicę (kolumnę). Systemy przechodzą przez each() kolejno po
+ * pasujących archetypach i wierszach, czytając komponenty z ciągłej pamięci zamiast przez
+ * wskaźniki do osobnych obiektów. Dodanie lub usunięcie komponentu przenosi encję do innego
+ * archetypu; usunięcie wiersza zastępuje go ostatnim wierszem archetypu.
+ *
+ * Komponenty muszą być trywialnie kopiowalne (przenoszone są przez memcpy). Wskaźniki i referencje
+ * do komponentów tracą ważność po każdej zmianie strukturalnej (create, destroy, add, remove),
+ * dlatego w funkcji przekazanej do each() nie wolno zmieniać struktury świata.
+ */
+class World {
+public:
+    /**
+     * @brief Maksymalna liczba typów komponentów (bity sygnatury archetypu).
+     */
+    static constexpr size_t MAX_COMPONENTS = 64;
+
+    /**
+     * @brief Zbiór typów komponentów jako maska bitowa.
+     */
+    using Signature = uint64_t;
+
+    /**
+     * @brief Konstruktor tworzący świat z pustym archetypem.
+     */
+    World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    /**
+     * @brief Tworzy encję bez komponentów.
+     */
+    Entity create();
+
+    /**
+     * @brief Tworzy encję od razu w archetypie podanych komponentów.
+     *
+     * @param components Wartości początkowe komponentów.
+     * @return Uchwyt encji.
+     */
+    template <typename... Ts>
+    Entity create(const Ts&... components) {
+        static_assert(sizeof...(Ts) > 0, "Use create() for an empty entity");
+        uint32_t archetypeIndex = findArchetype((signatureOf<Ts>() | ...));
+        Entity entity = allocateEntity(archetypeIndex);
+        Archetype& archetype = archetypes[archetypeIndex];
+        uint32_t row = records[entity.index].row;
+        (std::memcpy(columnData<Ts>(archetype) + row, &components, sizeof(Ts)), ...);
+        return entity;
+    }
+
+    /**
+     * @brief Usuwa encję wraz z komponentami. Uchwyt (i jego kopie) przestaje być żywy.
+     */
+    void destroy(Entity entity);
+
+    /**
+     * @brief Sprawdza, czy uchwyt wskazuje istniejącą encję.
+     */
+    bool isAlive(Entity entity) const;
+
+    /**
+     * @brief Dodaje komponent do encji (lub nadpisuje istniejący).
+     *
+     * @param entity Żywa encja.
+     * @param component Wartość komponentu.
+     */
+    template <typename T>
+    void add(Entity entity, const T& component) {
+        assert(isAlive(entity));
+        if (!has<T>(entity)) {
+            moveEntity(entity, findArchetype(archetypes[records[entity.index].archetype].signature | signatureOf<T>()));
+        }
+        *get<T>(entity) = component;
+    }
+
+    /**
+     * @brief Usuwa komponent z encji, jeśli go ma.
+     */
+    template <typename T>
+    void remove(Entity entity) {
+        if (has<T>(entity)) {
+            moveEntity(entity, findArchetype(archetypes[records[entity.index].archetype].signature & ~signatureOf<T>()));
+        }
+    }
+
+    /**
+     * @brief Sprawdza, czy żywa encja ma komponent danego typu.
+     */
+    template <typename T>
+    bool has(Entity entity) const {
+        return isAlive(entity) && (archetypes[records[entity.index].archetype].signature & signatureOf<T>()) != 0;
+    }
+
+    /**
+     * @brief Zwraca komponent encji.
+     *
+     * @return Wskaźnik ważny do następnej zmiany strukturalnej albo nullptr, jeśli encja nie żyje lub nie ma komponentu.
+     */
+    template <typename T>
+    T* get(Entity entity) {
+        if (!has<T>(entity)) {
+            return nullptr;
+        }
+        return columnData<T>(archetypes[records[entity.index].archetype]) + records[entity.index].row;
+    }
+
+    /**
+     * @brief Wywołuje funkcję dla każdej encji mającej wszystkie podane komponenty.
+     *
+     * Funkcja dostaje uchwyt encji i referencje do komponentów w kolejności typów: f(Entity, Ts&...).
+     * Nie może tworzyć, usuwać ani zmieniać zestawu komponentów encji.
+     */
+    template <typename... Ts, typename F>
+    void each(F&& function) {
+        const Signature mask = (signatureOf<Ts>() | ... | Signature(0));
+        for (Archetype& archetype : archetypes) {
+            if ((archetype.signature & mask) == mask && !archetype.entities.empty()) {
+                eachRow(archetype, function, columnData<Ts>(archetype)...);
+            }
+        }
+    }
+
+    /**
+     * @brief Zwraca liczbę encji mających wszystkie podane komponenty.
+     */
+    template <typename... Ts>
+    size_t count() const {
+        const Signature mask = (signatureOf<Ts>() | ... | Signature(0));
+        size_t total = 0;
+        for (const Archetype& archetype : archetypes) {
+            if ((archetype.signature & mask) == mask) {
+                total += archetype.entities.size();
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Zwraca liczbę żywych encji.
+     */
+    size_t getEntityCount() const;
+
+    /**
+     * @brief Zwraca liczbę archetypów (także pustych).
+     */
+    size_t getArchetypeCount() const;
+
+    /**
+     * @brief Zwraca identyfikator typu komponentu, nadawany przy pierwszym użyciu typu.
+     */
+    template <typename T>
+    static uint32_t componentId() {
+        static_assert(std::is_trivially_copyable_v<T>, "Components are moved with memcpy and must be trivially copyable");
+        static const uint32_t id = registerComponent(sizeof(T));
+        return id;
+    }
+
+private:
+    /**
+     * @struct Column
+     * @brief Gęsta tablica komponentów jednego typu w archetypie.
+     */
+    struct Column {
+        uint32_t component;             /**< Identyfikator typu komponentu. */
+        size_t elementSize;             /**< Rozmiar komponentu w bajtach. */
+        std::vector<uint8_t> data;      /**< Komponenty kolejnych wierszy. */
+    };
+
+    /**
+     * @struct Archetype
+     * @brief Encje o identycznym zestawie komponentów.
+     */
+    struct Archetype {
+        Signature signature;                            /**< Typy komponentów archetypu. */
+        std::vector<Entity> entities;                   /**< Encja w każdym wierszu. */
+        std::vector<Column> columns;                    /**< Kolumny w kolejności identyfikatorów typów. */
+        std::array<int8_t, MAX_COMPONENTS> columnOf;    /**< Indeks kolumny dla typu komponentu (-1 gdy brak). */
+    };
+
+    /**
+     * @struct EntityRecord
+     * @brief Położenie encji w archetypach.
+     */
+    struct EntityRecord {
+        uint32_t generation;    /**< Bieżąca generacja indeksu. */
+        uint32_t archetype;     /**< Archetyp encji. */
+        uint32_t row;           /**< Wiersz encji w archetypie. */
+    };
+
+    template <typename T>
+    static Signature signatureOf() {
+        return Signature(1) << componentId<T>();
+    }
+
+    template <typename T>
+    static T* columnData(Archetype& archetype) {
+        return reinterpret_cast<T*>(archetype.columns[archetype.columnOf[componentId<T>()]].data.data());
+    }
+
+    template <typename F, typename... Ts>
+    static void eachRow(Archetype& archetype, F& function, Ts*... columns) {
+        const Entity* entities = archetype.entities.data();
+        size_t rows = archetype.entities.size();
+        for (size_t row = 0; row < rows; row++) {
+            function(entities[row], columns[row]...);
+        }
+    }
+
+    /**
+     * @brief Rejestruje nowy typ komponentu o podanym rozmiarze.
+     */
+    static uint32_t registerComponent(size_t size);
+
+    /**
+     * @brief Rozmiary zarejestrowanych typów komponentów.
+     */
+    static std::array<size_t, MAX_COMPONENTS>& componentSizes();
+
+    /**
+     * @brief Zwraca indeks archetypu o danej sygnaturze, tworząc go w razie potrzeby.
+     */
+    uint32_t findArchetype(Signature signature);
+
+    /**
+     * @brief Przydziela rekord encji i dopisuje ją na koniec archetypu (z niezainicjowanymi komponentami).
+     */
+    Entity allocateEntity(uint32_t archetypeIndex);
+
+    /**
+     * @brief Dopisuje pusty wiersz do archetypu.
+     *
+     * @return Indeks nowego wiersza.
+     */
+    uint32_t appendRow(Archetype& archetype, Entity entity);
+
+    /**
+     * @brief Przenosi encję do innego archetypu, kopiując wspólne komponenty.
+     */
+    void moveEntity(Entity entity, uint32_t targetIndex);
+
+    /**
+     * @brief Usuwa wiersz archetypu, wstawiając w jego miejsce ostatni wiersz.
+     */
+    void removeRow(uint32_t archetypeIndex, uint32_t row);
+
+    std::vector<Archetype> archetypes;
+    std::unordered_map<Signature, uint32_t> archetypeLookup;
+    std::vector<EntityRecord> records;
+    std::vector<uint32_t> freeIndices;
+    size_t aliveCount = 0;
+};
+
+#endif // WORLD_H
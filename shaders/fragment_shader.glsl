@@ -15,11 +15,6 @@ in vec3 Normal;
  */
 in vec2 TexCoord;
 
-/**
- * @brief Pozycja fragmentu w przestrzeni światła dla wielu źródeł światła.
- */
-in vec4 FragPosLightSpace[10];
-
 /**
  * @struct Light
  * @brief Struktura reprezentująca pojedyncze źródło światła.
@@ -27,7 +22,10 @@ in vec4 FragPosLightSpace[10];
 struct Light {
     vec3 position;    /**< Pozycja światła w przestrzeni świata. */
     vec3 color;       /**< Kolor światła. */
-    sampler2D shadowMap; /**< Mapa cieni przypisana do światła. */
+    float farPlane;   /**< Zasięg dookólnej mapy cieni światła. */
+    float radius;     /**< Promień wpływu - dalej wkład światła jest poniżej progu i jest pomijany. */
+    int shadowIndex;  /**< Indeks światła w tablicy map sześciennych (światła są upakowane po odrzuceniu). */
+    vec4 shadowTiles[6]; /**< Kafelki ścian w atlasie cieni (xy = początek, zw = rozmiar w UV). */
 };
 
 /**
@@ -36,9 +34,36 @@ struct Light {
 uniform int numLights;
 
 /**
- * @brief Tablica świateł dostępnych w scenie.
+ * @brief Tablica świateł widocznych w bieżącej klatce (std140, zapisywana co klatkę do bufora pierścieniowego).
+ */
+layout (std140, binding = 0) uniform LightBlock {
+    Light lights[10];
+};
+
+/**
+ * @brief Liniowy współczynnik osłabienia (wspólny z obliczeniem promienia wpływu na CPU).
  */
-uniform Light lights[10];
+uniform float attenuationLinear = 0.05;
+
+/**
+ * @brief Kwadratowy współczynnik osłabienia (wspólny z obliczeniem promienia wpływu na CPU).
+ */
+uniform float attenuationQuadratic = 0.02;
+
+/**
+ * @brief Dookólne mapy cieni świateł (sześć warstw na światło, porównanie sprzętowe).
+ */
+uniform samplerCubeArrayShadow pointShadowMaps;
+
+/**
+ * @brief Wspólny atlas cieni, z którego światła otrzymują kafelki o zmiennym rozmiarze.
+ */
+uniform sampler2DShadow shadowAtlas;
+
+/**
+ * @brief Czy cienie świateł punktowych pobierane są z atlasu (zamiast z tablicy map sześciennych).
+ */
+uniform bool useShadowAtlas = false;
 
 /**
  * @brief Pozycja widza/kamery w przestrzeni świata.
@@ -55,6 +80,75 @@ uniform sampler2D texture1;
  */
 uniform float shadowStrength = 1.5;
 
+/**
+ * @brief Czy światło kierunkowe (słońce) jest aktywne.
+ */
+uniform bool sunEnabled = false;
+
+/**
+ * @brief Kierunek padania światła kierunkowego (od światła do sceny).
+ */
+uniform vec3 sunDirection;
+
+/**
+ * @brief Kolor światła kierunkowego.
+ */
+uniform vec3 sunColor;
+
+/**
+ * @brief Kaskady mapy cieni światła kierunkowego (jedna warstwa na kaskadę).
+ */
+uniform sampler2DArrayShadow cascadeShadowMap;
+
+/**
+ * @brief Liczba aktywnych kaskad.
+ */
+uniform int numCascades;
+
+/**
+ * @brief Dalekie granice kaskad jako głębokość w przestrzeni widoku.
+ */
+uniform float cascadeSplits[4];
+
+/**
+ * @brief Macierze przestrzeni światła dla kolejnych kaskad.
+ */
+uniform mat4 cascadeMatrices[4];
+
+/**
+ * @brief Macierz widoku kamery (do wyznaczenia głębokości fragmentu przy wyborze kaskady).
+ */
+uniform mat4 view;
+
+/**
+ * @brief Wartość debugMode wizualizująca kaskady cieni.
+ */
+const int DEBUG_CASCADES = 10;
+
+/**
+ * @brief Liczba próbek jądra PCF (1 = pojedyncze sprzętowe próbkowanie dwuliniowe).
+ */
+uniform int pcfSamples = 1;
+
+/**
+ * @brief Promień jądra PCF w tekselach mapy cieni.
+ */
+uniform float pcfRadius = 1.5;
+
+/**
+ * @brief Punkty dysku Poissona używane przez jądro PCF (maksymalnie 16 próbek).
+ */
+const vec2 poissonDisk[16] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2(0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2(0.34495938, 0.29387760),
+    vec2(-0.91588581, 0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543, 0.27676845), vec2(0.97484398, 0.75648379),
+    vec2(0.44323325, -0.97511554), vec2(0.53742981, -0.47373420),
+    vec2(-0.26496911, -0.41893023), vec2(0.79197514, 0.19090188),
+    vec2(-0.24188840, 0.99706507), vec2(-0.81409955, 0.91437590),
+    vec2(0.19984126, 0.78641367), vec2(0.14383161, -0.14100790)
+);
+
 /**
  * @brief Tryb debugowania (0 = wyłączony, wartości >0 wskazują konkretne źródło światła).
  */
@@ -77,27 +171,155 @@ float computeBias(vec3 normal, vec3 lightDir) {
 }
 
 /**
- * @brief Oblicza wartość cienia dla fragmentu.
+ * @brief Wyznacza ścianę mapy sześciennej i współrzędne na niej dla danego kierunku.
+ *
+ * Odpowiada konwencji ścian OpenGL oraz macierzom z OmniShadowMap::computeFaceMatrices.
+ *
+ * @param direction Kierunek od światła do fragmentu.
+ * @param face Indeks ściany (wyjście).
+ * @return Współrzędne na ścianie w przedziale [0,1].
+ */
+vec2 cubeFaceCoords(vec3 direction, out int face) {
+    vec3 absDir = abs(direction);
+    float major;
+    vec2 coords;
+    if (absDir.x >= absDir.y && absDir.x >= absDir.z) {
+        face = direction.x > 0.0 ? 0 : 1;
+        major = absDir.x;
+        coords = vec2(direction.x > 0.0 ? -direction.z : direction.z, -direction.y);
+    }
+    else if (absDir.y >= absDir.z) {
+        face = direction.y > 0.0 ? 2 : 3;
+        major = absDir.y;
+        coords = vec2(direction.x, direction.y > 0.0 ? direction.z : -direction.z);
+    }
+    else {
+        face = direction.z > 0.0 ? 4 : 5;
+        major = absDir.z;
+        coords = vec2(direction.z > 0.0 ? direction.x : -direction.x, -direction.y);
+    }
+    return coords / major * 0.5 + 0.5;
+}
+
+/**
+ * @brief Pobiera porównanie głębokości z mapy cieni światła dla danego kierunku.
  *
- * @param fragPosLight Pozycja fragmentu w przestrzeni światła.
- * @param shadowMap Mapa cieni przypisana do światła.
+ * @param light Indeks światła.
+ * @param direction Kierunek od światła do punktu próbkowania.
+ * @param reference Głębokość odniesienia.
+ * @return 1.0 dla punktu oświetlonego, 0.0 dla zacienionego (z filtrowaniem dwuliniowym).
+ */
+float sampleShadow(int light, vec3 direction, float reference) {
+    if (useShadowAtlas) {
+        int face;
+        vec2 coords = cubeFaceCoords(direction, face);
+        vec4 tile = lights[light].shadowTiles[face];
+
+        // Pół teksela marginesu, aby filtrowanie nie sięgało do sąsiedniego kafelka
+        vec2 border = 0.5 / (tile.zw * vec2(textureSize(shadowAtlas, 0)));
+        coords = clamp(coords, border, 1.0 - border);
+        return texture(shadowAtlas, vec3(tile.xy + coords * tile.zw, reference));
+    }
+    return texture(pointShadowMaps, vec4(direction, lights[light].shadowIndex), reference);
+}
+
+/**
+ * @brief Oblicza wartość cienia światła punktowego z dookólnej mapy cieni.
+ *
+ * Każde pobranie (z atlasu lub `samplerCubeArrayShadow`) wykonuje sprzętowe porównanie z filtrowaniem
+ * dwuliniowym, a opcjonalne jądro z dysku Poissona rozkładane jest w płaszczyźnie
+ * prostopadłej do kierunku od światła.
+ *
+ * @param light Indeks światła.
  * @param normal Wektor normalny powierzchni.
  * @param lightDir Kierunek do źródła światła.
  * @return Wartość cienia (1.0 = całkowicie zacienione, 0.0 = bez cienia).
  */
-float ShadowCalculation(vec4 fragPosLight, sampler2D shadowMap, vec3 normal, vec3 lightDir) {
-    vec3 projCoords = fragPosLight.xyz / fragPosLight.w;  // Przekształcenie współrzędnych do przestrzeni NDC
-    projCoords = projCoords * 0.5 + 0.5; // Przekształcenie do przedziału [0,1]
+float ShadowCalculation(int light, vec3 normal, vec3 lightDir) {
+    vec3 fragToLight = FragPos - lights[light].position;
+    float currentDepth = length(fragToLight) / lights[light].farPlane; // Liniowa głębokość jak w point_shadow_fragment_shader
+
+    // Fragment poza zasięgiem mapy cieni nie jest zacieniony
+    if (currentDepth > 1.0)
+        return 0.0;
+
+    // Światło bez miejsca w atlasie nie rzuca cienia
+    if (useShadowAtlas && lights[light].shadowTiles[0].z <= 0.0)
+        return 0.0;
+
+    // Głębokość odniesienia pomniejszona o bias - porównanie GL_LEQUAL zwraca 1.0 dla oświetlonych tekseli
+    float reference = currentDepth - computeBias(normal, lightDir);
 
-    // Jeśli fragment znajduje się poza zakresem mapy cieni, nie rzutuje cienia
-    if (projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0 || projCoords.y > 1.0 || projCoords.z > 1.0)
-        return 0.0; 
+    if (pcfSamples <= 1)
+        return 1.0 - sampleShadow(light, fragToLight, reference);
 
-    float closestDepth = texture(shadowMap, projCoords.xy).r; // Pobranie głębokości zapisanej w mapie cieni
-    float dynamicBias = computeBias(normal, lightDir);
+    // Baza styczna do kierunku próbkowania - przesunięcia jądra leżą na ścianie sześcianu
+    vec3 axis = normalize(fragToLight);
+    vec3 tangent = normalize(cross(axis, abs(axis.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0)));
+    vec3 bitangent = cross(axis, tangent);
 
-    // Jeśli aktualna głębokość jest większa niż zapisana w mapie + bias, piksel jest w cieniu
-    return projCoords.z > closestDepth + dynamicBias ? 1.0 : 0.0;
+    // Losowy obrót dysku dla każdego piksela zamienia regularne pasy na mniej widoczny szum
+    float angle = 6.2831853 * fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5453);
+    mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    float resolution = useShadowAtlas ? lights[light].shadowTiles[0].z * float(textureSize(shadowAtlas, 0).x) : float(textureSize(pointShadowMaps, 0).x);
+    float texelSize = 2.0 * pcfRadius / resolution;
+
+    int samples = min(pcfSamples, 16);
+    float lit = 0.0;
+    for (int i = 0; i < samples; ++i) {
+        vec2 offset = rotation * poissonDisk[i] * texelSize;
+        vec3 direction = axis + tangent * offset.x + bitangent * offset.y;
+        lit += sampleShadow(light, direction, reference);
+    }
+    return 1.0 - lit / float(samples);
+}
+
+/**
+ * @brief Wybiera kaskadę na podstawie głębokości fragmentu w przestrzeni widoku.
+ *
+ * @param viewDepth Odległość fragmentu od kamery wzdłuż kierunku patrzenia.
+ * @return Indeks kaskady lub -1, jeśli fragment leży poza zasięgiem cieni.
+ */
+int selectCascade(float viewDepth) {
+    for (int i = 0; i < numCascades; ++i) {
+        if (viewDepth < cascadeSplits[i])
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Oblicza wartość cienia światła kierunkowego z kaskadowej mapy cieni.
+ *
+ * @param cascade Indeks kaskady.
+ * @param normal Wektor normalny powierzchni.
+ * @param lightDir Kierunek do źródła światła.
+ * @return Wartość cienia (1.0 = całkowicie zacienione, 0.0 = bez cienia).
+ */
+float CascadeShadowCalculation(int cascade, vec3 normal, vec3 lightDir) {
+    if (cascade < 0)
+        return 0.0;
+
+    vec4 fragPosLight = cascadeMatrices[cascade] * vec4(FragPos, 1.0);
+    vec3 projCoords = fragPosLight.xyz / fragPosLight.w * 0.5 + 0.5;
+    if (projCoords.z > 1.0)
+        return 0.0;
+
+    float reference = projCoords.z - computeBias(normal, lightDir);
+    if (pcfSamples <= 1)
+        return 1.0 - texture(cascadeShadowMap, vec4(projCoords.xy, cascade, reference));
+
+    float angle = 6.2831853 * fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5453);
+    mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    vec2 texelSize = pcfRadius / vec2(textureSize(cascadeShadowMap, 0).xy);
+
+    int samples = min(pcfSamples, 16);
+    float lit = 0.0;
+    for (int i = 0; i < samples; ++i) {
+        vec2 offset = rotation * poissonDisk[i] * texelSize;
+        lit += texture(cascadeShadowMap, vec4(projCoords.xy + offset, cascade, reference));
+    }
+    return 1.0 - lit / float(samples);
 }
 
 /**
@@ -112,7 +334,12 @@ void main() {
     for (int i = 0; i < numLights; ++i) {
         vec3 lightDir = normalize(lights[i].position - FragPos); // Kierunek do światła
         float distance = length(lights[i].position - FragPos); // Odległość od światła
-        float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.02 * (distance * distance)); // Współczynnik osłabienia
+
+        // Poza promieniem wpływu wkład światła jest poniżej progu
+        if (distance > lights[i].radius && debugMode != i+1)
+            continue;
+
+        float attenuation = 1.0 / (1.0 + attenuationLinear * distance + attenuationQuadratic * (distance * distance)); // Współczynnik osłabienia
 
         // Składowa ambient (otoczenia)
         vec3 ambient = 0.2 * lights[i].color * color;
@@ -127,7 +354,7 @@ void main() {
         vec3 specular = vec3(0.3) * spec * lights[i].color;
 
         // Obliczenie wartości cienia
-        float shadow = ShadowCalculation(FragPosLightSpace[i], lights[i].shadowMap, normal, lightDir);
+        float shadow = ShadowCalculation(i, normal, lightDir);
         shadow = clamp(shadow, 0.0, 1.0); // Ograniczenie wartości do przedziału [0,1]
 
         // Tryb debugowania: jeśli wybrano konkretne światło, zwróć wartość cienia
@@ -140,6 +367,28 @@ void main() {
         result += (ambient + (1.0 - shadow * shadowStrength) * (diffuse + specular)) * attenuation;
     }
 
+    // Światło kierunkowe - bez osłabienia, cień z kaskadowej mapy cieni
+    if (sunEnabled) {
+        vec3 lightDir = normalize(-sunDirection);
+        int cascade = selectCascade(-(view * vec4(FragPos, 1.0)).z);
+
+        if (debugMode == DEBUG_CASCADES) {
+            const vec3 cascadeColors[4] = vec3[](vec3(1.0, 0.3, 0.3), vec3(0.3, 1.0, 0.3), vec3(0.3, 0.3, 1.0), vec3(1.0, 1.0, 0.3));
+            FragColor = vec4(cascade < 0 ? color : color * cascadeColors[cascade], 1.0);
+            return;
+        }
+
+        vec3 ambient = 0.2 * sunColor * color;
+        float diff = max(dot(normal, lightDir), 0.0);
+        vec3 diffuse = diff * sunColor * color;
+        vec3 halfwayDir = normalize(lightDir + viewDir);
+        float spec = pow(max(dot(normal, halfwayDir), 0.0), 16.0);
+        vec3 specular = vec3(0.3) * spec * sunColor;
+
+        float shadow = clamp(CascadeShadowCalculation(cascade, normal, lightDir), 0.0, 1.0);
+        result += ambient + (1.0 - shadow) * (diffuse + specular);
+    }
+
     // Ustawienie koloru piksela
     FragColor = vec4(result, 1.0);
 }
@@ -0,0 +1,58 @@
+#version 430 core
+
+/**
+ * @brief Grupa robocza 8x8 tekseli poziomu docelowego.
+ */
+layout (local_size_x = 8, local_size_y = 8) in;
+
+/**
+ * @brief Poziom piramidy, z którego odczytywana jest głębokość (poziom docelowy - 1).
+ */
+layout (r32f, binding = 0) uniform readonly image2D sourceLevel;
+
+/**
+ * @brief Poziom piramidy, do którego zapisywana jest największa głębokość.
+ */
+layout (r32f, binding = 1) uniform writeonly image2D targetLevel;
+
+/**
+ * @brief Bufor głębokości zakończonej klatki (używany tylko przy budowie poziomu 0).
+ */
+uniform sampler2D depthTexture;
+
+/**
+ * @brief Czy budowany jest poziom 0 (kopia bufora głębokości).
+ */
+uniform bool copyDepth;
+
+/**
+ * @brief Rozmiar wypełnionego fragmentu bufora głębokości (rozdzielczość dynamiczna).
+ */
+uniform ivec2 renderSize;
+
+void main() {
+    ivec2 target = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 targetSize = imageSize(targetLevel);
+    if (any(greaterThanEqual(target, targetSize)))
+        return;
+
+    if (copyDepth) {
+        float depth = all(lessThan(target, renderSize)) ? texelFetch(depthTexture, target, 0).r : 1.0;
+        imageStore(targetLevel, target, vec4(depth));
+        return;
+    }
+
+    ivec2 sourceSize = imageSize(sourceLevel);
+    ivec2 source = target * 2;
+
+    // Przy nieparzystym wymiarze poziomu niższego ostatni teksel obejmuje też trzecią kolumnę/wiersz
+    ivec2 extent = ivec2(2) + ivec2(equal(target, targetSize - 1)) * (sourceSize & 1);
+
+    float depth = 0.0;
+    for (int y = 0; y < extent.y; ++y) {
+        for (int x = 0; x < extent.x; ++x) {
+            depth = max(depth, imageLoad(sourceLevel, min(source + ivec2(x, y), sourceSize - 1)).r);
+        }
+    }
+    imageStore(targetLevel, target, vec4(depth));
+}
@@ -0,0 +1,135 @@
+#version 430 core
+
+/**
+ * @brief Jedno wywołanie na obiekt.
+ */
+layout (local_size_x = 64) in;
+
+/**
+ * @brief Dane obiektu - prostopadłościan otaczający w przestrzeni świata.
+ */
+struct Bounds {
+    vec4 minCorner;   /**< Najmniejszy narożnik (w = 1). */
+    vec4 maxCorner;   /**< Największy narożnik (w = 1). */
+};
+
+/**
+ * @brief Polecenie rysowania pośredniego (układ zgodny z glDrawElementsIndirect).
+ */
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer ObjectBuffer {
+    Bounds objects[];
+};
+
+layout (std430, binding = 1) buffer CommandBuffer {
+    DrawCommand commands[];
+};
+
+/**
+ * @brief Liczba obiektów w buforach.
+ */
+uniform uint objectCount;
+
+/**
+ * @brief Macierz rzutu i widoku bieżącej klatki (test frustum).
+ */
+uniform mat4 viewProjection;
+
+/**
+ * @brief Macierz rzutu i widoku klatki, z której zbudowano piramidę Hi-Z.
+ */
+uniform mat4 previousViewProjection;
+
+/**
+ * @brief Piramida Hi-Z - największa głębokość w każdym tekselu każdego poziomu.
+ */
+uniform sampler2D hiZ;
+
+/**
+ * @brief Część tekstury piramidy wypełniona w poprzedniej klatce (rozdzielczość dynamiczna).
+ */
+uniform vec2 hiZScale;
+
+/**
+ * @brief Liczba poziomów piramidy.
+ */
+uniform int hiZLevels;
+
+/**
+ * @brief Czy wykonywany jest test zasłonięcia (false = tylko test frustum).
+ */
+uniform bool testOcclusion;
+
+/**
+ * @brief Zwraca i-ty narożnik prostopadłościanu.
+ */
+vec4 corner(Bounds box, int i) {
+    return vec4((i & 1) != 0 ? box.maxCorner.x : box.minCorner.x,
+                (i & 2) != 0 ? box.maxCorner.y : box.minCorner.y,
+                (i & 4) != 0 ? box.maxCorner.z : box.minCorner.z,
+                1.0);
+}
+
+/**
+ * @brief Sprawdza, czy wszystkie narożniki leżą poza jedną z płaszczyzn frustum.
+ */
+bool outsideFrustum(Bounds box) {
+    vec3 below = vec3(0.0);
+    vec3 above = vec3(0.0);
+    for (int i = 0; i < 8; ++i) {
+        vec4 clip = viewProjection * corner(box, i);
+        below += vec3(lessThan(clip.xyz, vec3(-clip.w)));
+        above += vec3(greaterThan(clip.xyz, vec3(clip.w)));
+    }
+    return any(equal(below, vec3(8.0))) || any(equal(above, vec3(8.0)));
+}
+
+/**
+ * @brief Sprawdza, czy obiekt w całości leży za głębokością zapisaną w piramidzie Hi-Z.
+ */
+bool occluded(Bounds box) {
+    vec3 ndcMin = vec3(1.0);
+    vec3 ndcMax = vec3(-1.0);
+    for (int i = 0; i < 8; ++i) {
+        vec4 clip = previousViewProjection * corner(box, i);
+        // Obiekt przecinający płaszczyznę bliską nie może zostać bezpiecznie odrzucony
+        if (clip.w <= 0.0)
+            return false;
+        vec3 ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc);
+        ndcMax = max(ndcMax, ndc);
+    }
+
+    vec2 uvMin = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0) * hiZScale;
+    vec2 uvMax = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0) * hiZScale;
+    float nearestDepth = ndcMin.z * 0.5 + 0.5;
+
+    // Poziom, na którym prostokąt obiektu obejmuje najwyżej 2x2 teksele
+    vec2 extent = (uvMax - uvMin) * vec2(textureSize(hiZ, 0));
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, hiZLevels - 1);
+
+    ivec2 levelSize = textureSize(hiZ, level);
+    ivec2 texelMin = clamp(ivec2(uvMin * vec2(levelSize)), ivec2(0), levelSize - 1);
+    ivec2 texelMax = clamp(ivec2(uvMax * vec2(levelSize)), ivec2(0), levelSize - 1);
+
+    float farthest = max(max(texelFetch(hiZ, texelMin, level).r, texelFetch(hiZ, ivec2(texelMax.x, texelMin.y), level).r),
+                         max(texelFetch(hiZ, ivec2(texelMin.x, texelMax.y), level).r, texelFetch(hiZ, texelMax, level).r));
+    return nearestDepth > farthest;
+}
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= objectCount)
+        return;
+
+    Bounds box = objects[index];
+    bool visible = !outsideFrustum(box) && !(testOcclusion && occluded(box));
+    commands[index].instanceCount = visible ? 1u : 0u;
+}
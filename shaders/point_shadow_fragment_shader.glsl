@@ -0,0 +1,25 @@
+#version 430 core
+
+/**
+ * @brief Pozycja fragmentu w przestrzeni świata.
+ */
+in vec4 FragPos;
+
+/**
+ * @brief Pozycja światła w przestrzeni świata.
+ */
+uniform vec3 lightPos;
+
+/**
+ * @brief Zasięg mapy cieni światła.
+ */
+uniform float farPlane;
+
+/**
+ * @brief Główna funkcja fragment shadera.
+ *
+ * Zapisuje liniową odległość od światła znormalizowaną do przedziału [0,1].
+ */
+void main() {
+    gl_FragDepth = length(FragPos.xyz - lightPos) / farPlane;
+}
@@ -0,0 +1,66 @@
+#version 430 core
+
+/**
+ * @brief Jedno wywołanie shadera na każdą ze ścian mapy sześciennej.
+ */
+layout (triangles, invocations = 6) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+/**
+ * @brief Macierze (rzut * widok) sześciu ścian mapy sześciennej światła.
+ */
+uniform mat4 shadowMatrices[6];
+
+/**
+ * @brief Indeks światła - wybiera grupę sześciu warstw w tablicy map sześciennych.
+ */
+uniform int lightIndex;
+
+/**
+ * @brief Maska ścian, w których frustum leży rysowany obiekt (wyznaczana na CPU).
+ */
+uniform int faceMask = 63;
+
+/**
+ * @brief Czy ściany kierowane są do kafelków atlasu (gl_ViewportIndex) zamiast do warstw (gl_Layer).
+ */
+uniform bool useViewportArray = false;
+
+/**
+ * @brief Pozycja wierzchołka w przestrzeni świata.
+ */
+out vec4 FragPos;
+
+/**
+ * @brief Główna funkcja geometry shadera.
+ *
+ * Rzutuje trójkąt na ścianę wybraną przez gl_InvocationID i kieruje go do odpowiedniej warstwy
+ * tablicy map sześciennych albo do viewportu ustawionego na kafelek atlasu cieni.
+ * Ściany spoza maski oraz trójkąty leżące w całości poza frustum ściany są pomijane.
+ */
+void main() {
+    int face = gl_InvocationID;
+    if ((faceMask & (1 << face)) == 0)
+        return;
+
+    vec4 clipPos[3];
+    for (int i = 0; i < 3; ++i)
+        clipPos[i] = shadowMatrices[face] * gl_in[i].gl_Position;
+
+    // Odrzucenie trójkąta, gdy wszystkie wierzchołki leżą po zewnętrznej stronie tej samej płaszczyzny
+    for (int axis = 0; axis < 3; ++axis) {
+        if (clipPos[0][axis] > clipPos[0].w && clipPos[1][axis] > clipPos[1].w && clipPos[2][axis] > clipPos[2].w)
+            return;
+        if (clipPos[0][axis] < -clipPos[0].w && clipPos[1][axis] < -clipPos[1].w && clipPos[2][axis] < -clipPos[2].w)
+            return;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        FragPos = gl_in[i].gl_Position;
+        gl_Position = clipPos[i];
+        gl_Layer = lightIndex * 6 + face;
+        gl_ViewportIndex = useViewportArray ? face : 0;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
@@ -0,0 +1,20 @@
+#version 430 core
+
+/**
+ * @brief Pozycja wierzchołka w przestrzeni lokalnej.
+ */
+layout (location = 0) in vec3 aPos;
+
+/**
+ * @brief Macierz modelu, transformująca wierzchołek do przestrzeni świata.
+ */
+uniform mat4 model;
+
+/**
+ * @brief Główna funkcja vertex shadera.
+ *
+ * Przekazuje pozycję w przestrzeni świata - rzut na ściany mapy sześciennej wykonuje geometry shader.
+ */
+void main() {
+    gl_Position = model * vec4(aPos, 1.0);
+}
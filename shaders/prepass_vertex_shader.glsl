@@ -0,0 +1,37 @@
+#version 430 core
+
+/**
+ * @brief Pozycja wierzchołka w przestrzeni lokalnej.
+ */
+layout (location = 0) in vec3 aPos;
+
+/**
+ * @brief Macierz modelu, transformująca wierzchołek do przestrzeni świata.
+ */
+uniform mat4 model;
+
+/**
+ * @brief Macierz widoku, określająca pozycję i orientację kamery.
+ */
+uniform mat4 view;
+
+/**
+ * @brief Macierz projekcji kamery.
+ */
+uniform mat4 projection;
+
+/**
+ * @brief Pozycja musi być liczona bit w bit tak samo jak w vertex_shader.glsl,
+ * inaczej test GL_EQUAL w przebiegu koloru odrzuci poprawne fragmenty.
+ */
+invariant gl_Position;
+
+/**
+ * @brief Główna funkcja vertex shadera przebiegu wstępnego głębokości.
+ *
+ * Zapisuje wyłącznie głębokość - kolor i oświetlenie liczone są w kolejnym przebiegu.
+ */
+void main() {
+    vec3 fragPos = vec3(model * vec4(aPos, 1.0));
+    gl_Position = projection * view * vec4(fragPos, 1.0);
+}
@@ -30,18 +30,6 @@ uniform mat4 view;
  */
 uniform mat4 projection;
 
-/**
- * @brief Macierze przestrzeni światła dla maksymalnie 10 źródeł światła.
- * 
- * Służą do transformacji pozycji fragmentu do przestrzeni światła, co jest używane do obliczania cieni.
- */
-uniform mat4 lightSpaceMatrix[10];
-
-/**
- * @brief Liczba aktywnych źródeł światła.
- */
-uniform int numLights;
-
 /**
  * @brief Pozycja fragmentu w przestrzeni świata.
  */
@@ -58,9 +46,9 @@ out vec3 Normal;
 out vec2 TexCoord;
 
 /**
- * @brief Pozycja fragmentu w przestrzeni światła dla każdego źródła światła.
+ * @brief Pozycja niezmiennicza względem prepass_vertex_shader.glsl (wymagane przez test GL_EQUAL).
  */
-out vec4 FragPosLightSpace[10];
+invariant gl_Position;
 
 /**
  * @brief Główna funkcja vertex shadera.
@@ -75,11 +63,6 @@ void main() {
     // Przekazanie współrzędnych tekstury
     TexCoord = aTexCoord;
 
-    // Transformacja pozycji fragmentu do przestrzeni światła dla każdego źródła światła
-    for (int i = 0; i < numLights; ++i) {
-        FragPosLightSpace[i] = lightSpaceMatrix[i] * vec4(FragPos, 1.0);
-    }
-
     // Transformacja pozycji wierzchołka do przestrzeni NDC
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
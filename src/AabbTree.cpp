@@ -0,0 +1,250 @@
+#include "AabbTree.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+float surfaceArea(const BoundingBox& box) {
+    glm::vec3 size = box.max - box.min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+BoundingBox merge(const BoundingBox& a, const BoundingBox& b) {
+    BoundingBox box;
+    box.min = glm::min(a.min, b.min);
+    box.max = glm::max(a.max, b.max);
+    return box;
+}
+
+bool contains(const BoundingBox& outer, const BoundingBox& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+        && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+}
+
+AabbTree::AabbTree(float margin) : margin(margin) {
+}
+
+AabbTree::Proxy AabbTree::createProxy(const BoundingBox& box, uint32_t userData) {
+    Proxy proxy = allocateNode();
+    nodes[proxy].box.min = box.min - margin;
+    nodes[proxy].box.max = box.max + margin;
+    nodes[proxy].userData = userData;
+    nodes[proxy].height = 0;
+    insertLeaf(proxy);
+    proxyCount++;
+    return proxy;
+}
+
+void AabbTree::destroyProxy(Proxy proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool AabbTree::moveProxy(Proxy proxy, const BoundingBox& box) {
+    if (contains(nodes[proxy].box, box)) {
+        return false;
+    }
+    removeLeaf(proxy);
+    nodes[proxy].box.min = box.min - margin;
+    nodes[proxy].box.max = box.max + margin;
+    insertLeaf(proxy);
+    return true;
+}
+
+uint32_t AabbTree::getUserData(Proxy proxy) const {
+    return nodes[proxy].userData;
+}
+
+int AabbTree::getHeight() const {
+    return root == NULL_NODE ? 0 : nodes[root].height;
+}
+
+size_t AabbTree::getProxyCount() const {
+    return proxyCount;
+}
+
+size_t AabbTree::getVisitedCount() const {
+    return visitedCount;
+}
+
+float AabbTree::rayEntry(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance) {
+    // Składowe kierunku równe 0 dają nieskończoności, które test płyt obsługuje poprawnie
+    glm::vec3 t1 = (box.min - origin) * inverseDirection;
+    glm::vec3 t2 = (box.max - origin) * inverseDirection;
+    glm::vec3 nearest = glm::min(t1, t2);
+    glm::vec3 farthest = glm::max(t1, t2);
+    float enter = std::max(std::max(nearest.x, nearest.y), std::max(nearest.z, 0.0f));
+    float exit = std::min(std::min(farthest.x, farthest.y), std::min(farthest.z, maxDistance));
+    return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+}
+
+AabbTree::Proxy AabbTree::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        return static_cast<Proxy>(nodes.size() - 1);
+    }
+    Proxy node = freeList;
+    freeList = nodes[node].parent;
+    nodes[node] = Node();
+    return node;
+}
+
+void AabbTree::freeNode(Proxy node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+void AabbTree::insertLeaf(Proxy leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // Zejście do rodzeństwa, przy którym przyrost pól powierzchni przodków jest najmniejszy
+    // Kopia, bo allocateNode może przenieść tablicę węzłów
+    BoundingBox leafBox = nodes[leaf].box;
+    Proxy index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        float area = surfaceArea(node.box);
+        float combinedArea = surfaceArea(merge(node.box, leafBox));
+
+        // Koszt nowego rodzica w tym miejscu i przyrost kosztu przodków przy zejściu niżej
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](Proxy child) {
+            const Node& childNode = nodes[child];
+            float merged = surfaceArea(merge(childNode.box, leafBox));
+            return childNode.isLeaf() ? merged + inheritanceCost : merged - surfaceArea(childNode.box) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    Proxy sibling = index;
+    Proxy oldParent = nodes[sibling].parent;
+    Proxy newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = merge(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    }
+    else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    }
+    else {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(nodes[leaf].parent);
+}
+
+void AabbTree::removeLeaf(Proxy leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    // Rodzic liścia znika, a jego miejsce zajmuje rodzeństwo
+    Proxy parent = nodes[leaf].parent;
+    Proxy grandParent = nodes[parent].parent;
+    Proxy sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    }
+    else {
+        nodes[grandParent].child2 = sibling;
+    }
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    refitAncestors(grandParent);
+}
+
+void AabbTree::refitAncestors(Proxy node) {
+    while (node != NULL_NODE) {
+        node = balance(node);
+
+        Node& current = nodes[node];
+        current.height = 1 + std::max(nodes[current.child1].height, nodes[current.child2].height);
+        current.box = merge(nodes[current.child1].box, nodes[current.child2].box);
+
+        node = current.parent;
+    }
+}
+
+AabbTree::Proxy AabbTree::balance(Proxy a) {
+    if (nodes[a].isLeaf() || nodes[a].height < 2) {
+        return a;
+    }
+
+    Proxy b = nodes[a].child1;
+    Proxy c = nodes[a].child2;
+    int difference = nodes[c].height - nodes[b].height;
+    if (difference >= -1 && difference <= 1) {
+        return a;
+    }
+
+    // Wyższe dziecko (up) zajmuje miejsce A; A przejmuje niższego wnuka, up - wyższego
+    Proxy up = difference > 1 ? c : b;
+    Proxy other = difference > 1 ? b : c;
+    Proxy f = nodes[up].child1;
+    Proxy g = nodes[up].child2;
+
+    nodes[up].child1 = a;
+    nodes[up].parent = nodes[a].parent;
+    nodes[a].parent = up;
+
+    if (nodes[up].parent == NULL_NODE) {
+        root = up;
+    }
+    else if (nodes[nodes[up].parent].child1 == a) {
+        nodes[nodes[up].parent].child1 = up;
+    }
+    else {
+        nodes[nodes[up].parent].child2 = up;
+    }
+
+    Proxy taller = nodes[f].height > nodes[g].height ? f : g;
+    Proxy shorter = taller == f ? g : f;
+    nodes[up].child2 = taller;
+    if (difference > 1) {
+        nodes[a].child2 = shorter;
+    }
+    else {
+        nodes[a].child1 = shorter;
+    }
+    nodes[shorter].parent = a;
+
+    nodes[a].box = merge(nodes[other].box, nodes[shorter].box);
+    nodes[a].height = 1 + std::max(nodes[other].height, nodes[shorter].height);
+    nodes[up].box = merge(nodes[a].box, nodes[taller].box);
+    nodes[up].height = 1 + std::max(nodes[a].height, nodes[taller].height);
+    return up;
+}
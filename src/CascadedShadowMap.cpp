@@ -0,0 +1,124 @@
+#include "CascadedShadowMap.h"
+
+CascadedShadowMap::CascadedShadowMap(int resolution, int cascadeCount, float splitLambda)
+    : resolution(resolution), cascadeCount(glm::clamp(cascadeCount, 1, MAX_CASCADES)), splitLambda(splitLambda) {
+    matrices.resize(this->cascadeCount, glm::mat4(1.0f));
+    splits.resize(this->cascadeCount, 0.0f);
+
+    glGenTextures(1, &depthArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, this->cascadeCount, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+CascadedShadowMap::~CascadedShadowMap() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &depthArray);
+}
+
+void CascadedShadowMap::update(const Observer& observer, float aspect, const glm::vec3& lightDirection) {
+    float nearPlane = observer.getNearPlane();
+    float farPlane = glm::min(observer.getFarPlane(), shadowDistance);
+
+    glm::vec3 direction = glm::normalize(lightDirection);
+    glm::vec3 up = glm::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    // Stała orientacja widoku światła - od pozycji kamery zależy tylko przesunięcie rzutu
+    glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+    glm::mat4 inverseView = glm::inverse(observer.getViewMatrix());
+
+    float previousSplit = nearPlane;
+    for (int i = 0; i < cascadeCount; i++) {
+        // Praktyczny schemat podziału: mieszanka podziału logarytmicznego i równomiernego
+        float p = static_cast<float>(i + 1) / cascadeCount;
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, p);
+        float uniformSplit = nearPlane + (farPlane - nearPlane) * p;
+        float split = splitLambda * logSplit + (1.0f - splitLambda) * uniformSplit;
+
+        glm::mat4 sliceProjection = glm::perspective(glm::radians(observer.getFov()), aspect, previousSplit, split);
+        glm::mat4 toWorld = inverseView * glm::inverse(sliceProjection);
+
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        int c = 0;
+        for (int x = -1; x <= 1; x += 2) {
+            for (int y = -1; y <= 1; y += 2) {
+                for (int z = -1; z <= 1; z += 2) {
+                    glm::vec4 corner = toWorld * glm::vec4(x, y, z, 1.0f);
+                    corners[c] = glm::vec3(corner) / corner.w;
+                    center += corners[c];
+                    c++;
+                }
+            }
+        }
+        center /= 8.0f;
+
+        // Sfera opisana na wycinku ma stały rozmiar niezależnie od obrotu kamery
+        float radius = 0.0f;
+        for (const glm::vec3& corner : corners) {
+            radius = glm::max(radius, glm::length(corner - center));
+        }
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // Przyciągnięcie środka do siatki tekseli usuwa migotanie krawędzi cieni
+        float texelSize = 2.0f * radius / resolution;
+        glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+        lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+        glm::mat4 lightProjection = glm::ortho(
+            lightCenter.x - radius, lightCenter.x + radius,
+            lightCenter.y - radius, lightCenter.y + radius,
+            -lightCenter.z - radius - casterMargin, -lightCenter.z + radius);
+
+        matrices[i] = lightProjection * lightView;
+        splits[i] = split;
+        previousSplit = split;
+    }
+}
+
+void CascadedShadowMap::bindForWriting(int cascade) const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, cascade);
+    glViewport(0, 0, resolution, resolution);
+}
+
+GLuint CascadedShadowMap::getTexture() const {
+    return depthArray;
+}
+
+int CascadedShadowMap::getCascadeCount() const {
+    return cascadeCount;
+}
+
+int CascadedShadowMap::getResolution() const {
+    return resolution;
+}
+
+const std::vector<glm::mat4>& CascadedShadowMap::getMatrices() const {
+    return matrices;
+}
+
+const std::vector<float>& CascadedShadowMap::getSplits() const {
+    return splits;
+}
+
+void CascadedShadowMap::setShadowDistance(float distance) {
+    shadowDistance = distance;
+}
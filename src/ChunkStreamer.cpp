@@ -0,0 +1,205 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+ChunkStreamer::ChunkStreamer(const std::string& directory, float loadRadius, float unloadRadius, size_t memoryBudget, size_t bytesPerObject, unsigned int threadCount)
+    : loadRadius(loadRadius), unloadRadius(std::max(unloadRadius, loadRadius)), memoryBudget(memoryBudget) {
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = file.path().filename().string();
+        int x = 0, z = 0, length = 0;
+        if (std::sscanf(name.c_str(), "chunk_%d_%d.scene%n", &x, &z, &length) != 2 || length != static_cast<int>(name.size())) {
+            continue;
+        }
+        // Koszt szacowany z rozmiaru pliku, żeby budżet działał bez otwierania fragmentów
+        Entry entry;
+        entry.cell = glm::ivec2(x, z);
+        entry.path = file.path().string();
+        entry.bytes = static_cast<size_t>(file.file_size(error)) / sizeof(SceneObject) * bytesPerObject;
+        chunks.push_back(std::move(entry));
+    }
+    std::sort(chunks.begin(), chunks.end(), [](const Entry& a, const Entry& b) {
+        return a.cell.y != b.cell.y ? a.cell.y < b.cell.y : a.cell.x < b.cell.x;
+    });
+
+    for (unsigned int i = 0; i < std::max(1u, threadCount); i++) {
+        threads.emplace_back(&ChunkStreamer::ioLoop, this);
+    }
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeUp.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ChunkStreamer::ioLoop() {
+    while (true) {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this]() { return !running || !requests.empty(); });
+            if (!running) {
+                return;
+            }
+            chunk = requests.back();
+            requests.pop_back();
+            chunks[chunk].state = State::Loading;
+        }
+
+        // Rekordy kopiowane są z mapowania na tym wątku, więc błędy stron nie trafiają do klatki
+        Result result{ chunk, {}, {} };
+        SceneFile file;
+        if (file.open(chunks[chunk].path)) {
+            const SceneFileHeader& header = file.getHeader();
+            result.objects.assign(file.getObjects(), file.getObjects() + header.objectCount);
+            result.materials.assign(file.getMaterials(), file.getMaterials() + header.materialCount);
+            // Obiekty z jednym materiałem przychodzą po kolei, więc silnik scala je w jedną paczkę
+            std::stable_sort(result.objects.begin(), result.objects.end(), [](const SceneObject& a, const SceneObject& b) {
+                return a.material < b.material;
+            });
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(std::move(result));
+    }
+}
+
+void ChunkStreamer::update(const glm::vec3& position) {
+    std::vector<Result> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(results);
+    }
+    for (Result& result : finished) {
+        Entry& entry = chunks[result.chunk];
+        entry.objects = std::move(result.objects);
+        entry.materials = std::move(result.materials);
+        entry.uploaded = 0;
+        entry.state = State::Loaded;
+        uploads.push_back(result.chunk);
+    }
+
+    glm::vec2 point(position.x, position.z);
+    for (Entry& entry : chunks) {
+        glm::vec2 min = glm::vec2(entry.cell) * WORLD_CHUNK_SIZE;
+        glm::vec2 closest = glm::clamp(point, min, min + WORLD_CHUNK_SIZE);
+        entry.distance = glm::length(point - closest);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Oczekujące żądania układane są od nowa - pozycja obserwatora mogła zmienić ich kolejność
+    requests.clear();
+    usedBytes = 0;
+    residentCount = 0;
+    pendingCount = 0;
+    std::vector<Chunk> candidates, evictable;
+    for (Chunk chunk = 0; chunk < chunks.size(); chunk++) {
+        Entry& entry = chunks[chunk];
+        switch (entry.state) {
+        case State::Queued:
+            entry.state = State::Unloaded;
+            [[fallthrough]];
+        case State::Unloaded:
+            if (entry.distance <= loadRadius) {
+                candidates.push_back(chunk);
+            }
+            break;
+        case State::Loading:
+            usedBytes += entry.bytes;
+            pendingCount++;
+            break;
+        case State::Loaded:
+        case State::Resident:
+            if (entry.distance > unloadRadius) {
+                release(chunk);
+                break;
+            }
+            usedBytes += entry.bytes;
+            residentCount++;
+            evictable.push_back(chunk);
+            break;
+        }
+    }
+
+    auto nearer = [this](Chunk a, Chunk b) { return chunks[a].distance < chunks[b].distance; };
+    std::sort(candidates.begin(), candidates.end(), nearer);
+    std::sort(evictable.begin(), evictable.end(), [&nearer](Chunk a, Chunk b) { return nearer(b, a); });
+
+    // Fragmenty wybierane są od najbliższego; dla bliższego zwalniane są tylko fragmenty dalsze od niego
+    size_t evicted = 0;
+    for (Chunk chunk : candidates) {
+        Entry& entry = chunks[chunk];
+        while (usedBytes + entry.bytes > memoryBudget && evicted < evictable.size() && chunks[evictable[evicted]].distance > entry.distance) {
+            usedBytes -= chunks[evictable[evicted]].bytes;
+            residentCount--;
+            release(evictable[evicted++]);
+        }
+        if (usedBytes + entry.bytes > memoryBudget) {
+            break;
+        }
+        entry.state = State::Queued;
+        usedBytes += entry.bytes;
+        pendingCount++;
+        requests.push_back(chunk);
+    }
+    // Wątki zdejmują żądania z końca, więc najbliższy fragment musi być ostatni
+    std::reverse(requests.begin(), requests.end());
+    std::sort(uploads.begin(), uploads.end(), nearer);
+
+    if (!requests.empty()) {
+        wakeUp.notify_all();
+    }
+}
+
+void ChunkStreamer::release(Chunk chunk) {
+    Entry& entry = chunks[chunk];
+    if (entry.state == State::Loaded) {
+        uploads.erase(std::find(uploads.begin(), uploads.end(), chunk));
+    }
+    std::vector<SceneObject>().swap(entry.objects);
+    std::vector<SceneMaterial>().swap(entry.materials);
+    entry.uploaded = 0;
+    entry.state = State::Unloaded;
+    unloads.push_back(chunk);
+}
+
+size_t ChunkStreamer::getChunkCount() const {
+    return chunks.size();
+}
+
+size_t ChunkStreamer::getResidentCount() const {
+    return residentCount;
+}
+
+size_t ChunkStreamer::getPendingCount() const {
+    return pendingCount;
+}
+
+size_t ChunkStreamer::getUsedBytes() const {
+    return usedBytes;
+}
+
+size_t ChunkStreamer::getUploadBacklog() const {
+    size_t backlog = 0;
+    for (Chunk chunk : uploads) {
+        backlog += chunks[chunk].objects.size() - chunks[chunk].uploaded;
+    }
+    return backlog;
+}
+
+size_t ChunkStreamer::getObjectCount(Chunk chunk) const {
+    return chunks[chunk].objects.size();
+}
+
+std::string ChunkStreamer::chunkFileName(int x, int z) {
+    return "chunk_" + std::to_string(x) + "_" + std::to_string(z) + ".scene";
+}
@@ -1,87 +1,156 @@
 #include "Cube.h"
 
+#include <algorithm>
+
+namespace {
+
+// Indeksy są wspólne dla wszystkich sześcianów - każdy sześcian ma te same 24 wierzchołki
+const std::vector<unsigned int> CUBE_INDICES = {
+    0, 1, 2,
+    2, 3, 0,
+
+    4, 6, 5,
+    6, 4, 7,
+
+    8, 9, 10,
+    10, 11, 8,
+
+    12, 14, 13,
+    14, 12, 15,
+
+    16, 18, 17,
+    18, 16, 19,
+
+    20, 21, 22,
+    22, 23, 20
+};
+
+// Sześcian o połowie krawędzi 1 w środku układu - pozycja, UV, normalna
+const std::array<float, Cube::VERTEX_COUNT * VERTEX_FLOATS> UNIT_CUBE_VERTICES = {
+    -1.0f, -1.0f,  1.0f,   0.0f, 0.0f,   0.0f,  0.0f,  1.0f,
+     1.0f, -1.0f,  1.0f,   1.0f, 0.0f,   0.0f,  0.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,   1.0f, 1.0f,   0.0f,  0.0f,  1.0f,
+    -1.0f,  1.0f,  1.0f,   0.0f, 1.0f,   0.0f,  0.0f,  1.0f,
+    -1.0f, -1.0f, -1.0f,   0.0f, 0.0f,   0.0f,  0.0f, -1.0f,
+     1.0f, -1.0f, -1.0f,   1.0f, 0.0f,   0.0f,  0.0f, -1.0f,
+     1.0f,  1.0f, -1.0f,   1.0f, 1.0f,   0.0f,  0.0f, -1.0f,
+    -1.0f,  1.0f, -1.0f,   0.0f, 1.0f,   0.0f,  0.0f, -1.0f,
+    -1.0f, -1.0f, -1.0f,   0.0f, 0.0f,  -1.0f,  0.0f,  0.0f,
+    -1.0f, -1.0f,  1.0f,   1.0f, 0.0f,  -1.0f,  0.0f,  0.0f,
+    -1.0f,  1.0f,  1.0f,   1.0f, 1.0f,  -1.0f,  0.0f,  0.0f,
+    -1.0f,  1.0f, -1.0f,   0.0f, 1.0f,  -1.0f,  0.0f,  0.0f,
+     1.0f, -1.0f, -1.0f,   0.0f, 0.0f,   1.0f,  0.0f,  0.0f,
+     1.0f, -1.0f,  1.0f,   1.0f, 0.0f,   1.0f,  0.0f,  0.0f,
+     1.0f,  1.0f,  1.0f,   1.0f, 1.0f,   1.0f,  0.0f,  0.0f,
+     1.0f,  1.0f, -1.0f,   0.0f, 1.0f,   1.0f,  0.0f,  0.0f,
+    -1.0f,  1.0f, -1.0f,   0.0f, 0.0f,   0.0f,  1.0f,  0.0f,
+     1.0f,  1.0f, -1.0f,   1.0f, 0.0f,   0.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  1.0f,   1.0f, 1.0f,   0.0f,  1.0f,  0.0f,
+    -1.0f,  1.0f,  1.0f,   0.0f, 1.0f,   0.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f, -1.0f,   0.0f, 0.0f,   0.0f, -1.0f,  0.0f,
+     1.0f, -1.0f, -1.0f,   1.0f, 0.0f,   0.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  1.0f,   1.0f, 1.0f,   0.0f, -1.0f,  0.0f,
+    -1.0f, -1.0f,  1.0f,   0.0f, 1.0f,   0.0f, -1.0f,  0.0f
+};
+
+// Powyżej tej liczby zwolnione bufory są usuwane zamiast czekać na ponowne użycie
+const size_t MAX_FREE_BUFFERS = 4096;
+
+// Pakowanie do tablicy na stosie - przesłanie wierzchołków nie alokuje pamięci
+std::array<PackedVertex, Cube::VERTEX_COUNT> packVertices(const std::array<float, Cube::VERTEX_COUNT * VERTEX_FLOATS>& vertices) {
+    std::array<PackedVertex, Cube::VERTEX_COUNT> packed;
+    for (size_t i = 0; i < packed.size(); i++) {
+        packed[i] = VertexFormat::pack(&vertices[i * VERTEX_FLOATS]);
+    }
+    return packed;
+}
+
+}
 
-Cube::Cube(float size, float x, float y, float z, GLuint texture) {
-    vertices = {
-        x - size, y - size, z + size,   0.0f, 0.0f,   0.0f,  0.0f,  1.0f,
-        x + size, y - size, z + size,   1.0f, 0.0f,   0.0f,  0.0f,  1.0f,
-        x + size, y + size, z + size,   1.0f, 1.0f,   0.0f,  0.0f,  1.0f,
-        x - size, y + size, z + size,   0.0f, 1.0f,   0.0f,  0.0f,  1.0f,
-        x - size, y - size, z - size,   0.0f, 0.0f,   0.0f,  0.0f, -1.0f,
-        x + size, y - size, z - size,   1.0f, 0.0f,   0.0f,  0.0f, -1.0f,
-        x + size, y + size, z - size,   1.0f, 1.0f,   0.0f,  0.0f, -1.0f,
-        x - size, y + size, z - size,   0.0f, 1.0f,   0.0f,  0.0f, -1.0f,
-        x - size, y - size, z - size,   0.0f, 0.0f,  -1.0f,  0.0f,  0.0f,
-        x - size, y - size, z + size,   1.0f, 0.0f,  -1.0f,  0.0f,  0.0f,
-        x - size, y + size, z + size,   1.0f, 1.0f,  -1.0f,  0.0f,  0.0f,
-        x - size, y + size, z - size,   0.0f, 1.0f,  -1.0f,  0.0f,  0.0f,
-        x + size, y - size, z - size,   0.0f, 0.0f,   1.0f,  0.0f,  0.0f,
-        x + size, y - size, z + size,   1.0f, 0.0f,   1.0f,  0.0f,  0.0f,
-        x + size, y + size, z + size,   1.0f, 1.0f,   1.0f,  0.0f,  0.0f,
-        x + size, y + size, z - size,   0.0f, 1.0f,   1.0f,  0.0f,  0.0f,
-        x - size, y + size, z - size,   0.0f, 0.0f,   0.0f,  1.0f,  0.0f,
-        x + size, y + size, z - size,   1.0f, 0.0f,   0.0f,  1.0f,  0.0f,
-        x + size, y + size, z + size,   1.0f, 1.0f,   0.0f,  1.0f,  0.0f,
-        x - size, y + size, z + size,   0.0f, 1.0f,   0.0f,  1.0f,  0.0f,
-        x - size, y - size, z - size,   0.0f, 0.0f,   0.0f, -1.0f,  0.0f,
-        x + size, y - size, z - size,   1.0f, 0.0f,   0.0f, -1.0f,  0.0f,
-        x + size, y - size, z + size,   1.0f, 1.0f,   0.0f, -1.0f,  0.0f,
-        x - size, y - size, z + size,   0.0f, 1.0f,   0.0f, -1.0f,  0.0f
-    };
-
-    indices = {
-        0, 1, 2,
-        2, 3, 0,
-
-        4, 6, 5,
-        6, 4, 7,
-
-        8, 9, 10,
-        10, 11, 8,
-
-        12, 14, 13,
-        14, 12, 15,
-
-        16, 18, 17,
-        18, 16, 19,
-
-        20, 21, 22,
-        22, 23, 20
-    };
+std::vector<Cube::Buffers> Cube::freeBuffers;
+
+Cube::Cube(float size, float x, float y, float z, GLuint texture) : halfSize(size) {
+    vertices = UNIT_CUBE_VERTICES;
+    for (size_t i = 0; i < vertices.size(); i += 8) {
+        vertices[i] = x + vertices[i] * size;
+        vertices[i + 1] = y + vertices[i + 1] * size;
+        vertices[i + 2] = z + vertices[i + 2] * size;
+    }
 
     for (int i = 0; i < 6; ++i) {
         textures[i] = texture;
     }
 
+    bounds = BoundingBox::fromVertices(vertices, 8);
+
     setupBuffers();
 }
 
+Cube::~Cube() {
+    if (vao == 0) {
+        return;
+    }
+    if (freeBuffers.size() < MAX_FREE_BUFFERS) {
+        freeBuffers.push_back({ vao, vbo, ebo, indexType });
+        return;
+    }
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+}
+
+void Cube::deleteFreeBuffers() {
+    for (const Buffers& buffers : freeBuffers) {
+        glDeleteVertexArrays(1, &buffers.vao);
+        glDeleteBuffers(1, &buffers.vbo);
+        glDeleteBuffers(1, &buffers.ebo);
+    }
+    freeBuffers.clear();
+    freeBuffers.shrink_to_fit();
+}
+
+size_t Cube::getFreeBufferCount() {
+    return freeBuffers.size();
+}
+
 void Cube::setupBuffers() {
-    
+    if (!freeBuffers.empty()) {
+        // VAO zachowuje atrybuty i powiązanie EBO, więc nadpisanie VBO wystarcza
+        Buffers buffers = freeBuffers.back();
+        freeBuffers.pop_back();
+        vao = buffers.vao;
+        vbo = buffers.vbo;
+        ebo = buffers.ebo;
+        indexType = buffers.indexType;
+        verticesDirty = true;
+        return;
+    }
+
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
 
     glBindVertexArray(vao);
 
+    std::array<PackedVertex, VERTEX_COUNT> packed = packVertices(vertices);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    indexType = VertexFormat::uploadIndices(CUBE_INDICES, packed.size(), GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    VertexFormat::setupAttributes();
 
     glBindVertexArray(0);
 }
 
+void Cube::uploadVertices() {
+    std::array<PackedVertex, VERTEX_COUNT> packed = packVertices(vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, packed.size() * sizeof(PackedVertex), packed.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void Cube::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
     glUseProgram(shaderProgram);
 
@@ -89,16 +158,26 @@ void Cube::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& v
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
 
-    for (int side = 0; side < 6; ++side) {
-        if (textures[side] != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, textures[side]);
-            glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-        }
+    if (verticesDirty) {
+        uploadVertices();
+        verticesDirty = false;
     }
 
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
     glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+
+    // Indeksy ułożone są ścianami (po 6), w kolejności indeksów setTextureForSide
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    int first = 0;
+    for (int side = 1; side <= 6; ++side) {
+        if (side < 6 && textures[side] == textures[first]) {
+            continue;
+        }
+        glBindTexture(GL_TEXTURE_2D, textures[first]);
+        glDrawElements(GL_TRIANGLES, (side - first) * 6, indexType, (void*)(first * 6 * indexSize));
+        first = side;
+    }
     glBindVertexArray(0);
 
     glUseProgram(0);
@@ -119,9 +198,9 @@ void Cube::translate(const glm::vec3& direction) {
         vertices[i + 2] += direction.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+    verticesDirty = true;
 }
 
 void Cube::rotate(float angle, const glm::vec3& axis) {
@@ -140,9 +219,38 @@ void Cube::rotate(float angle, const glm::vec3& axis) {
         vertices[i + 7] = normal.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+    verticesDirty = true;
+}
+
+void Cube::computeVertices(const glm::vec3& center, const glm::quat& orientation, float halfSize, float* vertices) {
+    glm::mat3 rotation = glm::mat3_cast(orientation);
+    for (size_t i = 0; i < UNIT_CUBE_VERTICES.size(); i += 8) {
+        glm::vec3 corner = rotation * (halfSize * glm::vec3(UNIT_CUBE_VERTICES[i], UNIT_CUBE_VERTICES[i + 1], UNIT_CUBE_VERTICES[i + 2]));
+        glm::vec3 normal = rotation * glm::vec3(UNIT_CUBE_VERTICES[i + 5], UNIT_CUBE_VERTICES[i + 6], UNIT_CUBE_VERTICES[i + 7]);
+        vertices[i] = center.x + corner.x;
+        vertices[i + 1] = center.y + corner.y;
+        vertices[i + 2] = center.z + corner.z;
+        vertices[i + 3] = UNIT_CUBE_VERTICES[i + 3];
+        vertices[i + 4] = UNIT_CUBE_VERTICES[i + 4];
+        vertices[i + 5] = normal.x;
+        vertices[i + 6] = normal.y;
+        vertices[i + 7] = normal.z;
+    }
+}
+
+const std::vector<unsigned int>& Cube::getCubeIndices() {
+    return CUBE_INDICES;
+}
+
+void Cube::setPose(const glm::vec3& position, const glm::quat& orientation) {
+    // Wierzchołki liczone od wzorca, więc błędy zaokrągleń nie kumulują się między klatkami
+    computeVertices(position, orientation, halfSize, vertices.data());
+
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+    verticesDirty = true;
 }
 
 void Cube::rotatePoint(float angle, const glm::vec3& axis, const glm::vec3& point) {
@@ -176,9 +284,9 @@ void Cube::scale(float sx, float sy) {
         vertices[i + 7] = normal.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+    verticesDirty = true;
 }
 
 void Cube::rotateAround(float angle, const glm::vec3& axis) {
@@ -193,3 +301,26 @@ void Cube::rotateAround(float angle, const glm::vec3& axis) {
     rotatePoint(angle, axis, center);
 }
 
+const BoundingBox& Cube::getBounds() const {
+    return bounds;
+}
+
+std::span<const float> Cube::getVertices() const {
+    return vertices;
+}
+
+const std::vector<unsigned int>& Cube::getIndices() const {
+    return CUBE_INDICES;
+}
+
+GLuint Cube::getTexture() const {
+    return textures[0];
+}
+
+bool Cube::hasSingleTexture() const {
+    return std::all_of(textures.begin(), textures.end(), [this](GLuint texture) { return texture == textures[0]; });
+}
+
+float Cube::getHalfSize() const {
+    return halfSize;
+}
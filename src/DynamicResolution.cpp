@@ -0,0 +1,112 @@
+#include "DynamicResolution.h"
+
+DynamicResolution::DynamicResolution(int width, int height, float targetFrameTime, float minScale)
+    : width(glm::max(width, 1)), height(glm::max(height, 1)), targetFrameTime(targetFrameTime), minScale(minScale) {
+    glGenFramebuffers(1, &fbo);
+    createTextures();
+}
+
+DynamicResolution::~DynamicResolution() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &colorTexture);
+    glDeleteTextures(1, &depthTexture);
+}
+
+void DynamicResolution::createTextures() {
+    glDeleteTextures(1, &colorTexture);
+    glDeleteTextures(1, &depthTexture);
+
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Dynamic resolution framebuffer is incomplete!" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::resize(int newWidth, int newHeight) {
+    newWidth = glm::max(newWidth, 1);
+    newHeight = glm::max(newHeight, 1);
+    if (newWidth == width && newHeight == height) {
+        return;
+    }
+    width = newWidth;
+    height = newHeight;
+    createTextures();
+}
+
+void DynamicResolution::update(double gpuFrameTime) {
+    if (!enabled || gpuFrameTime <= 0.0) {
+        return;
+    }
+
+    // Martwa strefa ±5% - pomiar jest opóźniony o kilka klatek, więc drobne odchyłki ignorujemy
+    float ratio = targetFrameTime / static_cast<float>(gpuFrameTime);
+    if (glm::abs(ratio - 1.0f) < 0.05f) {
+        return;
+    }
+
+    float desired = scale * glm::sqrt(ratio);
+    scale = glm::clamp(scale + (desired - scale) * 0.2f, minScale, 1.0f);
+}
+
+void DynamicResolution::bindForWriting() const {
+    glm::ivec2 size = getRenderSize();
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, size.x, size.y);
+}
+
+void DynamicResolution::resolve() const {
+    glm::ivec2 size = getRenderSize();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, size.x, size.y, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::setEnabled(bool value) {
+    enabled = value;
+    if (!enabled) {
+        scale = 1.0f;
+    }
+}
+
+bool DynamicResolution::isEnabled() const {
+    return enabled;
+}
+
+float DynamicResolution::getScale() const {
+    return scale;
+}
+
+glm::ivec2 DynamicResolution::getRenderSize() const {
+    if (scale >= 1.0f) {
+        return glm::ivec2(width, height);
+    }
+    // Rozmiar zaokrąglony do wielokrotności 8, aby drobne zmiany skali nie zmieniały go co klatkę
+    int renderWidth = glm::max(static_cast<int>(width * scale) & ~7, glm::min(width, 8));
+    int renderHeight = glm::max(static_cast<int>(height * scale) & ~7, glm::min(height, 8));
+    return glm::ivec2(renderWidth, renderHeight);
+}
+
+GLuint DynamicResolution::getDepthTexture() const {
+    return depthTexture;
+}
@@ -1,7 +1,40 @@
 #include "Engine.h"
 
-
-const unsigned int SHADOW_WIDTH = 2048, SHADOW_HEIGHT = 2048;
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+
+const int POINT_SHADOW_RESOLUTION = 512;
+const int MAX_LIGHTS = 10;
+const int SHADOW_TEXTURE_UNIT = 2;
+const int CASCADE_TEXTURE_UNIT = SHADOW_TEXTURE_UNIT + 1;
+const int ATLAS_TEXTURE_UNIT = SHADOW_TEXTURE_UNIT + 2;
+const int SHADOW_ATLAS_SIZE = 4096, SHADOW_TILE_MIN = 64, SHADOW_TILE_MAX = 1024;
+const float ATTENUATION_LINEAR = 0.05f, ATTENUATION_QUADRATIC = 0.02f;
+const int CASCADE_RESOLUTION = 1024, CASCADE_COUNT = 4;
+const float TARGET_FRAME_TIME = 16.0f;
+const GLuint LIGHT_BLOCK_BINDING = 0;
+const char* MODEL_PATH = "models/model.mesh";
+const float LOD_PIXEL_ERROR = 1.0f;
+const int STRESS_GROUPS = 1000, STRESS_GROUP_SIZE = 99;
+const int STORM_SPAWNS_PER_FRAME = 64, STORM_MAX_CUBES = 2000;
+const float PHYSICS_STEP = 1.0f / 60.0f;
+const int MAX_PHYSICS_STEPS = 4;
+const float WALL_HALF_THICKNESS = 0.05f;
+const float CUBE_MASS = 1.0f, THROW_SPEED = 8.0f;
+const float COLLISION_CELL_SIZE = 2.0f, CAMERA_RADIUS = 0.3f;
+const float PICK_DISTANCE = 100.0f;
+const char* SCENE_PATH = "scenes/main.scene";
+const char* WALL_TEXTURE_PATH = "textures/wall.jpg";
+const char* WOOD_TEXTURE_PATH = "textures/wood.jpg";
+const char* WORLD_PATH = "worlds/default";
+const float STREAM_LOAD_RADIUS = 96.0f, STREAM_UNLOAD_RADIUS = 128.0f;
+const size_t STREAM_MEMORY_BUDGET = 256u << 20, STREAM_BYTES_PER_OBJECT = 1024;
+const size_t STREAM_UPLOAD_BYTES_PER_FRAME = 256u << 10;
+const unsigned int STREAM_IO_THREADS = 2;
+const char* CAPTURE_DIRECTORY = "captures";
+const int CAPTURE_FPS = 60;
 
 
 int Engine::windowWidth = 800;
@@ -10,13 +43,54 @@ static bool isMousePressed = false;
 static int lastMouseX = -1;
 static int lastMouseY = -1;
 static int debugmode;
+static bool depthPrepass = true;
+static int pcfSamples = 8;
+static float pcfRadius = 1.5f;
+static bool useShadowAtlas = true;
+static float lightCutoff = 0.02f;
+static bool occlusionCulling = true;
+static bool graphStress = false;
+static bool spawnStorm = false;
+static GLint uniformAlignment = 256;
 Observer* observer = nullptr;
-std::vector<Cube*> cubes;
-std::vector<Wall*> walls;
+World* world = nullptr;
+ObjectPool<Cube>* cubePool = nullptr;
+std::deque<Entity> spawnedCubes;
+PhysicsWorld* physicsWorld = nullptr;
+SpatialHash* spatialHash = nullptr;
+ScenePicker* scenePicker = nullptr;
+ChunkStreamer* chunkStreamer = nullptr;
+std::vector<std::vector<Entity>> chunkEntities;
+std::vector<StaticBatch*> chunkBatches;
+FrameCapture* frameCapture = nullptr;
 Shader* mainShader;
 Shader* depthShader;
-std::vector<Light> lights;
-
+Shader* prepassShader;
+Shader* pointShadowShader;
+Profiler* profiler = nullptr;
+std::vector<Light> visibleLights;
+std::vector<std::vector<ShadowDraw>> shadowQueues;
+JobSystem* jobSystem = nullptr;
+DirectionalLight sun = { glm::vec3(-0.4f, -1.0f, -0.3f), glm::vec3(0.8f, 0.75f, 0.7f), false };
+CascadedShadowMap* cascadedShadowMap = nullptr;
+OmniShadowMap* omniShadowMap = nullptr;
+ShadowAtlas* shadowAtlas = nullptr;
+DynamicResolution* dynamicResolution = nullptr;
+HiZOcclusion* hiZOcclusion = nullptr;
+GpuScene* gpuScene = nullptr;
+StaticBatch* staticBatch = nullptr;
+std::vector<StaticBatch*> staticBatches;
+std::vector<ShapeObject*> sceneObjects;
+StreamBuffer* lightStream = nullptr;
+Model* sceneModel = nullptr;
+glm::mat4 sceneModelTransform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -5.0f, 3.0f));
+BoundingBox sceneModelBounds;
+SceneGraph* sceneGraph = nullptr;
+SceneGraph::Node modelNode = SceneGraph::ROOT;
+SceneGraph::Node lightRigNode = SceneGraph::ROOT;
+SceneGraph::Node stressNode = SceneGraph::ROOT;
+
+std::vector<std::pair<std::string, GLuint>> materials;
 GLuint wallTexture = 0;
 GLuint woodTexture = 0;
 Cube* lightCube = nullptr;
@@ -42,10 +116,11 @@ Engine::Engine(int argc, char** argv, int width, int height, const char* title)
     std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
     initSettings();
 
-    observer = new Observer(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    observer = new Observer(*world, glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    observer->setCollision(spatialHash, CAMERA_RADIUS);
 
-    wallTexture = BitmapHandler::loadBitmapFromFile("textures/wall.jpg");
-    woodTexture = BitmapHandler::loadBitmapFromFile("textures/wood.jpg");
+    wallTexture = loadMaterial(WALL_TEXTURE_PATH);
+    woodTexture = loadMaterial(WOOD_TEXTURE_PATH);
 
     setup();
 
@@ -68,133 +143,775 @@ void Engine::initSettings() {
     glClearColor(0.15f, 0.15f, 0.15f, 1.0f);
     glViewport(0, 0, windowWidth, windowHeight);
     debugmode = 0;
+    jobSystem = new JobSystem();
     mainShader = new Shader("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
     depthShader = new Shader("shaders/depth_vertex_shader.glsl", "shaders/depth_fragment_shader.glsl");
+    prepassShader = new Shader("shaders/prepass_vertex_shader.glsl", "shaders/depth_fragment_shader.glsl");
+    pointShadowShader = new Shader("shaders/point_shadow_vertex_shader.glsl", "shaders/point_shadow_fragment_shader.glsl", "shaders/point_shadow_geometry_shader.glsl");
+    profiler = new Profiler();
+    frameCapture = new FrameCapture();
+    dynamicResolution = new DynamicResolution(windowWidth, windowHeight, TARGET_FRAME_TIME);
+    hiZOcclusion = new HiZOcclusion(windowWidth, windowHeight);
+    gpuScene = new GpuScene();
+    staticBatch = new StaticBatch();
+    staticBatches.push_back(staticBatch);
+    world = new World();
+    cubePool = new ObjectPool<Cube>();
+    physicsWorld = new PhysicsWorld();
+    spatialHash = new SpatialHash(COLLISION_CELL_SIZE);
+    scenePicker = new ScenePicker();
+    sceneGraph = new SceneGraph();
+    modelNode = sceneGraph->createNode();
+    sceneGraph->setPosition(modelNode, glm::vec3(sceneModelTransform[3]));
+    lightRigNode = sceneGraph->createNode();
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    lightStream = new StreamBuffer(GL_UNIFORM_BUFFER, sizeof(GpuLight) * MAX_LIGHTS);
+
+    // Każdy sampler cieni dostaje własną jednostkę - samplery porównujące nie mogą dzielić jednostki 0 z texture1
+    mainShader->use();
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "texture1"), 0);
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "pointShadowMaps"), SHADOW_TEXTURE_UNIT);
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "cascadeShadowMap"), CASCADE_TEXTURE_UNIT);
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "shadowAtlas"), ATLAS_TEXTURE_UNIT);
+    glUseProgram(0);
     initializeLights();
 }
 
 void Engine::initializeLights() {
+    // Encje świateł tworzy setup() - domyślne albo odczytane z pliku sceny
+    float color[] = { 0.2,0.8,0.8 };
+    GLuint texture = BitmapHandler::createBitmap(1024, 1024, 255*color[0], 255 * color[1], 255 * color[2]);
+    lightCube = new Cube(0.5, 0.0, 0.0, 0.0, texture);
+
+    // Tablica map sześciennych tworzona jest tylko po wyłączeniu atlasu (klawisz 'o')
+    shadowAtlas = new ShadowAtlas(SHADOW_ATLAS_SIZE, SHADOW_TILE_MIN, SHADOW_TILE_MAX);
+    cascadedShadowMap = new CascadedShadowMap(CASCADE_RESOLUTION, CASCADE_COUNT);
+
+}
+
+
+void Engine::displayCallback() {
+    dynamicResolution->update(profiler->getGpuFrameTime());
+    profiler->beginFrame();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    float aspect = (float)windowWidth / (float)windowHeight;
+    glm::mat4 view = observer->getViewMatrix();
+    glm::mat4 projection = observer->getProjectionMatrix(aspect);
+
+    if (spawnStorm) {
+        updateSpawnStorm();
+    }
+    if (chunkStreamer) {
+        updateStreaming();
+    }
+    updatePhysics();
+    updateSceneGraph();
+    cullViews(projection * view);
+    // Przebiegi cieni rysują z buforów GpuScene, więc uzgadniamy je przed nimi
+    gpuScene->sync(sceneObjects);
+
+    if (sceneModel) {
+        sceneModel->selectLod(sceneModelTransform, observer->getPosition(), projection, static_cast<float>(dynamicResolution->getRenderSize().y), LOD_PIXEL_ERROR);
+    }
+
+    profiler->beginPass("shadow");
+    renderShadowMaps();
+    profiler->endPass();
+
+    if (sun.enabled) {
+        profiler->beginPass("cascades");
+        renderCascadeShadowMaps(aspect);
+        profiler->endPass();
+    }
+
+    profiler->beginPass("cull");
+    cullScene(projection * view);
+    profiler->endPass();
+
+    dynamicResolution->bindForWriting();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
+    if (depthPrepass) {
+        profiler->beginPass("prepass");
+        renderDepthPrepass(view, projection);
+        profiler->endPass();
+
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+    }
+
+    profiler->beginPass("main");
+    mainShader->use();
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "debugMode"), debugmode);
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "numLights"), visibleLights.size());
+    glUniform1f(glGetUniformLocation(mainShader->getProgramID(), "attenuationLinear"), ATTENUATION_LINEAR);
+    glUniform1f(glGetUniformLocation(mainShader->getProgramID(), "attenuationQuadratic"), ATTENUATION_QUADRATIC);
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "pcfSamples"), pcfSamples);
+    glUniform1f(glGetUniformLocation(mainShader->getProgramID(), "pcfRadius"), pcfRadius);
+
+    glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+
+    // Do shadera trafiają tylko widoczne światła, upakowane na początku tablicy
+    lightStream->beginFrame();
+    GLintptr lightOffset = 0;
+    GpuLight fallbackLights[MAX_LIGHTS];
+    GpuLight* gpuLights = static_cast<GpuLight*>(lightStream->allocate(sizeof(GpuLight) * MAX_LIGHTS, uniformAlignment, lightOffset));
+    bool mappedLights = gpuLights != nullptr;
+    if (!mappedLights) {
+        // Bez trwałego mapowania światła trafiają na początek bufora przez glBufferSubData
+        gpuLights = fallbackLights;
+        lightOffset = 0;
+    }
+    for (size_t j = 0; j < visibleLights.size(); ++j) {
+        const Light& light = visibleLights[j];
+        GpuLight& gpuLight = gpuLights[j];
+        gpuLight.position = light.position;
+        gpuLight.color = light.color;
+        gpuLight.farPlane = light.farPlane;
+        gpuLight.radius = light.radius;
+        gpuLight.shadowIndex = light.slot;
+        for (int face = 0; face < OmniShadowMap::FACE_COUNT; face++) {
+            gpuLight.shadowTiles[face] = useShadowAtlas ? shadowAtlas->getTileRect(light.slot, face) : glm::vec4(0.0f);
+        }
+    }
+    if (!mappedLights) {
+        glBindBuffer(GL_UNIFORM_BUFFER, lightStream->getBuffer());
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GpuLight) * visibleLights.size(), fallbackLights);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, lightStream->getBuffer(), lightOffset, sizeof(GpuLight) * MAX_LIGHTS);
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "useShadowAtlas"), useShadowAtlas);
+    if (useShadowAtlas) {
+        glActiveTexture(GL_TEXTURE0 + ATLAS_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, shadowAtlas->getTexture());
+    }
+    else {
+        glActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, omniShadowMap->getTexture());
+    }
+
+    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "sunEnabled"), sun.enabled);
+    if (sun.enabled) {
+        glUniform3fv(glGetUniformLocation(mainShader->getProgramID(), "sunDirection"), 1, glm::value_ptr(glm::normalize(sun.direction)));
+        glUniform3fv(glGetUniformLocation(mainShader->getProgramID(), "sunColor"), 1, glm::value_ptr(sun.color));
+        glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "numCascades"), cascadedShadowMap->getCascadeCount());
+        for (int i = 0; i < cascadedShadowMap->getCascadeCount(); i++) {
+            std::string splitUniform = "cascadeSplits[" + std::to_string(i) + "]";
+            std::string matrixUniform = "cascadeMatrices[" + std::to_string(i) + "]";
+            glUniform1f(glGetUniformLocation(mainShader->getProgramID(), splitUniform.c_str()), cascadedShadowMap->getSplits()[i]);
+            glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), matrixUniform.c_str()), 1, GL_FALSE, glm::value_ptr(cascadedShadowMap->getMatrices()[i]));
+        }
+        glActiveTexture(GL_TEXTURE0 + CASCADE_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, cascadedShadowMap->getTexture());
+    }
+    renderScene(mainShader->getProgramID(), view, projection);
+    lightStream->endFrame();
+    profiler->endPass();
+
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+
+    // Piramida z bieżącej klatki służy do testu zasłonięcia w następnej
+    if (occlusionCulling) {
+        profiler->beginPass("hiz");
+        hiZOcclusion->buildPyramid(dynamicResolution->getDepthTexture(), dynamicResolution->getRenderSize(), projection * view);
+        profiler->endPass();
+    }
+
+    profiler->beginPass("upscale");
+    dynamicResolution->resolve();
+    profiler->endPass();
+
+    // Kopia do bufora PBO jest asynchroniczna - mierzony jest tylko koszt zlecenia
+    if (frameCapture->isActive()) {
+        auto captureStart = std::chrono::high_resolution_clock::now();
+        frameCapture->capture();
+        profiler->setCounter("capture us", std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - captureStart).count());
+        profiler->setCounter("captured", frameCapture->getCapturedCount());
+        profiler->setCounter("dropped", frameCapture->getDroppedCount());
+    }
+
+    profiler->setCounter("prepass", depthPrepass ? 1 : 0);
+    profiler->setCounter("pcf", pcfSamples);
+    profiler->setCounter("threads", jobSystem->getThreadCount());
+    profiler->setCounter("lights", visibleLights.size());
+    profiler->setCounter("pool", cubePool->getLiveCount());
+    profiler->setCounter("gl free", Cube::getFreeBufferCount());
+    size_t batchCount = 0;
+    for (const StaticBatch* batch : staticBatches) {
+        batchCount += batch->getBatchCount();
+    }
+    profiler->setCounter("draws", gpuScene->getDrawCallCount() + batchCount);
+    profiler->setCounter("stalls", lightStream->getStallCount() + gpuScene->getStagingBuffer().getStallCount());
+    profiler->setCounter("scale%", dynamicResolution->getScale() * 100.0f);
+    if (sceneModel) {
+        profiler->setCounter("lod", sceneModel->getLod());
+    }
+    profiler->endFrame();
+
+    glutSwapBuffers();
+}
+
+float Engine::computeInfluenceRadius(const glm::vec3& color, float cutoff) {
+    // Odległość, przy której color * 1 / (1 + l*d + q*d^2) spada do progu cutoff
+    float intensity = glm::max(color.x, glm::max(color.y, color.z));
+    if (intensity <= cutoff) {
+        return 0.0f;
+    }
+    float c = 1.0f - intensity / cutoff;
+    float delta = ATTENUATION_LINEAR * ATTENUATION_LINEAR - 4.0f * ATTENUATION_QUADRATIC * c;
+    return (-ATTENUATION_LINEAR + std::sqrt(delta)) / (2.0f * ATTENUATION_QUADRATIC);
+}
+
+void Engine::updateSceneGraph() {
+    auto start = std::chrono::high_resolution_clock::now();
+    if (graphStress) {
+        sceneGraph->rotate(stressNode, 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    sceneGraph->update(jobSystem);
+    double updateTime = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    sceneModelTransform = sceneGraph->getWorldMatrix(modelNode);
+    world->each<Light, SceneLink>([](Entity, Light& light, SceneLink& link) {
+        light.position = sceneGraph->getWorldPosition(link.node);
+    });
+
+    profiler->setCounter("nodes", sceneGraph->getUpdatedCount());
+    profiler->setCounter("graph us", updateTime);
+}
+
+Entity Engine::spawnCube(const glm::vec3& center, const glm::quat& orientation, float halfSize, GLuint texture) {
+    PoolHandle handle = cubePool->create(halfSize, center.x, center.y, center.z, texture != 0 ? texture : woodTexture);
+    Cube* cube = cubePool->get(handle);
+    if (orientation.w != 1.0f) {
+        cube->setPose(center, orientation);
+    }
+    PhysicsBody physics{ physicsWorld->addBox(center, orientation, glm::vec3(halfSize), CUBE_MASS) };
+    Entity entity = world->create(Renderable{ cube }, Bounds{ cube->getBounds() }, DynamicBody{}, Pooled{ handle }, physics, Thrown{}, Collidable{}, Pickable{});
+    world->get<Collidable>(entity)->collider = spatialHash->add(entity, center, orientation, glm::vec3(halfSize));
+    world->get<Pickable>(entity)->target = scenePicker->add(entity, center, orientation, glm::vec3(halfSize));
+    return entity;
+}
+
+Entity Engine::spawnScenery(const glm::vec3& center, const glm::quat& orientation, float halfSize) {
+    // Zerowa masa - ciało statyczne, usuwane razem z encją przy zwalnianiu fragmentu
+    PhysicsBody physics{ physicsWorld->addBox(center, orientation, glm::vec3(halfSize), 0.0f) };
+    Entity entity = world->create(physics, Collidable{}, Pickable{});
+    world->get<Collidable>(entity)->collider = spatialHash->add(entity, center, orientation, glm::vec3(halfSize));
+    world->get<Pickable>(entity)->target = scenePicker->add(entity, center, orientation, glm::vec3(halfSize));
+    return entity;
+}
+
+void Engine::despawnCube(Entity entity) {
+    if (!world->isAlive(entity)) {
+        return;
+    }
+    if (Pooled* pooled = world->get<Pooled>(entity)) {
+        cubePool->destroy(pooled->handle);
+    }
+    if (PhysicsBody* physics = world->get<PhysicsBody>(entity)) {
+        physicsWorld->removeBody(physics->body);
+    }
+    if (Collidable* collidable = world->get<Collidable>(entity)) {
+        spatialHash->remove(collidable->collider);
+    }
+    if (Pickable* pickable = world->get<Pickable>(entity)) {
+        scenePicker->remove(pickable->target);
+    }
+    world->destroy(entity);
+}
+
+void Engine::updateSpawnStorm() {
+    static std::mt19937 random(1234);
+    std::uniform_real_distribution<float> x(-6.0f, 6.0f), y(2.0f, 12.0f), z(0.0f, 8.0f);
+
+    for (int i = 0; i < STORM_SPAWNS_PER_FRAME; i++) {
+        spawnedCubes.push_back(spawnCube(glm::vec3(x(random), y(random), z(random))));
+    }
+    // Kolejka może zawierać sześciany usunięte już kliknięciem - limit liczony jest po żywych
+    while (static_cast<int>(world->count<Thrown>()) > STORM_MAX_CUBES) {
+        despawnCube(spawnedCubes.front());
+        spawnedCubes.pop_front();
+    }
+}
+
+void Engine::updatePhysics() {
+    static auto lastTime = std::chrono::high_resolution_clock::now();
+    static float accumulator = 0.0f;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    accumulator += std::chrono::duration<float>(start - lastTime).count();
+    lastTime = start;
+
+    // Stały krok; po przekroczeniu limitu kroków symulacja zwalnia zamiast nadrabiać zaległości
+    int steps = 0;
+    while (accumulator >= PHYSICS_STEP && steps < MAX_PHYSICS_STEPS) {
+        physicsWorld->step(PHYSICS_STEP, jobSystem);
+        accumulator -= PHYSICS_STEP;
+        steps++;
+    }
+    accumulator = glm::min(accumulator, PHYSICS_STEP);
+
+    // Wierzchołki przeliczane są tylko dla ciał, które się poruszyły
+    if (steps > 0) {
+        world->each<Bounds, Pooled, PhysicsBody, Collidable, Pickable>([](Entity, Bounds& bounds, Pooled& pooled, PhysicsBody& physics, Collidable& collidable, Pickable& pickable) {
+            if (!physicsWorld->isAwake(physics.body)) {
+                return;
+            }
+            glm::vec3 position = physicsWorld->getPosition(physics.body);
+            glm::quat orientation = physicsWorld->getOrientation(physics.body);
+            Cube* cube = cubePool->get(pooled.handle);
+            cube->setPose(position, orientation);
+            bounds.box = cube->getBounds();
+            spatialHash->update(collidable.collider, position, orientation);
+            scenePicker->update(pickable.target, position, orientation);
+        });
+    }
+    double physicsTime = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    profiler->setCounter("awake", physicsWorld->getAwakeCount());
+    profiler->setCounter("overflow", gpuScene->getStagingBuffer().getOverflowCount() + lightStream->getOverflowCount());
+    profiler->setCounter("contacts", physicsWorld->getContactCount());
+    profiler->setCounter("colliders", spatialHash->getColliderCount());
+    profiler->setCounter("physics us", physicsTime);
+}
+
+void Engine::updateStreaming() {
+    auto start = std::chrono::high_resolution_clock::now();
+    chunkStreamer->update(observer->getPosition());
+    chunkStreamer->unload([](ChunkStreamer::Chunk chunk) {
+        for (Entity entity : chunkEntities[chunk]) {
+            despawnCube(entity);
+        }
+        chunkEntities[chunk].clear();
+        if (StaticBatch* batch = chunkBatches[chunk]) {
+            staticBatches.erase(std::find(staticBatches.begin(), staticBatches.end(), batch));
+            delete batch;
+            chunkBatches[chunk] = nullptr;
+        }
+    });
+
+    // Sześciany fragmentu dopisywane są do jego paczki statycznej (bez własnych buforów i bez GpuScene),
+    // a jako encje zostają tylko w siatce kolizyjnej i drzewie wyboru; budżet liczony jest w bajtach dopisanych do paczek
+    const std::vector<unsigned int>& cubeIndices = Cube::getCubeIndices();
+    StaticBatch* pendingBatch = nullptr;
+    size_t uploadBytes = 0;
+    size_t uploaded = chunkStreamer->upload(STREAM_UPLOAD_BYTES_PER_FRAME, [&](ChunkStreamer::Chunk chunk, const SceneObject& object, const SceneMaterial* material) -> size_t {
+        if (object.kind != SCENE_OBJECT_CUBE) {
+            return 0;
+        }
+        StaticBatch*& batch = chunkBatches[chunk];
+        if (!batch) {
+            size_t objectCount = chunkStreamer->getObjectCount(chunk);
+            batch = new StaticBatch();
+            batch->reserve(objectCount * Cube::VERTEX_COUNT, objectCount * cubeIndices.size());
+            staticBatches.push_back(batch);
+        }
+        if (batch != pendingBatch) {
+            uploadBytes += pendingBatch ? pendingBatch->flush() : 0;
+            pendingBatch = batch;
+        }
+        GLuint texture = material ? loadMaterial(std::string(material->texture, strnlen(material->texture, sizeof(material->texture)))) : woodTexture;
+        glm::vec3 position(object.position[0], object.position[1], object.position[2]);
+        glm::quat orientation(object.orientation[3], object.orientation[0], object.orientation[1], object.orientation[2]);
+        std::array<float, Cube::VERTEX_COUNT * VERTEX_FLOATS> vertices;
+        Cube::computeVertices(position, orientation, object.halfExtents[0], vertices.data());
+        batch->append(texture, vertices, cubeIndices);
+        chunkEntities[chunk].push_back(spawnScenery(position, orientation, object.halfExtents[0]));
+        return Cube::VERTEX_COUNT * sizeof(PackedVertex) + cubeIndices.size() * batch->getIndexSize();
+    });
+    uploadBytes += pendingBatch ? pendingBatch->flush() : 0;
+    double streamTime = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    profiler->setCounter("chunks", chunkStreamer->getResidentCount());
+    profiler->setCounter("chunk io", chunkStreamer->getPendingCount());
+    profiler->setCounter("chunk MB", chunkStreamer->getUsedBytes() >> 20);
+    profiler->setCounter("uploads", uploaded);
+    profiler->setCounter("upload KB", uploadBytes >> 10);
+    profiler->setCounter("stream us", streamTime);
+}
+
+void Engine::pickCube(int x, int y) {
+    Ray ray = observer->getPickRay(x, y, windowWidth, windowHeight);
+    ScenePicker::Hit hit;
+    auto pickStart = std::chrono::high_resolution_clock::now();
+    bool picked = scenePicker->pick(ray, PICK_DISTANCE, hit);
+    profiler->setCounter("pick us", std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - pickStart).count());
+    profiler->setCounter("pick nodes", scenePicker->getVisitedCount());
+
+    // Ściany i obiekty fragmentów świata można trafić, ale usuwane są tylko rzucone sześciany;
+    // wpis w spawnedCubes zostaje i jest pomijany, gdy encja już nie żyje
+    if (picked && world->has<Thrown>(hit.entity)) {
+        despawnCube(hit.entity);
+    }
+}
+
+GLuint Engine::loadMaterial(const std::string& path) {
+    for (const auto& material : materials) {
+        if (material.first == path) {
+            return material.second;
+        }
+    }
+    GLuint texture = BitmapHandler::loadBitmapFromFile(path);
+    materials.emplace_back(path, texture);
+    return texture;
+}
+
+void Engine::addLight(const glm::vec3& position, const glm::vec3& color) {
+    int slot = static_cast<int>(world->count<Light>());
+    if (slot >= MAX_LIGHTS) {
+        std::cerr << "Light limit (" << MAX_LIGHTS << ") reached, light skipped" << std::endl;
+        return;
+    }
+
+    Light light;
+    light.position = position;
+    light.color = color;
+    light.radius = computeInfluenceRadius(light.color, lightCutoff);
+    light.farPlane = light.radius;
+    light.shadowResolution = 0;
+    light.slot = slot;
+    light.visible = true;
+
+    SceneGraph::Node node = sceneGraph->createNode(lightRigNode);
+    sceneGraph->setPosition(node, position);
+    world->create(light, SceneLink{ node });
+}
+
+void Engine::getWallBox(const ShapeObject& wall, glm::vec3& center, glm::quat& orientation, glm::vec3& halfExtents) {
+    std::span<const float> vertices = wall.getVertices();
+    glm::vec3 origin(vertices[0], vertices[1], vertices[2]);
+    glm::vec3 edgeU = glm::vec3(vertices[8], vertices[9], vertices[10]) - origin;
+    glm::vec3 edgeV = glm::vec3(vertices[24], vertices[25], vertices[26]) - origin;
+    glm::vec3 normal = glm::normalize(glm::cross(edgeU, edgeV));
+    orientation = glm::quat_cast(glm::mat3(glm::normalize(edgeU), glm::normalize(edgeV), normal));
+    center = origin + 0.5f * (edgeU + edgeV);
+    halfExtents = glm::vec3(0.5f * glm::length(edgeU), 0.5f * glm::length(edgeV), WALL_HALF_THICKNESS);
+}
 
-    glm::vec3 lightPositions[] = {
-    glm::vec3(-5.0f, -5.0f, 7.0f),
-    glm::vec3(5.0f, -5.0f, 7.0f),
-    glm::vec3(0.0f, 20.0f, 0.0f)
+void Engine::saveScene(const std::string& path) {
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneData scene;
+    for (const auto& material : materials) {
+        SceneMaterial record = {};
+        std::strncpy(record.texture, material.first.c_str(), sizeof(record.texture) - 1);
+        scene.materials.push_back(record);
+    }
+    auto materialOf = [](GLuint texture) {
+        for (size_t i = 0; i < materials.size(); i++) {
+            if (materials[i].second == texture) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+        return SCENE_NO_MATERIAL;
+    };
+    auto addObject = [&scene](uint32_t kind, const glm::vec3& position, const glm::quat& orientation, const glm::vec3& halfExtents, uint32_t material) {
+        scene.objects.push_back({ { position.x, position.y, position.z }, kind, { orientation.x, orientation.y, orientation.z, orientation.w },
+                                  { halfExtents.x, halfExtents.y, halfExtents.z }, material });
     };
 
-    for (int i = 0; i < lightPositions->length(); i++) {
-        Light light;
-        light.position = lightPositions[i];
-        light.color = glm::vec3(3.0f, 3.0f, 3.0f);
+    world->each<Renderable, StaticGeometry>([&](Entity, Renderable& renderable, StaticGeometry&) {
+        glm::vec3 center, halfExtents;
+        glm::quat orientation;
+        getWallBox(*renderable.shape, center, orientation, halfExtents);
+        addObject(SCENE_OBJECT_WALL, center, orientation, halfExtents, materialOf(renderable.shape->getTexture()));
+    });
+    // Kolejność z spawnedCubes, żeby po wczytaniu klawisz 'f' usuwał sześciany w tej samej kolejności
+    for (Entity entity : spawnedCubes) {
+        if (!world->isAlive(entity)) {
+            continue;
+        }
+        PhysicsWorld::Body body = world->get<PhysicsBody>(entity)->body;
+        Cube* cube = cubePool->get(world->get<Pooled>(entity)->handle);
+        addObject(SCENE_OBJECT_CUBE, physicsWorld->getPosition(body), physicsWorld->getOrientation(body), glm::vec3(cube->getHalfSize()), materialOf(cube->getTexture()));
+    }
+    world->each<Light, SceneLink>([&scene](Entity, Light& light, SceneLink& link) {
+        glm::vec3 position = sceneGraph->getWorldPosition(link.node);
+        scene.lights.push_back({ { position.x, position.y, position.z }, { light.color.x, light.color.y, light.color.z } });
+    });
+    const Camera& camera = *world->get<Camera>(observer->getEntity());
+    scene.camera = { { camera.position.x, camera.position.y, camera.position.z }, camera.pitch, camera.yaw, camera.fov, camera.nearPlane, camera.farPlane };
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    if (!SceneFile::write(path, scene)) {
+        return;
+    }
+    double saveTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Saved " << path << ": " << scene.objects.size() << " objects, " << scene.lights.size() << " lights in " << saveTime << " ms" << std::endl;
+}
 
-        glGenFramebuffers(1, &light.shadowFBO);
-        glGenTextures(1, &light.shadowMap);
-        glBindTexture(GL_TEXTURE_2D, light.shadowMap);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+void Engine::toggleCapture(uint32_t format) {
+    if (frameCapture->isRecording()) {
+        frameCapture->stop();
+        std::cout << "Capture stopped: " << frameCapture->getCapturedCount() << " frames, " << frameCapture->getDroppedCount() << " dropped" << std::endl;
+        return;
+    }
+    std::string path = std::string(CAPTURE_DIRECTORY) + "/capture_" + std::to_string(std::time(nullptr));
+    if (format == CAPTURE_FORMAT_Y4M) {
+        path += ".y4m";
+    }
+    if (frameCapture->start(path, format, windowWidth, windowHeight, CAPTURE_FPS)) {
+        std::cout << "Capturing " << windowWidth << "x" << windowHeight << " to " << path << std::endl;
+    }
+}
 
-        float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+bool Engine::loadScene(const std::string& path, std::vector<ShapeObject*>& walls) {
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const SceneFileHeader& header = file.getHeader();
 
-        glBindFramebuffer(GL_FRAMEBUFFER, light.shadowFBO);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, light.shadowMap, 0);
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    std::vector<GLuint> textures;
+    for (uint32_t i = 0; i < header.materialCount; i++) {
+        const char* texture = file.getMaterials()[i].texture;
+        textures.push_back(loadMaterial(std::string(texture, strnlen(texture, sizeof(SceneMaterial::texture)))));
+    }
 
-        lights.push_back(light);
+    // Rekordy czytane są wprost ze zmapowanego pliku, bez kopii pośrednich
+    const SceneObject* objects = file.getObjects();
+    for (uint32_t i = 0; i < header.objectCount; i++) {
+        const SceneObject& object = objects[i];
+        glm::vec3 position(object.position[0], object.position[1], object.position[2]);
+        glm::quat orientation(object.orientation[3], object.orientation[0], object.orientation[1], object.orientation[2]);
+        GLuint texture = object.material < textures.size() ? textures[object.material] : 0;
+
+        if (object.kind == SCENE_OBJECT_WALL) {
+            // Ściana budowana jest wokół początku układu, obracana i przesuwana na miejsce
+            float halfWidth = object.halfExtents[0], halfHeight = object.halfExtents[1];
+            Wall* wall = new Wall(2.0f * halfWidth, 2.0f * halfHeight, -halfWidth, -halfHeight, 0.0f, texture != 0 ? texture : wallTexture);
+            float angle = glm::angle(orientation);
+            if (angle > 1e-6f) {
+                wall->rotate(glm::degrees(angle), glm::axis(orientation));
+            }
+            wall->translate(position);
+            walls.push_back(wall);
+        }
+        else if (object.kind == SCENE_OBJECT_CUBE) {
+            spawnedCubes.push_back(spawnCube(position, orientation, object.halfExtents[0], texture));
+        }
+    }
+
+    for (uint32_t i = 0; i < header.lightCount; i++) {
+        const SceneLight& light = file.getLights()[i];
+        addLight(glm::vec3(light.position[0], light.position[1], light.position[2]), glm::vec3(light.color[0], light.color[1], light.color[2]));
     }
-    float color[] = { 0.2,0.8,0.8 };
-    GLuint texture = BitmapHandler::createBitmap(1024, 1024, 255*color[0], 255 * color[1], 255 * color[2]);
-    lightCube = new Cube(0.5, 0.0, 0.0, 0.0, texture);
 
+    const SceneCamera& saved = header.camera;
+    Camera& camera = *world->get<Camera>(observer->getEntity());
+    camera.position = glm::vec3(saved.position[0], saved.position[1], saved.position[2]);
+    camera.pitch = saved.pitch;
+    camera.yaw = saved.yaw;
+    camera.fov = saved.fov;
+    camera.nearPlane = saved.nearPlane;
+    camera.farPlane = saved.farPlane;
+    observer->updateTarget();
+
+    double loadTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Loaded " << path << ": " << header.objectCount << " objects, " << header.lightCount << " lights in " << loadTime << " ms" << std::endl;
+    return true;
 }
 
+void Engine::cullLights(const glm::mat4& viewProjection) {
+    Frustum frustum(viewProjection);
 
-void Engine::displayCallback() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    visibleLights.clear();
+    world->each<Light>([&frustum](Entity, Light& light) {
+        light.radius = computeInfluenceRadius(light.color, lightCutoff);
+        light.farPlane = light.radius;
+        light.visible = light.radius > 0.0f && frustum.intersectsSphere(light.position, light.radius);
+        if (light.visible && static_cast<int>(visibleLights.size()) < MAX_LIGHTS) {
+            visibleLights.push_back(light);
+        }
+    });
+}
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
+void Engine::cullViews(const glm::mat4& viewProjection) {
+    JobCounter cameraView, lightViews;
+    jobSystem->run([viewProjection]() {
+        cullLights(viewProjection);
+
+        // Ściany rysowane są z paczki statycznej, przez GpuScene przechodzą tylko ruchome obiekty
+        sceneObjects.clear();
+        world->each<Renderable, DynamicBody>([](Entity, Renderable& renderable, DynamicBody&) {
+            sceneObjects.push_back(renderable.shape);
+        });
+    }, &cameraView);
+
+    shadowQueues.resize(world->count<Light>());
+    jobSystem->runAfter(cameraView, [&lightViews]() {
+        world->each<Light>([&lightViews](Entity, Light& light) {
+            if (light.visible) {
+                jobSystem->run([light]() { buildShadowQueue(light); }, &lightViews);
+            }
+        });
+    }, &lightViews);
+
+    jobSystem->wait(cameraView);
+    jobSystem->wait(lightViews);
+}
+
+void Engine::buildShadowQueue(const Light& light) {
+    std::vector<ShadowDraw>& queue = shadowQueues[light.slot];
+    queue.clear();
+    world->each<Renderable, Bounds, DynamicBody>([&](Entity, Renderable& renderable, Bounds& bounds, DynamicBody&) {
+        int faceMask = OmniShadowMap::computeFaceMask(bounds.box, light.position, light.farPlane);
+        if (faceMask != 0) {
+            queue.push_back({ renderable.shape, faceMask });
+        }
+    });
+}
+
+void Engine::updateShadowAtlas() {
+    std::vector<int> requestedSizes(world->count<Light>(), 0);
+    float tanHalfFov = std::tan(glm::radians(observer->getFov()) * 0.5f);
+    glm::vec3 cameraPosition = observer->getPosition();
 
-    glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    for (size_t i = 0; i < lights.size(); i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, lights[i].shadowFBO);
+    world->each<Light>([&](Entity, Light& light) {
+        if (!light.visible) {
+            return;
+        }
+        float distance = glm::length(light.position - cameraPosition);
+        float radius = light.radius;
+
+        // Promień sfery zasięgu rzutowany na ekran jako część połowy wysokości obrazu - maleje z odległością
+        float coverage = 1.0f;
+        if (distance > radius) {
+            coverage = radius / (std::sqrt(distance * distance - radius * radius) * tanHalfFov);
+        }
+        requestedSizes[light.slot] = shadowAtlas->tileSizeForCoverage(coverage);
+    });
+
+    shadowAtlas->pack(requestedSizes);
+    world->each<Light>([](Entity, Light& light) {
+        light.shadowResolution = shadowAtlas->getOwnerTileSize(light.slot);
+    });
+    profiler->setCounter("atlas %", static_cast<int>(shadowAtlas->getOccupancy() * 100.0f));
+}
+
+void Engine::renderShadowMaps() {
+    if (useShadowAtlas) {
+        updateShadowAtlas();
+        shadowAtlas->bindForWriting();
+    }
+    else {
+        omniShadowMap->bindForWriting();
         glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    pointShadowShader->use();
+    GLuint program = pointShadowShader->getProgramID();
+    GLint faceMaskLocation = glGetUniformLocation(program, "faceMask");
+    glProgramUniform1i(program, glGetUniformLocation(program, "useViewportArray"), useShadowAtlas);
 
-        depthShader->use();
+    // Jedno przejście po scenie na światło - geometry shader rozsyła trójkąty do sześciu ścian
+    world->each<Light>([&](Entity, Light& light) {
+        if (!light.visible) {
+            return;
+        }
+        if (useShadowAtlas && !shadowAtlas->setFaceViewports(light.slot)) {
+            return;
+        }
 
-        glm::mat4 lightProjection = glm::ortho(-30.0f, 30.0f, -30.0f, 30.0f, 1.0f, 100.0f);
+        glm::mat4 faceMatrices[OmniShadowMap::FACE_COUNT];
+        OmniShadowMap::computeFaceMatrices(light.position, light.farPlane, faceMatrices);
 
-        glm::mat4 lightView = glm::lookAt(
-            lights[i].position, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        lights[i].lightSpaceMatrix = lightProjection * lightView;
+        glProgramUniformMatrix4fv(program, glGetUniformLocation(program, "shadowMatrices"), OmniShadowMap::FACE_COUNT, GL_FALSE, glm::value_ptr(faceMatrices[0]));
+        glProgramUniform3fv(program, glGetUniformLocation(program, "lightPos"), 1, glm::value_ptr(light.position));
+        glProgramUniform1f(program, glGetUniformLocation(program, "farPlane"), light.farPlane);
+        glProgramUniform1i(program, glGetUniformLocation(program, "lightIndex"), static_cast<GLint>(light.slot));
 
-        glUniformMatrix4fv(glGetUniformLocation(depthShader->getProgramID(), "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lights[i].lightSpaceMatrix));
         glDisable(GL_CULL_FACE);
-        for (Wall* wall : walls) {
-            glm::mat4 model = glm::mat4(1.0f);
-            wall->draw(depthShader->getProgramID(), model, glm::mat4(1.0f), glm::mat4(1.0f));
+        for (const StaticBatch* staticGeometry : staticBatches) {
+            for (size_t batch = 0; batch < staticGeometry->getBatchCount(); batch++) {
+                int faceMask = OmniShadowMap::computeFaceMask(staticGeometry->getBounds(batch), light.position, light.farPlane);
+                if (faceMask == 0) {
+                    continue;
+                }
+                glProgramUniform1i(program, faceMaskLocation, faceMask);
+                staticGeometry->drawBatch(program, batch, glm::mat4(1.0f), glm::mat4(1.0f));
+            }
         }
         glEnable(GL_CULL_FACE);
         glCullFace(GL_FRONT);
 
-        for (Cube* cube : cubes) {
-            glm::mat4 model = glm::mat4(1.0f);
-            cube->draw(depthShader->getProgramID(), model, glm::mat4(1.0f), glm::mat4(1.0f));
-        }
+        gpuScene->drawMasked(program, faceMaskLocation, shadowQueues[light.slot]);
 
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    }
+        if (sceneModel) {
+            int faceMask = OmniShadowMap::computeFaceMask(sceneModelBounds, light.position, light.farPlane);
+            if (faceMask != 0) {
+                glProgramUniform1i(program, faceMaskLocation, faceMask);
+                sceneModel->draw(program, sceneModelTransform, glm::mat4(1.0f), glm::mat4(1.0f));
+            }
+        }
+    });
 
-    glViewport(0, 0, windowWidth, windowHeight);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-    mainShader->use();
-    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "debugMode"), debugmode);
-    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "numLights"), lights.size());
+void Engine::renderCascadeShadowMaps(float aspect) {
+    cascadedShadowMap->update(*observer, aspect, sun.direction);
 
-    glm::mat4 view = observer->getViewMatrix();
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)windowWidth / (float)windowHeight, 0.1f, 100.0f);
+    depthShader->use();
+    // Obiekty przed bliską płaszczyzną kaskady są spłaszczane na nią zamiast obcinane
+    glEnable(GL_DEPTH_CLAMP);
+    for (int i = 0; i < cascadedShadowMap->getCascadeCount(); i++) {
+        cascadedShadowMap->bindForWriting(i);
+        glClear(GL_DEPTH_BUFFER_BIT);
 
-    glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glProgramUniformMatrix4fv(depthShader->getProgramID(), glGetUniformLocation(depthShader->getProgramID(), "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(cascadedShadowMap->getMatrices()[i]));
+        glDisable(GL_CULL_FACE);
+        for (const StaticBatch* batch : staticBatches) {
+            batch->draw(depthShader->getProgramID(), glm::mat4(1.0f), glm::mat4(1.0f));
+        }
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_FRONT);
 
-    for (size_t i = 0; i < lights.size(); ++i) {
-        std::string lightPosUniform = "lights[" + std::to_string(i) + "].position";
-        std::string lightColorUniform = "lights[" + std::to_string(i) + "].color";
-        std::string lightSpaceMatrixUniform = "lightSpaceMatrix[" + std::to_string(i) + "]";
-        std::string shadowMapUniform = "lights[" + std::to_string(i) + "].shadowMap";
+        gpuScene->drawDepth(depthShader->getProgramID());
 
-        glUniform3fv(glGetUniformLocation(mainShader->getProgramID(), lightPosUniform.c_str()), 1, glm::value_ptr(lights[i].position));
-        glUniform3fv(glGetUniformLocation(mainShader->getProgramID(), lightColorUniform.c_str()), 1, glm::value_ptr(lights[i].color));
-        glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), lightSpaceMatrixUniform.c_str()), 1, GL_FALSE, glm::value_ptr(lights[i].lightSpaceMatrix));
-       
-        glActiveTexture(GL_TEXTURE2 + i);
-        glBindTexture(GL_TEXTURE_2D, lights[i].shadowMap);
-        glUniform1i(glGetUniformLocation(mainShader->getProgramID(), shadowMapUniform.c_str()),2+ i);
+        if (sceneModel) {
+            sceneModel->draw(depthShader->getProgramID(), sceneModelTransform, glm::mat4(1.0f), glm::mat4(1.0f));
+        }
     }
-    for (Wall* wall : walls) {
-        wall->draw(mainShader->getProgramID(), glm::mat4(1.0f), view, projection);
+    glDisable(GL_DEPTH_CLAMP);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Engine::renderDepthPrepass(const glm::mat4& view, const glm::mat4& projection) {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    renderScene(prepassShader->getProgramID(), view, projection);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void Engine::renderScene(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) {
+    Frustum frustum(projection * view);
+    for (const StaticBatch* batch : staticBatches) {
+        batch->draw(shaderProgram, view, projection, frustum);
     }
+    gpuScene->draw(shaderProgram, view, projection);
 
-    for (Cube* cube : cubes) {
-        cube->draw(mainShader->getProgramID(), glm::mat4(1.0f), view, projection);
+    if (sceneModel) {
+        sceneModel->draw(shaderProgram, sceneModelTransform, view, projection);
     }
 
-    for (size_t i = 0; i < lights.size(); i++) {
+    world->each<Light>([&](Entity, Light& light) {
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, lights[i].position);
-        glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-        lightCube->draw(mainShader->getProgramID(), model, view, projection);
-    }
+        model = glm::translate(model, light.position);
+        lightCube->draw(shaderProgram, model, view, projection);
+    });
+}
 
-    glutSwapBuffers();
+void Engine::cullScene(const glm::mat4& viewProjection) {
+    hiZOcclusion->cull(gpuScene->getObjectBuffer(), gpuScene->getCommandBuffer(), gpuScene->getObjectCount(), viewProjection, occlusionCulling);
 }
 
 
@@ -216,10 +933,10 @@ void Engine::keyboardCallback(unsigned char key, int x, int y) {
         observer->moveRight(speed);
         break;
     case 'q':
-        observer->translate(glm::vec3(0.0f, speed, 0.0f));
+        observer->moveUp(speed);
         break;
     case 'e':
-        observer->translate(glm::vec3(0.0f, -speed, 0.0f));
+        observer->moveUp(-speed);
         break;
     case '1':
         debugmode = 0;
@@ -233,7 +950,84 @@ void Engine::keyboardCallback(unsigned char key, int x, int y) {
     case '4':
         debugmode = 3;
         break;
+    case 'p':
+        depthPrepass = !depthPrepass;
+        std::cout << "Depth prepass: " << (depthPrepass ? "on" : "off") << std::endl;
+        break;
+    case '5':
+        debugmode = 10;
+        break;
+    case 'c':
+        sun.enabled = !sun.enabled;
+        std::cout << "Cascaded sun shadows: " << (sun.enabled ? "on" : "off") << std::endl;
+        break;
+    case 'o':
+        useShadowAtlas = !useShadowAtlas;
+        if (useShadowAtlas) {
+            delete omniShadowMap;
+            omniShadowMap = nullptr;
+        }
+        else {
+            omniShadowMap = new OmniShadowMap(POINT_SHADOW_RESOLUTION, world->count<Light>());
+        }
+        std::cout << "Point shadow storage: " << (useShadowAtlas ? "atlas" : "cube map array") << std::endl;
+        break;
+    case 'i':
+        shadowAtlas->printLayout(std::cout);
+        break;
+    case '[':
+        lightCutoff *= 2.0f;
+        std::cout << "Light cutoff: " << lightCutoff << std::endl;
+        break;
+    case ']':
+        lightCutoff *= 0.5f;
+        std::cout << "Light cutoff: " << lightCutoff << std::endl;
+        break;
+    case 'r':
+        dynamicResolution->setEnabled(!dynamicResolution->isEnabled());
+        std::cout << "Dynamic resolution: " << (dynamicResolution->isEnabled() ? "on" : "off") << std::endl;
+        break;
+    case 'h':
+        occlusionCulling = !occlusionCulling;
+        std::cout << "Hi-Z occlusion culling: " << (occlusionCulling ? "on" : "off") << std::endl;
+        break;
+    case 'g':
+        graphStress = !graphStress;
+        if (graphStress && stressNode == SceneGraph::ROOT) {
+            stressNode = sceneGraph->createNode();
+            for (int group = 0; group < STRESS_GROUPS; group++) {
+                SceneGraph::Node groupNode = sceneGraph->createNode(stressNode);
+                sceneGraph->setPosition(groupNode, glm::vec3(group % 32, 0.0f, group / 32));
+                for (int child = 0; child < STRESS_GROUP_SIZE; child++) {
+                    SceneGraph::Node node = sceneGraph->createNode(groupNode);
+                    sceneGraph->setPosition(node, glm::vec3(0.0f, child * 0.1f, 0.0f));
+                }
+            }
+        }
+        std::cout << "Scene graph stress test (" << sceneGraph->getNodeCount() << " nodes): " << (graphStress ? "on" : "off") << std::endl;
+        break;
+    case 'n':
+        spawnStorm = !spawnStorm;
+        std::cout << "Spawn storm (" << STORM_SPAWNS_PER_FRAME << " cubes per frame): " << (spawnStorm ? "on" : "off") << std::endl;
+        break;
+    case 'k':
+        pcfSamples = pcfSamples >= 16 ? 1 : pcfSamples * 2;
+        std::cout << "PCF samples: " << pcfSamples << std::endl;
+        break;
+    case 'x':
+        saveScene(SCENE_PATH);
+        break;
+    case 'v':
+        toggleCapture(CAPTURE_FORMAT_Y4M);
+        break;
+    case 'V':
+        toggleCapture(CAPTURE_FORMAT_PNG);
+        break;
     case 27: // ESC
+        saveScene(SCENE_PATH);
+        // exit() pomija destruktor silnika - nagranie trzeba domknąć tutaj
+        delete frameCapture;
+        frameCapture = nullptr;
         exit(0);
         break;
     default:
@@ -245,6 +1039,10 @@ void Engine::keyboardCallback(unsigned char key, int x, int y) {
 }
 
 void Engine::mouseCallback(int button, int state, int x, int y) {
+    if (button == GLUT_RIGHT_BUTTON && state == GLUT_DOWN) {
+        pickCube(x, y);
+        glutPostRedisplay();
+    }
     if (button == GLUT_LEFT_BUTTON) {
         if (state == GLUT_DOWN) {
             isMousePressed = true;
@@ -280,8 +1078,15 @@ void Engine::mouseMotionCallback(int x, int y) {
 }
 
 void Engine::reshapeCallback(int w, int h) {
+    // Rozmiar klatek nagrania jest stały
+    if (frameCapture->isRecording() && (w != windowWidth || h != windowHeight)) {
+        frameCapture->stop();
+        std::cout << "Capture stopped: window resized" << std::endl;
+    }
     windowHeight = h;
     windowWidth = w;
+    dynamicResolution->resize(w, h);
+    hiZOcclusion->resize(w, h);
     updateProjectionMatrix();
 }
 
@@ -314,17 +1119,75 @@ void Engine::setup()
     float roomHeight = 16.0f;
     float roomDepth = 14.0f;
 
+    // Zapisana scena (klawisz 'x' lub wyjście) zastępuje scenę domyślną
+    std::vector<ShapeObject*> walls;
+    if (!loadScene(SCENE_PATH, walls)) {
+        Wall* centerWall = new Wall(roomDepth, roomHeight, 0.0f, 0.0f, -2.0f, wallTexture);
+        walls.push_back(centerWall);
+
+        Wall* angledWall1 = new Wall(roomDepth, roomHeight, -5.0f, 0.0f, -3.0f, wallTexture);
+        angledWall1->rotateAround(30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        walls.push_back(angledWall1);
 
-    Wall* centerWall = new Wall(roomDepth, roomHeight, 0.0f, 0.0f, -2.0f, wallTexture);
-    walls.push_back(centerWall);
+        Wall* angledWall2 = new Wall(roomDepth, roomHeight, 5.0f, 0.0f, 3.0f, wallTexture);
+        angledWall2->rotateAround(-30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        walls.push_back(angledWall2);
+
+        addLight(glm::vec3(-5.0f, -5.0f, 7.0f), glm::vec3(3.0f));
+        addLight(glm::vec3(5.0f, -5.0f, 7.0f), glm::vec3(3.0f));
+        addLight(glm::vec3(0.0f, 20.0f, 0.0f), glm::vec3(3.0f));
+    }
+    sceneGraph->update();
 
-    Wall* angledWall1 = new Wall(roomDepth, roomHeight, -5.0f, 0.0f, -3.0f, wallTexture);
-    angledWall1->rotateAround(30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-    walls.push_back(angledWall1);
+    staticBatch->build(walls);
+    for (ShapeObject* wall : walls) {
+        wall->releaseBuffers();
+    }
+
+    // Ściany są w fizyce i siatce kolizyjnej cienkimi statycznymi pudłami, a podłoga płaszczyzną na wysokości ich podstawy
+    float floorHeight = walls.empty() ? 0.0f : walls.front()->getBounds().min.y;
+    for (ShapeObject* wall : walls) {
+        Entity entity = world->create(Renderable{ wall }, Bounds{ wall->getBounds() }, StaticGeometry{}, Collidable{}, Pickable{});
+        glm::vec3 center, halfExtents;
+        glm::quat orientation;
+        getWallBox(*wall, center, orientation, halfExtents);
+        physicsWorld->addBox(center, orientation, halfExtents, 0.0f);
+        world->get<Collidable>(entity)->collider = spatialHash->add(entity, center, orientation, halfExtents);
+        world->get<Pickable>(entity)->target = scenePicker->add(entity, center, orientation, halfExtents);
+        floorHeight = glm::min(floorHeight, wall->getBounds().min.y);
+    }
+    physicsWorld->addPlane(glm::vec3(0.0f, 1.0f, 0.0f), floorHeight);
+
+    // Opcjonalny model przygotowany konwerterem MeshConverter
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    sceneModel = new Model(woodTexture);
+    if (sceneModel->load(MODEL_PATH)) {
+        double loadTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+        std::cout << "Loaded " << MODEL_PATH << ": " << sceneModel->getTriangleCount() << " triangles, "
+                  << sceneModel->getLodCount() << " LODs in " << loadTime << " ms" << std::endl;
+
+        const BoundingBox& bounds = sceneModel->getBounds();
+        for (int corner = 0; corner < 8; corner++) {
+            glm::vec3 point((corner & 1) ? bounds.max.x : bounds.min.x, (corner & 2) ? bounds.max.y : bounds.min.y, (corner & 4) ? bounds.max.z : bounds.min.z);
+            sceneModelBounds.expand(glm::vec3(sceneModelTransform * glm::vec4(point, 1.0f)));
+        }
+    }
+    else {
+        delete sceneModel;
+        sceneModel = nullptr;
+    }
 
-    Wall* angledWall2 = new Wall(roomDepth, roomHeight, 5.0f, 0.0f, 3.0f, wallTexture);
-    angledWall2->rotateAround(-30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-    walls.push_back(angledWall2);
+    // Opcjonalny świat podzielony na fragmenty (WorldGenerator), wczytywany w tle wokół obserwatora
+    chunkStreamer = new ChunkStreamer(WORLD_PATH, STREAM_LOAD_RADIUS, STREAM_UNLOAD_RADIUS, STREAM_MEMORY_BUDGET, STREAM_BYTES_PER_OBJECT, STREAM_IO_THREADS);
+    if (chunkStreamer->getChunkCount() > 0) {
+        chunkEntities.resize(chunkStreamer->getChunkCount());
+        chunkBatches.resize(chunkStreamer->getChunkCount(), nullptr);
+        std::cout << "Streaming " << chunkStreamer->getChunkCount() << " chunks from " << WORLD_PATH << std::endl;
+    }
+    else {
+        delete chunkStreamer;
+        chunkStreamer = nullptr;
+    }
 }
 
 void Engine::keyboard(unsigned char key, int x, int y)
@@ -332,19 +1195,22 @@ void Engine::keyboard(unsigned char key, int x, int y)
     switch (key) {
     case 'f':
     case 'F':
-        if (!cubes.empty()) {
-            cubes.pop_back();
+        while (!spawnedCubes.empty() && !world->isAlive(spawnedCubes.back())) {
+            spawnedCubes.pop_back();
+        }
+        if (!spawnedCubes.empty()) {
+            despawnCube(spawnedCubes.back());
+            spawnedCubes.pop_back();
         }
         break;
 
     case 'b': {
         glm::vec3 point = observer->getPosition();
-        Cube* cube = new Cube(1.0, point.x, point.y, point.z, woodTexture);
         glm::vec3 direction = 3.0f * glm::normalize(observer->getTarget() - point);
 
-        cube->translate(direction);
-
-        cubes.push_back(cube);
+        Entity cube = spawnCube(point + direction);
+        physicsWorld->setVelocity(world->get<PhysicsBody>(cube)->body, THROW_SPEED * glm::normalize(direction));
+        spawnedCubes.push_back(cube);
         break;
     }
 
@@ -355,23 +1221,42 @@ void Engine::keyboard(unsigned char key, int x, int y)
 
 
 Engine::~Engine() {
+    delete chunkStreamer;
     delete observer;
-    for (Cube* cube : cubes) {
-        delete cube;
+    // Sześciany z puli niszczy pula, oddając ich bufory na listę wolnych buforów
+    world->each<Renderable, StaticGeometry>([](Entity, Renderable& renderable, StaticGeometry&) {
+        delete renderable.shape;
+    });
+    delete world;
+    delete cubePool;
+    delete physicsWorld;
+    delete spatialHash;
+    delete scenePicker;
+    delete lightCube;
+    Cube::deleteFreeBuffers();
+    for (const auto& material : materials) {
+        BitmapHandler::deleteBitmap(material.second);
     }
 
-    for (Wall* wall : walls) {
-        delete wall;
-    }
-    BitmapHandler::deleteBitmap(wallTexture);
-    BitmapHandler::deleteBitmap(wallTexture);
-
-    for (Light light : lights) {
-        BitmapHandler::deleteBitmap(light.shadowFBO);
-    }
-    
+    delete omniShadowMap;
+    delete shadowAtlas;
 
     delete mainShader;
     delete depthShader;
+    delete prepassShader;
+    delete pointShadowShader;
+    delete cascadedShadowMap;
+    delete profiler;
+    delete frameCapture;
+    delete dynamicResolution;
+    delete hiZOcclusion;
+    delete gpuScene;
+    for (StaticBatch* batch : staticBatches) {
+        delete batch;
+    }
+    delete lightStream;
+    delete sceneModel;
+    delete sceneGraph;
+    delete jobSystem;
 
 }
@@ -0,0 +1,367 @@
+#include "FrameCapture.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+const size_t STORED_BLOCK_SIZE = 65535;
+
+const std::array<uint32_t, 256>& crcTable() {
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> values{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            }
+            values[i] = crc;
+        }
+        return values;
+    }();
+    return table;
+}
+
+void appendBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void appendChunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data) {
+    appendBigEndian(out, static_cast<uint32_t>(data.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = start; i < out.size(); i++) {
+        crc = crcTable()[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+    }
+    appendBigEndian(out, crc ^ 0xFFFFFFFFu);
+}
+
+// PNG RGB 8-bit; dane w strumieniu zlib zapisane blokami bez kompresji (deflate typu 0)
+bool writePng(const std::string& path, const unsigned char* rgba, int width, int height, std::vector<unsigned char>& rows, std::vector<unsigned char>& file) {
+    // Wiersze z glReadPixels idą od dołu obrazu
+    size_t stride = static_cast<size_t>(width) * 3 + 1;
+    rows.resize(stride * height);
+    for (int y = 0; y < height; y++) {
+        const unsigned char* source = rgba + static_cast<size_t>(height - 1 - y) * width * 4;
+        unsigned char* target = &rows[y * stride];
+        *target++ = 0;
+        for (int x = 0; x < width; x++) {
+            *target++ = source[x * 4];
+            *target++ = source[x * 4 + 1];
+            *target++ = source[x * 4 + 2];
+        }
+    }
+
+    std::vector<unsigned char> zlib = { 0x78, 0x01 };
+    zlib.reserve(rows.size() + rows.size() / STORED_BLOCK_SIZE * 5 + 16);
+    for (size_t offset = 0; offset < rows.size(); offset += STORED_BLOCK_SIZE) {
+        size_t length = std::min(STORED_BLOCK_SIZE, rows.size() - offset);
+        zlib.push_back(offset + length == rows.size() ? 1 : 0);
+        zlib.push_back(static_cast<unsigned char>(length));
+        zlib.push_back(static_cast<unsigned char>(length >> 8));
+        zlib.push_back(static_cast<unsigned char>(~length));
+        zlib.push_back(static_cast<unsigned char>(~length >> 8));
+        zlib.insert(zlib.end(), rows.begin() + offset, rows.begin() + offset + length);
+    }
+    uint32_t a = 1, b = 0;
+    for (unsigned char value : rows) {
+        a = (a + value) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+
+    std::vector<unsigned char> header;
+    appendBigEndian(header, static_cast<uint32_t>(width));
+    appendBigEndian(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), { 8, 2, 0, 0, 0 });
+
+    static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.assign(signature, signature + sizeof(signature));
+    appendChunk(file, "IHDR", header);
+    appendChunk(file, "IDAT", zlib);
+    appendChunk(file, "IEND", {});
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return out.good();
+}
+
+// Klatka Y4M 4:2:0 (BT.601, zakres ograniczony); chrominancja uśredniana z bloków 2x2
+bool writeY4mFrame(std::ofstream& out, const unsigned char* rgba, int width, int height, std::vector<unsigned char>& planes) {
+    int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    size_t lumaSize = static_cast<size_t>(width) * height, chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+    planes.resize(lumaSize + 2 * chromaSize);
+    unsigned char* luma = planes.data();
+    unsigned char* blue = luma + lumaSize;
+    unsigned char* red = blue + chromaSize;
+
+    auto pixel = [&](int x, int y) {
+        return rgba + (static_cast<size_t>(height - 1 - y) * width + x) * 4;
+    };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const unsigned char* p = pixel(x, y);
+            luma[static_cast<size_t>(y) * width + x] = static_cast<unsigned char>(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+        }
+    }
+    for (int y = 0; y < chromaHeight; y++) {
+        for (int x = 0; x < chromaWidth; x++) {
+            int r = 0, g = 0, b = 0;
+            for (int corner = 0; corner < 4; corner++) {
+                const unsigned char* p = pixel(std::min(2 * x + (corner & 1), width - 1), std::min(2 * y + (corner >> 1), height - 1));
+                r += p[0];
+                g += p[1];
+                b += p[2];
+            }
+            r /= 4;
+            g /= 4;
+            b /= 4;
+            blue[static_cast<size_t>(y) * chromaWidth + x] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            red[static_cast<size_t>(y) * chromaWidth + x] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    out << "FRAME\n";
+    out.write(reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()));
+    return out.good();
+}
+
+}
+
+FrameCapture::FrameCapture(int slotCount) : slotCount(std::clamp(slotCount, 2, MAX_SLOTS)) {
+}
+
+FrameCapture::~FrameCapture() {
+    // Przy zamykaniu czekanie jest dopuszczalne - dopisywane są klatki wciąż kopiowane przez GPU
+    stop();
+    collect(true);
+    joinWriter(true);
+    releaseBuffers();
+}
+
+bool FrameCapture::start(const std::string& outputPath, uint32_t outputFormat, int outputWidth, int outputHeight, int framesPerSecond) {
+    if (recording) {
+        return false;
+    }
+    joinWriter(false);
+    if (stopping || writer.joinable()) {
+        std::cerr << "Previous capture is still being written" << std::endl;
+        return false;
+    }
+    if (!GLEW_ARB_buffer_storage) {
+        std::cerr << "GL_ARB_buffer_storage is not supported - frame capture is unavailable!" << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::path target(outputPath);
+    std::filesystem::create_directories(outputFormat == CAPTURE_FORMAT_PNG ? target : target.parent_path(), error);
+    if (outputFormat == CAPTURE_FORMAT_Y4M) {
+        video.open(outputPath, std::ios::binary);
+        if (!video.is_open()) {
+            std::cerr << "Failed to open capture file: " << outputPath << std::endl;
+            return false;
+        }
+        video << "YUV4MPEG2 W" << outputWidth << " H" << outputHeight << " F" << framesPerSecond << ":1 Ip A1:1 C420jpeg\n";
+    }
+
+    size_t size = static_cast<size_t>(outputWidth) * outputHeight * 4;
+    if (size != bufferSize) {
+        releaseBuffers();
+        // Pamięć po stronie klienta i trwałe mapowanie - wątek zapisu czyta wprost z bufora
+        GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        for (int i = 0; i < slotCount; i++) {
+            glGenBuffers(1, &slots[i].buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].buffer);
+            glBufferStorage(GL_PIXEL_PACK_BUFFER, size, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+            slots[i].mapped = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, flags));
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        bufferSize = size;
+    }
+
+    path = outputPath;
+    format = outputFormat;
+    width = outputWidth;
+    height = outputHeight;
+    capturedCount = 0;
+    droppedCount = 0;
+    writtenCount = 0;
+    freeSlots.clear();
+    for (int i = slotCount - 1; i >= 0; i--) {
+        freeSlots.push_back(i);
+    }
+    finishing = false;
+    writerDone = false;
+    writer = std::thread(&FrameCapture::writerLoop, this);
+    recording = true;
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (!recording) {
+        return;
+    }
+    recording = false;
+    stopping = true;
+}
+
+void FrameCapture::capture() {
+    joinWriter(false);
+    if (!recording && !stopping) {
+        return;
+    }
+    collect(false);
+
+    if (stopping && pending.empty()) {
+        // Wszystkie kopie odebrane - wątek zapisu kończy po opróżnieniu kolejki
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishing = true;
+        }
+        wakeUp.notify_one();
+        stopping = false;
+    }
+    if (!recording) {
+        return;
+    }
+
+    int slot = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+    }
+    if (slot < 0 || !slots[slot].mapped) {
+        droppedCount++;
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[slot].buffer);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slots[slot].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending.push_back(slot);
+}
+
+void FrameCapture::collect(bool wait) {
+    // Kopie kończą się w kolejności zlecenia, więc wystarczy sprawdzać najstarszą
+    while (!pending.empty()) {
+        Slot& slot = slots[pending.front()];
+        GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000 : 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frames.push_back(pending.front());
+        }
+        wakeUp.notify_one();
+        pending.pop_front();
+        capturedCount++;
+    }
+
+    if (wait && stopping) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishing = true;
+        }
+        wakeUp.notify_one();
+        stopping = false;
+    }
+}
+
+void FrameCapture::writerLoop() {
+    std::vector<unsigned char> scratch, file;
+    size_t index = 0;
+    while (true) {
+        int slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this]() { return finishing || !frames.empty(); });
+            if (frames.empty()) {
+                break;
+            }
+            slot = frames.front();
+            frames.pop_front();
+        }
+
+        bool written;
+        if (format == CAPTURE_FORMAT_PNG) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%06zu.png", index);
+            written = writePng((std::filesystem::path(path) / name).string(), slots[slot].mapped, width, height, scratch, file);
+        }
+        else {
+            written = writeY4mFrame(video, slots[slot].mapped, width, height, scratch);
+        }
+        if (!written) {
+            std::cerr << "Failed to write captured frame " << index << " to " << path << std::endl;
+        }
+        index++;
+        writtenCount++;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        freeSlots.push_back(slot);
+    }
+
+    if (video.is_open()) {
+        video.close();
+    }
+    writerDone = true;
+}
+
+void FrameCapture::joinWriter(bool wait) {
+    if (writer.joinable() && (wait || writerDone)) {
+        writer.join();
+    }
+}
+
+void FrameCapture::releaseBuffers() {
+    for (int i = 0; i < slotCount; i++) {
+        if (slots[i].fence) {
+            glDeleteSync(slots[i].fence);
+        }
+        if (slots[i].buffer) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].buffer);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glDeleteBuffers(1, &slots[i].buffer);
+        }
+        slots[i] = Slot();
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    bufferSize = 0;
+}
+
+bool FrameCapture::isRecording() const {
+    return recording;
+}
+
+bool FrameCapture::isActive() const {
+    return recording || stopping;
+}
+
+size_t FrameCapture::getCapturedCount() const {
+    return capturedCount;
+}
+
+size_t FrameCapture::getWrittenCount() const {
+    return writtenCount;
+}
+
+size_t FrameCapture::getDroppedCount() const {
+    return droppedCount;
+}
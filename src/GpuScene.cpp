@@ -0,0 +1,421 @@
+#include "GpuScene.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Najmniejsza liczba slotów materiału - pierwsze zrzuty sześcianów nie wymuszają przebudowy
+const size_t MIN_MATERIAL_SLOTS = 64;
+
+const size_t STAGING_REGION_SIZE = 64 * 1024;
+const size_t STAGING_ALIGNMENT = 16;
+
+}
+
+GpuScene::GpuScene()
+    : staging(GL_COPY_READ_BUFFER, STAGING_REGION_SIZE) {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glGenBuffers(1, &objectBuffer);
+    glGenBuffers(1, &commandBuffer);
+    glGenBuffers(1, &depthCommandBuffer);
+    glGenBuffers(1, &maskedCommandBuffer);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    VertexFormat::setupAttributes();
+
+    glBindVertexArray(0);
+}
+
+GpuScene::~GpuScene() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    glDeleteBuffers(1, &objectBuffer);
+    glDeleteBuffers(1, &commandBuffer);
+    glDeleteBuffers(1, &depthCommandBuffer);
+    glDeleteBuffers(1, &maskedCommandBuffer);
+}
+
+void GpuScene::sync(const std::vector<ShapeObject*>& objects) {
+    syncStamp++;
+    separateObjects.clear();
+    addedObjects.clear();
+    staging.beginFrame();
+
+    for (ShapeObject* object : objects) {
+        if (!object->hasSingleTexture()) {
+            separateObjects.push_back(object);
+            continue;
+        }
+        auto found = slotOfObject.find(object->getId());
+        if (found == slotOfObject.end()) {
+            addedObjects.push_back(object);
+            continue;
+        }
+
+        // Zmiana tekstury przenosi obiekt do zakresu innego materiału
+        GLuint index = found->second;
+        if (materials[slots[index].material].texture != object->getTexture()) {
+            release(index);
+            addedObjects.push_back(object);
+            continue;
+        }
+
+        ObjectSlot& slot = slots[index];
+        slot.syncStamp = syncStamp;
+        if (slot.revision != object->getRevision()) {
+            uploadGeometry(index);
+        }
+    }
+
+    // Najpierw zwalniamy sloty usuniętych obiektów, żeby nowe obiekty mogły je od razu zająć
+    for (GLuint i = 0; i < slots.size(); i++) {
+        if (slots[i].object && slots[i].syncStamp != syncStamp) {
+            release(i);
+        }
+    }
+    for (const ShapeObject* object : addedObjects) {
+        if (!allocate(object)) {
+            staging.endFrame();
+            rebuild(objects);
+            return;
+        }
+    }
+    staging.endFrame();
+}
+
+void GpuScene::upload(GLuint destination, GLintptr offset, const void* data, size_t size) {
+    GLintptr stagingOffset = 0;
+    void* target = staging.allocate(size, STAGING_ALIGNMENT, stagingOffset);
+
+    if (!target) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return;
+    }
+
+    std::memcpy(target, data, size);
+    copyFromStaging(destination, offset, stagingOffset, size);
+}
+
+void GpuScene::copyFromStaging(GLuint destination, GLintptr offset, GLintptr stagingOffset, size_t size) {
+    glBindBuffer(GL_COPY_READ_BUFFER, staging.getBuffer());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, stagingOffset, offset, size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+bool GpuScene::allocate(const ShapeObject* object) {
+    auto material = std::find_if(materials.begin(), materials.end(), [object](const MaterialRange& range) {
+        return range.texture == object->getTexture();
+    });
+    if (material == materials.end()) {
+        return false;
+    }
+
+    size_t vertexCount = object->getVertices().size() / VERTEX_FLOATS;
+    size_t indexCount = object->getIndices().size();
+    std::vector<GLuint>& freeSlots = material->freeSlots;
+    auto fitting = std::find_if(freeSlots.rbegin(), freeSlots.rend(), [this, vertexCount, indexCount](GLuint index) {
+        return slots[index].vertexCapacity >= vertexCount && slots[index].indexCapacity >= indexCount;
+    });
+    if (fitting == freeSlots.rend()) {
+        return false;
+    }
+
+    GLuint index = *fitting;
+    *fitting = freeSlots.back();
+    freeSlots.pop_back();
+
+    ObjectSlot& slot = slots[index];
+    slot.object = object;
+    slot.id = object->getId();
+    slot.syncStamp = syncStamp;
+    slotOfObject[slot.id] = index;
+
+    uploadGeometry(index);
+    uploadCommand(index);
+    return true;
+}
+
+void GpuScene::release(GLuint index) {
+    ObjectSlot& slot = slots[index];
+    slotOfObject.erase(slot.id);
+    slot.object = nullptr;
+    materials[slot.material].freeSlots.push_back(index);
+
+    // Compute shader odrzucania nadpisuje instanceCount, więc slot wyłącza dopiero zerowa liczba indeksów
+    writeCommand(index, { 0, 0, slot.firstIndex, slot.baseVertex, index });
+}
+
+void GpuScene::uploadGeometry(GLuint index) {
+    ObjectSlot& slot = slots[index];
+
+    // Wierzchołki pakowane są wprost do pierścienia, a bez niego - do wspólnej tablicy roboczej
+    std::span<const float> vertices = slot.object->getVertices();
+    size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    size_t size = vertexCount * sizeof(PackedVertex);
+    GLintptr vertexOffset = slot.baseVertex * sizeof(PackedVertex);
+    GLintptr stagingOffset = 0;
+    PackedVertex* packed = static_cast<PackedVertex*>(staging.allocate(size, STAGING_ALIGNMENT, stagingOffset));
+    bool staged = packed != nullptr;
+    if (!staged) {
+        packedScratch.resize(vertexCount);
+        packed = packedScratch.data();
+    }
+    for (size_t i = 0; i < vertexCount; i++) {
+        packed[i] = VertexFormat::pack(vertices.data() + i * VERTEX_FLOATS);
+    }
+    if (!staged) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset, size, packed);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    else {
+        copyFromStaging(vertexBuffer, vertexOffset, stagingOffset, size);
+    }
+
+    const BoundingBox& bounds = slot.object->getBounds();
+    gpuObjects[index] = { glm::vec4(bounds.min, 1.0f), glm::vec4(bounds.max, 1.0f) };
+    upload(objectBuffer, index * sizeof(GpuObject), &gpuObjects[index], sizeof(GpuObject));
+    slot.revision = slot.object->getRevision();
+}
+
+void GpuScene::uploadCommand(GLuint index) {
+    const ObjectSlot& slot = slots[index];
+    const std::vector<unsigned int>& indices = slot.object->getIndices();
+    if (indexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> shortIndices = VertexFormat::packIndices(indices);
+        upload(indexBuffer, slot.firstIndex * sizeof(uint16_t), shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+    }
+    else {
+        upload(indexBuffer, slot.firstIndex * sizeof(uint32_t), indices.data(), indices.size() * sizeof(uint32_t));
+    }
+
+    writeCommand(index, { static_cast<GLuint>(indices.size()), 1, slot.firstIndex, slot.baseVertex, index });
+}
+
+void GpuScene::writeCommand(GLuint index, const DrawElementsIndirectCommand& command) {
+    upload(commandBuffer, index * sizeof(DrawElementsIndirectCommand), &command, sizeof(command));
+    upload(depthCommandBuffer, index * sizeof(DrawElementsIndirectCommand), &command, sizeof(command));
+}
+
+void GpuScene::rebuild(const std::vector<ShapeObject*>& objects) {
+    std::vector<const ShapeObject*> ordered;
+    for (const ShapeObject* object : objects) {
+        if (object->hasSingleTexture()) {
+            ordered.push_back(object);
+        }
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const ShapeObject* a, const ShapeObject* b) {
+        return a->getTexture() < b->getTexture();
+    });
+
+    std::vector<PackedVertex> vertices;
+    std::vector<unsigned int> indices;
+    size_t largestObject = 0;
+    size_t movingBytes = 0;
+    std::vector<DrawElementsIndirectCommand> commands;
+    slots.clear();
+    slotOfObject.clear();
+    materials.clear();
+    gpuObjects.clear();
+
+    for (size_t first = 0; first < ordered.size();) {
+        GLuint texture = ordered[first]->getTexture();
+        size_t last = first;
+        GLuint vertexCapacity = 0, indexCapacity = 0;
+        for (; last < ordered.size() && ordered[last]->getTexture() == texture; last++) {
+            vertexCapacity = std::max(vertexCapacity, static_cast<GLuint>(ordered[last]->getVertices().size() / VERTEX_FLOATS));
+            indexCapacity = std::max(indexCapacity, static_cast<GLuint>(ordered[last]->getIndices().size()));
+        }
+        largestObject = std::max<size_t>(largestObject, vertexCapacity);
+
+        // Zapas slotów pozwala dodawać obiekty bez przebudowy, dopóki materiał nie zapełni się dwukrotnie
+        size_t objectCount = last - first;
+        size_t capacity = std::max(objectCount * 2, MIN_MATERIAL_SLOTS);
+        GLuint material = static_cast<GLuint>(materials.size());
+        materials.push_back({ texture, static_cast<GLsizei>(slots.size()), static_cast<GLsizei>(capacity), {} });
+
+        for (size_t k = 0; k < capacity; k++) {
+            GLuint index = static_cast<GLuint>(slots.size());
+            ObjectSlot slot = { nullptr, 0, 0, syncStamp, material, static_cast<GLint>(vertices.size()),
+                                static_cast<GLuint>(indices.size()), vertexCapacity, indexCapacity };
+            vertices.resize(vertices.size() + vertexCapacity);
+            indices.resize(indices.size() + indexCapacity);
+            movingBytes += vertexCapacity * sizeof(PackedVertex) + sizeof(GpuObject) + 2 * STAGING_ALIGNMENT;
+
+            if (k >= objectCount) {
+                commands.push_back({ 0, 0, slot.firstIndex, slot.baseVertex, index });
+                gpuObjects.push_back({ glm::vec4(0.0f), glm::vec4(0.0f) });
+                slots.push_back(slot);
+                continue;
+            }
+
+            const ShapeObject* object = ordered[first + k];
+            const std::vector<unsigned int>& objectIndices = object->getIndices();
+            const BoundingBox& bounds = object->getBounds();
+            slot.object = object;
+            slot.id = object->getId();
+            slot.revision = object->getRevision();
+            slotOfObject[slot.id] = index;
+
+            std::span<const float> objectVertices = object->getVertices();
+            for (size_t i = 0; i < objectVertices.size() / VERTEX_FLOATS; i++) {
+                vertices[slot.baseVertex + i] = VertexFormat::pack(objectVertices.data() + i * VERTEX_FLOATS);
+            }
+            std::copy(objectIndices.begin(), objectIndices.end(), indices.begin() + slot.firstIndex);
+            commands.push_back({ static_cast<GLuint>(objectIndices.size()), 1, slot.firstIndex, slot.baseVertex, index });
+            gpuObjects.push_back({ glm::vec4(bounds.min, 1.0f), glm::vec4(bounds.max, 1.0f) });
+            slots.push_back(slot);
+        }
+
+        // Wolne sloty wydawane od najniższego indeksu
+        for (size_t k = capacity; k > objectCount; k--) {
+            materials.back().freeSlots.push_back(static_cast<GLuint>(materials.back().first + k - 1));
+        }
+        first = last;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PackedVertex), vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    // Indeksy są lokalne dla obiektu (baseVertex), więc o typie decyduje największy obiekt
+    indexType = VertexFormat::uploadIndices(indices, largestObject, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, gpuObjects.size() * sizeof(GpuObject), gpuObjects.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, depthCommandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    // Pierścień mieści klatkę, w której ruszają się wszystkie sloty; spawny ponad to powiększą go same
+    staging.reserve(movingBytes);
+}
+
+void GpuScene::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) const {
+    for (ShapeObject* object : separateObjects) {
+        object->draw(shaderProgram, glm::mat4(1.0f), view, projection);
+    }
+    if (materials.empty()) {
+        return;
+    }
+
+    glUseProgram(shaderProgram);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glActiveTexture(GL_TEXTURE0);
+    for (const MaterialRange& material : materials) {
+        glBindTexture(GL_TEXTURE_2D, material.texture);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, (void*)(material.first * sizeof(DrawElementsIndirectCommand)), material.count, 0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+
+    glUseProgram(0);
+}
+
+void GpuScene::drawDepth(GLuint shaderProgram) const {
+    for (ShapeObject* object : separateObjects) {
+        object->draw(shaderProgram, glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f));
+    }
+    if (slots.empty()) {
+        return;
+    }
+
+    glUseProgram(shaderProgram);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+
+    // Wolne sloty mają zerową liczbę indeksów, więc cały zakres można narysować jednym wywołaniem
+    glBindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, depthCommandBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, nullptr, static_cast<GLsizei>(slots.size()), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+
+    glUseProgram(0);
+}
+
+void GpuScene::drawMasked(GLuint shaderProgram, GLint maskLocation, std::vector<MaskedDraw>& draws) {
+    std::sort(draws.begin(), draws.end(), [](const MaskedDraw& a, const MaskedDraw& b) {
+        return a.mask < b.mask;
+    });
+
+    // Obiekty spoza slotów rysowane są od razu, reszta trafia do poleceń pogrupowanych według maski
+    maskedCommands.clear();
+    maskedRuns.clear();
+    for (const MaskedDraw& draw : draws) {
+        auto found = slotOfObject.find(draw.object->getId());
+        if (found == slotOfObject.end()) {
+            glProgramUniform1i(shaderProgram, maskLocation, draw.mask);
+            draw.object->draw(shaderProgram, glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f));
+            continue;
+        }
+        const ObjectSlot& slot = slots[found->second];
+        maskedCommands.push_back({ static_cast<GLuint>(draw.object->getIndices().size()), 1, slot.firstIndex, slot.baseVertex, found->second });
+        if (maskedRuns.empty() || maskedRuns.back().first != draw.mask) {
+            maskedRuns.push_back({ draw.mask, 0 });
+        }
+        maskedRuns.back().second++;
+    }
+    if (maskedCommands.empty()) {
+        return;
+    }
+
+    glUseProgram(shaderProgram);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, maskedCommandBuffer);
+    // Osierocenie bufora - kolejne światło nie czeka na polecenia poprzedniego
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, maskedCommands.size() * sizeof(DrawElementsIndirectCommand), maskedCommands.data(), GL_STREAM_DRAW);
+    size_t first = 0;
+    for (const std::pair<int, GLsizei>& run : maskedRuns) {
+        glProgramUniform1i(shaderProgram, maskLocation, run.first);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, (void*)(first * sizeof(DrawElementsIndirectCommand)), run.second, 0);
+        first += run.second;
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+
+    glUseProgram(0);
+}
+
+GLuint GpuScene::getObjectBuffer() const {
+    return objectBuffer;
+}
+
+GLuint GpuScene::getCommandBuffer() const {
+    return commandBuffer;
+}
+
+GLuint GpuScene::getObjectCount() const {
+    return static_cast<GLuint>(slots.size());
+}
+
+size_t GpuScene::getDrawCallCount() const {
+    return materials.size() + separateObjects.size();
+}
+
+const StreamBuffer& GpuScene::getStagingBuffer() const {
+    return staging;
+}
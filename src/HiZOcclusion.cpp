@@ -0,0 +1,106 @@
+#include "HiZOcclusion.h"
+
+HiZOcclusion::HiZOcclusion(int width, int height)
+    : width(glm::max(width, 1)), height(glm::max(height, 1)) {
+    buildShader = new Shader("shaders/hiz_build_compute.glsl");
+    cullShader = new Shader("shaders/occlusion_cull_compute.glsl");
+    createPyramid();
+}
+
+HiZOcclusion::~HiZOcclusion() {
+    glDeleteTextures(1, &pyramidTexture);
+    delete buildShader;
+    delete cullShader;
+}
+
+void HiZOcclusion::createPyramid() {
+    glDeleteTextures(1, &pyramidTexture);
+
+    levelCount = 1;
+    while ((glm::max(width, height) >> levelCount) > 0) {
+        levelCount++;
+    }
+
+    glGenTextures(1, &pyramidTexture);
+    glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+    glTexStorage2D(GL_TEXTURE_2D, levelCount, GL_R32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    pyramidValid = false;
+}
+
+void HiZOcclusion::resize(int newWidth, int newHeight) {
+    newWidth = glm::max(newWidth, 1);
+    newHeight = glm::max(newHeight, 1);
+    if (newWidth == width && newHeight == height) {
+        return;
+    }
+    width = newWidth;
+    height = newHeight;
+    createPyramid();
+}
+
+void HiZOcclusion::buildPyramid(GLuint depthTexture, const glm::ivec2& renderSize, const glm::mat4& viewProjection) {
+    GLuint program = buildShader->getProgramID();
+    buildShader->use();
+
+    // Poziom 0: kopia wypełnionego fragmentu bufora głębokości, reszta traktowana jako daleka płaszczyzna
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glUniform1i(glGetUniformLocation(program, "depthTexture"), 0);
+    glUniform1i(glGetUniformLocation(program, "copyDepth"), 1);
+    glUniform2i(glGetUniformLocation(program, "renderSize"), renderSize.x, renderSize.y);
+    glBindImageTexture(1, pyramidTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+
+    glUniform1i(glGetUniformLocation(program, "copyDepth"), 0);
+    for (int level = 1; level < levelCount; level++) {
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        int levelWidth = glm::max(width >> level, 1);
+        int levelHeight = glm::max(height >> level, 1);
+        glBindImageTexture(0, pyramidTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        glBindImageTexture(1, pyramidTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glDispatchCompute((levelWidth + 7) / 8, (levelHeight + 7) / 8, 1);
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glUseProgram(0);
+
+    pyramidScale = glm::vec2(renderSize) / glm::vec2(width, height);
+    pyramidViewProjection = viewProjection;
+    pyramidValid = true;
+}
+
+void HiZOcclusion::cull(GLuint objectBuffer, GLuint commandBuffer, GLuint objectCount, const glm::mat4& viewProjection, bool testOcclusion) {
+    if (objectCount == 0) {
+        return;
+    }
+
+    GLuint program = cullShader->getProgramID();
+    cullShader->use();
+    glUniform1ui(glGetUniformLocation(program, "objectCount"), objectCount);
+    glUniformMatrix4fv(glGetUniformLocation(program, "viewProjection"), 1, GL_FALSE, glm::value_ptr(viewProjection));
+    glUniformMatrix4fv(glGetUniformLocation(program, "previousViewProjection"), 1, GL_FALSE, glm::value_ptr(pyramidViewProjection));
+    glUniform2fv(glGetUniformLocation(program, "hiZScale"), 1, glm::value_ptr(pyramidScale));
+    glUniform1i(glGetUniformLocation(program, "hiZLevels"), levelCount);
+    glUniform1i(glGetUniformLocation(program, "testOcclusion"), testOcclusion && pyramidValid);
+    glUniform1i(glGetUniformLocation(program, "hiZ"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+    glDispatchCompute((objectCount + 63) / 64, 1, 1);
+
+    // Polecenia rysowania czytane są przez GPU dopiero po zakończeniu zapisu
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    glUseProgram(0);
+}
+
+GLuint HiZOcclusion::getPyramidTexture() const {
+    return pyramidTexture;
+}
@@ -0,0 +1,97 @@
+#include "JobSystem.h"
+#include "SceneGraph.h"
+#include "Frustum.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int GROUPS = 1000, GROUP_SIZE = 99;
+const size_t BOX_COUNT = 1000000;
+const int ITERATIONS = 50;
+
+template <typename F>
+double measure(F&& function) {
+    function();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        function();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / ITERATIONS;
+}
+
+}
+
+int main(int argc, char** argv) {
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxThreads = std::max(1, std::atoi(argv[1]));
+    }
+
+    SceneGraph graph;
+    SceneGraph::Node root = graph.createNode();
+    for (int group = 0; group < GROUPS; group++) {
+        SceneGraph::Node groupNode = graph.createNode(root);
+        graph.setPosition(groupNode, glm::vec3(group % 32, 0.0f, group / 32));
+        for (int child = 0; child < GROUP_SIZE; child++) {
+            graph.setPosition(graph.createNode(groupNode), glm::vec3(0.0f, child * 0.1f, 0.0f));
+        }
+    }
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+    std::vector<BoundingBox> boxes(BOX_COUNT);
+    for (BoundingBox& box : boxes) {
+        glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+        box.expand(center - glm::vec3(0.5f));
+        box.expand(center + glm::vec3(0.5f));
+    }
+    Frustum frustum(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f)
+                    * glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    std::vector<uint8_t> visible(BOX_COUNT);
+
+    std::cout << graph.getNodeCount() << " scene graph nodes, " << BOX_COUNT << " boxes, " << ITERATIONS << " iterations" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "graph ms" << std::setw(10) << "speedup"
+              << std::setw(14) << "cull ms" << std::setw(10) << "speedup" << std::endl;
+
+    double graphBase = 0.0, cullBase = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads = threads < maxThreads ? std::min(threads * 2, maxThreads) : threads + 1) {
+        JobSystem jobs(threads);
+
+        double graphTime = measure([&]() {
+            graph.rotate(root, 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+            graph.update(&jobs);
+        });
+
+        std::atomic<size_t> visibleCount{ 0 };
+        double cullTime = measure([&]() {
+            visibleCount = 0;
+            jobs.parallelFor(BOX_COUNT, 4096, [&](size_t begin, size_t end) {
+                size_t count = 0;
+                for (size_t i = begin; i < end; i++) {
+                    visible[i] = frustum.intersectsBox(boxes[i]);
+                    count += visible[i];
+                }
+                visibleCount.fetch_add(count, std::memory_order_relaxed);
+            });
+        });
+
+        if (threads == 1) {
+            graphBase = graphTime;
+            cullBase = cullTime;
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(8) << threads << std::setw(14) << graphTime << std::setw(9) << graphBase / graphTime << "x"
+                  << std::setw(14) << cullTime << std::setw(9) << cullBase / cullTime << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace {
+
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local unsigned int currentWorker = 0;
+
+}
+
+JobSystem::JobSystem(unsigned int threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned int i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    currentSystem = this;
+    currentWorker = 0;
+    for (unsigned int i = 1; i < threadCount; i++) {
+        threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wakeUp.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (currentSystem == this) {
+        currentSystem = nullptr;
+    }
+}
+
+unsigned int JobSystem::currentIndex() const {
+    return currentSystem == this ? currentWorker : 0;
+}
+
+void JobSystem::run(std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push({ std::move(job), counter });
+}
+
+void JobSystem::runAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (dependency.pending.load(std::memory_order_acquire) > 0) {
+            dependency.continuations.push_back({ std::move(job), counter });
+            return;
+        }
+    }
+    push({ std::move(job), counter });
+}
+
+void JobSystem::push(Job job) {
+    WorkerQueue& queue = *queues[currentIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queuedJobs.fetch_add(1, std::memory_order_release);
+
+    // Pusta sekcja krytyczna zapobiega zgubieniu pobudki wątku, który właśnie sprawdził warunek snu
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wakeUp.notify_one();
+}
+
+bool JobSystem::pop(unsigned int index, Job& job) {
+    {
+        WorkerQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Kradzież najstarszego zadania - zwykle największego kawałka pracy ofiary
+    unsigned int count = static_cast<unsigned int>(queues.size());
+    for (unsigned int offset = 1; offset < count; offset++) {
+        WorkerQueue& victim = *queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            stealCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    job.function();
+    if (!job.counter) {
+        return;
+    }
+
+    std::vector<JobCounter::Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(job.counter->mutex);
+        if (job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(job.counter->continuations);
+        }
+    }
+    for (JobCounter::Continuation& continuation : ready) {
+        push({ std::move(continuation.function), continuation.counter });
+    }
+}
+
+void JobSystem::workerLoop(unsigned int index) {
+    currentSystem = this;
+    currentWorker = index;
+
+    while (true) {
+        Job job;
+        if (pop(index, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() {
+            return queuedJobs.load(std::memory_order_acquire) > 0 || !running;
+        });
+        if (!running && queuedJobs.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    unsigned int index = currentIndex();
+    while (!counter.isDone()) {
+        Job job;
+        if (pop(index, job)) {
+            execute(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    // Ostatnie zadanie mogło jeszcze trzymać blokadę licznika - po niej licznik można zniszczyć
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    // Kilka porcji na wątek, żeby kradzież wyrównała nierówny koszt elementów
+    size_t chunk = std::max(grain, (count + queues.size() * 4 - 1) / (queues.size() * 4));
+    chunk = (chunk + grain - 1) / grain * grain;
+    if (chunk >= count || queues.size() == 1) {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+        size_t end = std::min(count, begin + chunk);
+        run([&body, begin, end]() { body(begin, end); }, &counter);
+    }
+    body(0, chunk);
+    wait(counter);
+}
+
+unsigned int JobSystem::getThreadCount() const {
+    return static_cast<unsigned int>(queues.size());
+}
+
+size_t JobSystem::getStealCount() const {
+    return stealCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,65 @@
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjImporter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    bool packed = true;
+    bool optimize = true;
+    bool generateLods = true;
+    int first = 1;
+    for (; first < argc && argv[first][0] == '-'; first++) {
+        std::string option = argv[first];
+        if (option == "--float") {
+            packed = false;
+        }
+        else if (option == "--no-optimize") {
+            optimize = false;
+        }
+        else if (option == "--no-lod") {
+            generateLods = false;
+        }
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    if (argc - first < 2) {
+        std::cerr << "Usage: MeshConverter [--float] [--no-optimize] [--no-lod] <input.obj> <output.mesh>" << std::endl;
+        return 1;
+    }
+    const char* input = argv[first];
+    const char* output = argv[first + 1];
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    MeshData mesh;
+    if (!ObjImporter::load(input, mesh)) {
+        return 1;
+    }
+    if (generateLods) {
+        MeshSimplifier::generateLods(mesh);
+        for (size_t i = 0; i < mesh.lods.size(); i++) {
+            std::cout << "LOD " << i << ": " << mesh.lods[i].indexCount / 3 << " triangles, error " << mesh.lods[i].error << std::endl;
+        }
+    }
+    if (optimize) {
+        MeshOptimizationStats stats = MeshOptimizer::optimize(mesh);
+        std::cout << "Vertices: " << stats.verticesBefore << " -> " << stats.verticesAfter
+                  << ", ACMR: " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+    }
+    if (!MeshFile::write(output, mesh, packed ? MESH_VERTEX_FORMAT_PACKED : MESH_VERTEX_FORMAT_FLOAT)) {
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << input << " -> " << output << ": " << mesh.vertices.size() / 8 << " vertices, "
+              << mesh.indices.size() / 3 << " triangles, " << mesh.submeshes.size() << " submeshes, "
+              << std::max<size_t>(mesh.lods.size(), 1) << " LODs, " << (packed ? "packed" : "float") << " vertices (" << elapsed << " ms)" << std::endl;
+    return 0;
+}
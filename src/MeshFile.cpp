@@ -0,0 +1,198 @@
+#include "MeshFile.h"
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+bool MeshFile::open(const std::string& path) {
+    close();
+
+    if (!file.open(path)) {
+        return false;
+    }
+    data = file.getData();
+    size_t size = file.getSize();
+
+    if (size < sizeof(MeshFileHeader)) {
+        std::cerr << "Mesh file is truncated: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    const MeshFileHeader& header = getHeader();
+    if (std::memcmp(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC)) != 0 || header.version != MESH_FILE_VERSION) {
+        std::cerr << "Unsupported mesh file format or version: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    uint32_t expectedStride = header.vertexFormat == MESH_VERTEX_FORMAT_PACKED ? sizeof(PackedVertex) : VERTEX_FLOATS * sizeof(float);
+    bool knownFormat = header.vertexFormat == MESH_VERTEX_FORMAT_FLOAT || header.vertexFormat == MESH_VERTEX_FORMAT_PACKED;
+    if (!knownFormat || header.vertexStride != expectedStride || (header.indexSize != 2 && header.indexSize != 4)) {
+        std::cerr << "Unsupported mesh vertex or index format: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Sekcje czytane są wprost jako tablice, więc przesunięcia muszą zachować wyrównanie rekordów
+    uint64_t misaligned = (header.vertexOffset | header.indexOffset | header.submeshOffset | header.lodOffset) % MESH_FILE_ALIGNMENT;
+    if (misaligned != 0 || !file.containsRange(header.vertexOffset, header.vertexCount, header.vertexStride)
+        || !file.containsRange(header.indexOffset, header.indexCount, header.indexSize)
+        || !file.containsRange(header.submeshOffset, header.submeshCount, sizeof(MeshSubmesh))
+        || !file.containsRange(header.lodOffset, header.lodCount, sizeof(MeshLod))) {
+        std::cerr << "Mesh file sections are misaligned or exceed file size: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Zakresy podsiatek i wartości indeksów trafiają wprost do glDrawElements - błędne oznaczałyby odczyt poza buforami GPU
+    for (uint32_t i = 0; i < header.submeshCount; i++) {
+        const MeshSubmesh& submesh = getSubmeshes()[i];
+        if (uint64_t(submesh.firstIndex) + submesh.indexCount > header.indexCount) {
+            std::cerr << "Mesh file submesh exceeds the index section: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    uint32_t largestIndex = 0;
+    if (header.indexSize == 2) {
+        const uint16_t* indices = static_cast<const uint16_t*>(getIndexData());
+        for (uint32_t i = 0; i < header.indexCount; i++) {
+            largestIndex = std::max<uint32_t>(largestIndex, indices[i]);
+        }
+    }
+    else {
+        const uint32_t* indices = static_cast<const uint32_t*>(getIndexData());
+        for (uint32_t i = 0; i < header.indexCount; i++) {
+            largestIndex = std::max(largestIndex, indices[i]);
+        }
+    }
+    if (header.indexCount > 0 && largestIndex >= header.vertexCount) {
+        std::cerr << "Mesh file indices reference missing vertices: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    if (header.lodCount == 0) {
+        std::cerr << "Mesh file has no levels of detail: " << path << std::endl;
+        close();
+        return false;
+    }
+    for (uint32_t i = 0; i < header.lodCount; i++) {
+        const MeshLod& lod = getLods()[i];
+        if (uint64_t(lod.firstSubmesh) + lod.submeshCount > header.submeshCount) {
+            std::cerr << "Mesh file LOD references missing submeshes: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void MeshFile::close() {
+    file.close();
+    data = nullptr;
+}
+
+const MeshFileHeader& MeshFile::getHeader() const {
+    return *reinterpret_cast<const MeshFileHeader*>(data);
+}
+
+const void* MeshFile::getVertexData() const {
+    return data + getHeader().vertexOffset;
+}
+
+const void* MeshFile::getIndexData() const {
+    return data + getHeader().indexOffset;
+}
+
+const MeshSubmesh* MeshFile::getSubmeshes() const {
+    return reinterpret_cast<const MeshSubmesh*>(data + getHeader().submeshOffset);
+}
+
+const MeshLod* MeshFile::getLods() const {
+    return reinterpret_cast<const MeshLod*>(data + getHeader().lodOffset);
+}
+
+bool MeshFile::write(const std::string& path, const MeshData& mesh, uint32_t vertexFormat) {
+    auto align = [](uint64_t offset) {
+        return (offset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+    };
+
+    bool packed = vertexFormat == MESH_VERTEX_FORMAT_PACKED;
+    size_t vertexCount = mesh.vertices.size() / VERTEX_FLOATS;
+    bool shortIndices = packed && VertexFormat::fitsShortIndices(vertexCount);
+
+    MeshFileHeader header = {};
+    std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC));
+    header.version = MESH_FILE_VERSION;
+    header.vertexCount = static_cast<uint32_t>(vertexCount);
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+    header.vertexStride = packed ? sizeof(PackedVertex) : VERTEX_FLOATS * sizeof(float);
+    header.vertexFormat = packed ? MESH_VERTEX_FORMAT_PACKED : MESH_VERTEX_FORMAT_FLOAT;
+    header.indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    std::vector<MeshLod> lods = mesh.lods;
+    if (lods.empty()) {
+        lods.push_back({ 0, static_cast<uint32_t>(mesh.submeshes.size()), static_cast<uint32_t>(mesh.indices.size()), 0.0f });
+    }
+    header.lodCount = static_cast<uint32_t>(lods.size());
+
+    for (int axis = 0; axis < 3; axis++) {
+        header.boundsMin[axis] = FLT_MAX;
+        header.boundsMax[axis] = -FLT_MAX;
+    }
+    for (size_t i = 0; i + 2 < mesh.vertices.size(); i += VERTEX_FLOATS) {
+        for (int axis = 0; axis < 3; axis++) {
+            header.boundsMin[axis] = std::min(header.boundsMin[axis], mesh.vertices[i + axis]);
+            header.boundsMax[axis] = std::max(header.boundsMax[axis], mesh.vertices[i + axis]);
+        }
+    }
+
+    std::vector<PackedVertex> packedVertices;
+    std::vector<uint16_t> shortIndexData;
+    const void* vertexData = mesh.vertices.data();
+    const void* indexData = mesh.indices.data();
+    if (packed) {
+        packedVertices = VertexFormat::pack(mesh.vertices);
+        vertexData = packedVertices.data();
+    }
+    if (shortIndices) {
+        shortIndexData = VertexFormat::packIndices(mesh.indices);
+        indexData = shortIndexData.data();
+    }
+    uint64_t vertexBytes = uint64_t(header.vertexCount) * header.vertexStride;
+    uint64_t indexBytes = uint64_t(header.indexCount) * header.indexSize;
+
+    header.vertexOffset = align(sizeof(MeshFileHeader));
+    header.indexOffset = align(header.vertexOffset + vertexBytes);
+    header.submeshOffset = align(header.indexOffset + indexBytes);
+    header.lodOffset = align(header.submeshOffset + mesh.submeshes.size() * sizeof(MeshSubmesh));
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open mesh file for writing: " << path << std::endl;
+        return false;
+    }
+
+    auto pad = [&file](uint64_t offset) {
+        static const char zeros[MESH_FILE_ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        file.write(zeros, static_cast<std::streamsize>(offset - position));
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad(header.vertexOffset);
+    file.write(static_cast<const char*>(vertexData), static_cast<std::streamsize>(vertexBytes));
+    pad(header.indexOffset);
+    file.write(static_cast<const char*>(indexData), static_cast<std::streamsize>(indexBytes));
+    pad(header.submeshOffset);
+    file.write(reinterpret_cast<const char*>(mesh.submeshes.data()), mesh.submeshes.size() * sizeof(MeshSubmesh));
+    pad(header.lodOffset);
+    file.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(MeshLod));
+    return file.good();
+}
@@ -0,0 +1,215 @@
+#include "MeshOptimizer.h"
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+struct VertexKey {
+    const float* data;
+
+    bool operator==(const VertexKey& other) const {
+        return std::memcmp(data, other.data, VERTEX_FLOATS * sizeof(float)) == 0;
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < VERTEX_FLOATS; i++) {
+            uint32_t bits;
+            std::memcpy(&bits, &key.data[i], sizeof(bits));
+            hash = (hash ^ bits) * 16777619u;
+        }
+        return hash;
+    }
+};
+
+class Tipsify {
+public:
+    Tipsify(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t cacheSize)
+        : indices(indices), triangleCount(indexCount / 3), vertexCount(vertexCount), cacheSize(cacheSize),
+          liveTriangles(vertexCount, 0), cacheTime(vertexCount, 0), emitted(indexCount / 3, false) {
+        // Lista trójkątów sąsiadujących z każdym wierzchołkiem (CSR)
+        adjacencyOffsets.assign(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            liveTriangles[indices[i]]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+        }
+        adjacency.resize(triangleCount * 3);
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<uint32_t> run() {
+        std::vector<uint32_t> output;
+        output.reserve(triangleCount * 3);
+        if (triangleCount == 0) {
+            return output;
+        }
+
+        long long fanning = indices[0];
+        size_t timestamp = cacheSize + 1;
+        while (fanning >= 0) {
+            candidates.clear();
+            for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++) {
+                uint32_t triangle = adjacency[a];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                for (int corner = 0; corner < 3; corner++) {
+                    uint32_t v = indices[triangle * 3 + corner];
+                    output.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (timestamp - cacheTime[v] > cacheSize) {
+                        cacheTime[v] = timestamp++;
+                    }
+                }
+                emitted[triangle] = true;
+            }
+            fanning = nextVertex(timestamp);
+        }
+        return output;
+    }
+
+private:
+    long long nextVertex(size_t timestamp) {
+        // Najlepszy kandydat to wierzchołek, który po wyemitowaniu jego trójkątów wciąż będzie w pamięci podręcznej
+        long long best = -1;
+        long long bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (liveTriangles[v] == 0) {
+                continue;
+            }
+            long long priority = 0;
+            if (timestamp - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                priority = static_cast<long long>(timestamp - cacheTime[v]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+        return best >= 0 ? best : skipDeadEnd();
+    }
+
+    long long skipDeadEnd() {
+        while (!deadEnds.empty()) {
+            uint32_t v = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[v] > 0) {
+                return v;
+            }
+        }
+        while (cursor < vertexCount) {
+            if (liveTriangles[cursor] > 0) {
+                return static_cast<long long>(cursor++);
+            }
+            cursor++;
+        }
+        return -1;
+    }
+
+    const uint32_t* indices;
+    size_t triangleCount;
+    size_t vertexCount;
+    size_t cacheSize;
+    size_t cursor = 0;
+    std::vector<uint32_t> liveTriangles;
+    std::vector<size_t> cacheTime;
+    std::vector<bool> emitted;
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> deadEnds;
+};
+
+}
+
+MeshOptimizationStats MeshOptimizer::optimize(MeshData& mesh) {
+    MeshOptimizationStats stats;
+    stats.verticesBefore = mesh.vertices.size() / VERTEX_FLOATS;
+    stats.acmrBefore = computeAcmr(mesh.indices, stats.verticesBefore);
+
+    deduplicateVertices(mesh);
+    optimizeVertexCache(mesh);
+    optimizeVertexFetch(mesh);
+
+    stats.verticesAfter = mesh.vertices.size() / VERTEX_FLOATS;
+    stats.acmrAfter = computeAcmr(mesh.indices, stats.verticesAfter);
+    return stats;
+}
+
+void MeshOptimizer::deduplicateVertices(MeshData& mesh) {
+    size_t vertexCount = mesh.vertices.size() / VERTEX_FLOATS;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<float> unique;
+    unique.reserve(mesh.vertices.size());
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> lookup;
+    lookup.reserve(vertexCount);
+
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* vertex = &mesh.vertices[v * VERTEX_FLOATS];
+        auto inserted = lookup.emplace(VertexKey{ vertex }, static_cast<uint32_t>(unique.size() / VERTEX_FLOATS));
+        if (inserted.second) {
+            unique.insert(unique.end(), vertex, vertex + VERTEX_FLOATS);
+        }
+        remap[v] = inserted.first->second;
+    }
+
+    for (uint32_t& index : mesh.indices) {
+        index = remap[index];
+    }
+    mesh.vertices.swap(unique);
+}
+
+void MeshOptimizer::optimizeVertexCache(MeshData& mesh, size_t cacheSize) {
+    size_t vertexCount = mesh.vertices.size() / VERTEX_FLOATS;
+    for (const MeshSubmesh& submesh : mesh.submeshes) {
+        uint32_t* first = mesh.indices.data() + submesh.firstIndex;
+        std::vector<uint32_t> ordered = Tipsify(first, submesh.indexCount, vertexCount, cacheSize).run();
+        std::copy(ordered.begin(), ordered.end(), first);
+    }
+}
+
+void MeshOptimizer::optimizeVertexFetch(MeshData& mesh) {
+    const uint32_t unassigned = UINT32_MAX;
+    std::vector<uint32_t> remap(mesh.vertices.size() / VERTEX_FLOATS, unassigned);
+    std::vector<float> ordered;
+    ordered.reserve(mesh.vertices.size());
+
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == unassigned) {
+            remap[index] = static_cast<uint32_t>(ordered.size() / VERTEX_FLOATS);
+            const float* vertex = &mesh.vertices[size_t(index) * VERTEX_FLOATS];
+            ordered.insert(ordered.end(), vertex, vertex + VERTEX_FLOATS);
+        }
+        index = remap[index];
+    }
+    mesh.vertices.swap(ordered);
+}
+
+float MeshOptimizer::computeAcmr(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize) {
+    if (indices.size() < 3) {
+        return 0.0f;
+    }
+
+    // Kolejka FIFO: wierzchołek jest w pamięci podręcznej, jeśli trafił do niej w ostatnich cacheSize chybieniach
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    size_t misses = 0;
+    for (uint32_t index : indices) {
+        if (insertedAt[index] == 0 || misses + 1 - insertedAt[index] > cacheSize) {
+            misses++;
+            insertedAt[index] = misses;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
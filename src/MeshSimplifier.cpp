@@ -0,0 +1,330 @@
+#include "MeshSimplifier.h"
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+struct Vector3 {
+    double x, y, z;
+
+    Vector3 operator-(const Vector3& other) const { return { x - other.x, y - other.y, z - other.z }; }
+    double dot(const Vector3& other) const { return x * other.x + y * other.y + z * other.z; }
+    Vector3 cross(const Vector3& other) const {
+        return { y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x };
+    }
+    double length() const { return std::sqrt(dot(*this)); }
+};
+
+// Symetryczna macierz 4x4 zapisana jako górny trójkąt
+struct Quadric {
+    double a[10] = {};
+
+    void addPlane(const Vector3& n, double d) {
+        double p[4] = { n.x, n.y, n.z, d };
+        int k = 0;
+        for (int i = 0; i < 4; i++) {
+            for (int j = i; j < 4; j++) {
+                a[k++] += p[i] * p[j];
+            }
+        }
+    }
+
+    void add(const Quadric& other) {
+        for (int i = 0; i < 10; i++) {
+            a[i] += other.a[i];
+        }
+    }
+
+    double evaluate(const Vector3& v) const {
+        return a[0] * v.x * v.x + 2 * a[1] * v.x * v.y + 2 * a[2] * v.x * v.z + 2 * a[3] * v.x
+             + a[4] * v.y * v.y + 2 * a[5] * v.y * v.z + 2 * a[6] * v.y
+             + a[7] * v.z * v.z + 2 * a[8] * v.z
+             + a[9];
+    }
+};
+
+struct PositionKey {
+    uint32_t bits[3];
+
+    bool operator==(const PositionKey& other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const {
+        return (size_t(key.bits[0]) * 73856093u) ^ (size_t(key.bits[1]) * 19349663u) ^ (size_t(key.bits[2]) * 83492791u);
+    }
+};
+
+struct Triangle {
+    uint32_t v[3];
+    uint32_t submesh;
+    bool alive;
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+struct EdgeInfo {
+    uint32_t triangles;
+    uint32_t submesh;
+    bool mixed;
+    uint32_t records[2];    // Rekordy końców krawędzi w pierwszym trójkącie (kolejno mniejsza i większa pozycja)
+};
+
+class Simplifier {
+public:
+    explicit Simplifier(const MeshData& mesh) : vertices(mesh.vertices) {
+        size_t vertexCount = mesh.vertices.size() / VERTEX_FLOATS;
+        positions.resize(vertexCount);
+        canonical.resize(vertexCount);
+        records.resize(vertexCount);
+
+        // Wierzchołki o tej samej pozycji (szwy UV/normalnych) dzielą jedną kwadrykę i zwijane są razem
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> positionLookup;
+        for (size_t v = 0; v < vertexCount; v++) {
+            const float* p = &mesh.vertices[v * VERTEX_FLOATS];
+            positions[v] = { p[0], p[1], p[2] };
+            PositionKey key;
+            std::memcpy(key.bits, p, sizeof(key.bits));
+            canonical[v] = positionLookup.emplace(key, static_cast<uint32_t>(v)).first->second;
+            records[canonical[v]].push_back(static_cast<uint32_t>(v));
+        }
+
+        for (size_t s = 0; s < mesh.submeshes.size(); s++) {
+            const MeshSubmesh& submesh = mesh.submeshes[s];
+            for (uint32_t i = submesh.firstIndex; i + 2 < submesh.firstIndex + submesh.indexCount; i += 3) {
+                triangles.push_back({ { mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2] }, static_cast<uint32_t>(s), true });
+            }
+        }
+        aliveTriangles = triangles.size();
+
+        quadrics.resize(vertexCount);
+        locked.assign(vertexCount, false);
+        std::unordered_map<uint64_t, EdgeInfo> edges;
+        for (const Triangle& triangle : triangles) {
+            Vector3 normal = (positions[triangle.v[1]] - positions[triangle.v[0]]).cross(positions[triangle.v[2]] - positions[triangle.v[0]]);
+            double length = normal.length();
+            if (length > 0.0) {
+                normal = { normal.x / length, normal.y / length, normal.z / length };
+                double d = -normal.dot(positions[triangle.v[0]]);
+                for (uint32_t corner : triangle.v) {
+                    quadrics[canonical[corner]].addPlane(normal, d);
+                }
+            }
+            for (int e = 0; e < 3; e++) {
+                uint32_t first = triangle.v[e];
+                uint32_t second = triangle.v[(e + 1) % 3];
+                if (canonical[second] < canonical[first]) {
+                    std::swap(first, second);
+                }
+                uint64_t key = (uint64_t(canonical[first]) << 32) | canonical[second];
+                auto inserted = edges.emplace(key, EdgeInfo{ 0, triangle.submesh, false, { first, second } });
+                EdgeInfo& edge = inserted.first->second;
+                edge.triangles++;
+                edge.mixed |= edge.submesh != triangle.submesh;
+                // Szew UV: sąsiednie trójkąty mają na tej krawędzi różne współrzędne tekstury
+                edge.mixed |= !inserted.second && (!sameUv(edge.records[0], first) || !sameUv(edge.records[1], second));
+            }
+        }
+
+        // Brzegi, krawędzie niemanifoldowe, szwy UV i granice podsiatek nie mogą się przesuwać;
+        // nieciągłości samych normalnych (twarde krawędzie) nie blokują zwijania
+        for (const auto& edge : edges) {
+            if (edge.second.triangles != 2 || edge.second.mixed) {
+                locked[edge.first >> 32] = true;
+                locked[edge.first & 0xffffffffu] = true;
+            }
+        }
+    }
+
+    size_t getTriangleCount() const {
+        return aliveTriangles;
+    }
+
+    double getMaxError() const {
+        return std::sqrt(maxCost);
+    }
+
+    bool simplify(size_t targetTriangles) {
+        size_t start = aliveTriangles;
+        while (aliveTriangles > targetTriangles) {
+            if (!collapsePass(targetTriangles)) {
+                break;
+            }
+        }
+        return aliveTriangles < start;
+    }
+
+    void appendLod(MeshData& mesh, uint32_t submeshCount) {
+        MeshLod lod = { static_cast<uint32_t>(mesh.submeshes.size()), submeshCount, 0, static_cast<float>(getMaxError()) };
+        for (uint32_t s = 0; s < submeshCount; s++) {
+            MeshSubmesh submesh = mesh.submeshes[s];
+            submesh.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+            for (const Triangle& triangle : triangles) {
+                if (triangle.alive && triangle.submesh == s) {
+                    mesh.indices.insert(mesh.indices.end(), { triangle.v[0], triangle.v[1], triangle.v[2] });
+                }
+            }
+            submesh.indexCount = static_cast<uint32_t>(mesh.indices.size()) - submesh.firstIndex;
+            lod.indexCount += submesh.indexCount;
+            mesh.submeshes.push_back(submesh);
+        }
+        mesh.lods.push_back(lod);
+    }
+
+private:
+    bool collapsible(uint32_t v) const {
+        return !locked[canonical[v]];
+    }
+
+    bool sameUv(uint32_t a, uint32_t b) const {
+        return vertices[a * VERTEX_FLOATS + 3] == vertices[b * VERTEX_FLOATS + 3] && vertices[a * VERTEX_FLOATS + 4] == vertices[b * VERTEX_FLOATS + 4];
+    }
+
+    // Rekord pozycji `position`, który najlepiej zastępuje `record` - ta sama współrzędna UV, najbliższa normalna
+    uint32_t closestRecord(uint32_t record, uint32_t position) const {
+        const float* source = &vertices[record * VERTEX_FLOATS];
+        uint32_t best = records[position].front();
+        double bestScore = -1e30;
+        for (uint32_t candidate : records[position]) {
+            const float* target = &vertices[candidate * VERTEX_FLOATS];
+            double score = source[5] * target[5] + source[6] * target[6] + source[7] * target[7];
+            if (!sameUv(record, candidate)) {
+                score -= 4.0;
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    bool flipsTriangle(uint32_t from, uint32_t to, const std::vector<uint32_t>& around) const {
+        uint32_t source = canonical[from];
+        uint32_t target = canonical[to];
+        for (uint32_t t : around) {
+            const Triangle& triangle = triangles[t];
+            if (!triangle.alive || canonical[triangle.v[0]] == target || canonical[triangle.v[1]] == target || canonical[triangle.v[2]] == target) {
+                continue;
+            }
+            Vector3 before[3];
+            Vector3 after[3];
+            for (int corner = 0; corner < 3; corner++) {
+                before[corner] = positions[triangle.v[corner]];
+                after[corner] = canonical[triangle.v[corner]] == source ? positions[to] : before[corner];
+            }
+            Vector3 n0 = (before[1] - before[0]).cross(before[2] - before[0]);
+            Vector3 n1 = (after[1] - after[0]).cross(after[2] - after[0]);
+            if (n0.dot(n1) <= 0.25 * n0.length() * n1.length()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool collapsePass(size_t targetTriangles) {
+        std::vector<std::vector<uint32_t>> around(positions.size());
+        std::vector<Collapse> candidates;
+        for (uint32_t t = 0; t < triangles.size(); t++) {
+            const Triangle& triangle = triangles[t];
+            if (!triangle.alive) {
+                continue;
+            }
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = triangle.v[e];
+                uint32_t b = triangle.v[(e + 1) % 3];
+                around[canonical[a]].push_back(t);
+                Quadric combined = quadrics[canonical[a]];
+                combined.add(quadrics[canonical[b]]);
+                if (collapsible(a)) {
+                    candidates.push_back({ a, b, combined.evaluate(positions[b]) });
+                }
+                if (collapsible(b)) {
+                    candidates.push_back({ b, a, combined.evaluate(positions[a]) });
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) {
+            return a.cost < b.cost;
+        });
+
+        // W jednym przebiegu każda pozycja (i jej otoczenie) bierze udział w co najwyżej jednym zwinięciu
+        std::vector<bool> touched(positions.size(), false);
+        bool collapsed = false;
+        for (const Collapse& collapse : candidates) {
+            if (aliveTriangles <= targetTriangles) {
+                break;
+            }
+            uint32_t source = canonical[collapse.from];
+            uint32_t target = canonical[collapse.to];
+            if (touched[source] || touched[target] || flipsTriangle(collapse.from, collapse.to, around[source])) {
+                continue;
+            }
+
+            // Wszystkie rekordy pozycji zwijane są razem; każdy przechodzi na rekord celu o zgodnych atrybutach
+            for (uint32_t t : around[source]) {
+                Triangle& triangle = triangles[t];
+                if (!triangle.alive) {
+                    continue;
+                }
+                for (uint32_t& corner : triangle.v) {
+                    touched[canonical[corner]] = true;
+                    if (canonical[corner] == source) {
+                        corner = closestRecord(corner, target);
+                    }
+                }
+                uint32_t a = canonical[triangle.v[0]], b = canonical[triangle.v[1]], c = canonical[triangle.v[2]];
+                if (a == b || b == c || a == c) {
+                    triangle.alive = false;
+                    aliveTriangles--;
+                }
+            }
+            quadrics[canonical[collapse.to]].add(quadrics[canonical[collapse.from]]);
+            maxCost = std::max(maxCost, std::max(collapse.cost, 0.0));
+            collapsed = true;
+        }
+        return collapsed;
+    }
+
+    const std::vector<float>& vertices;
+    std::vector<Vector3> positions;
+    std::vector<uint32_t> canonical;
+    std::vector<std::vector<uint32_t>> records;
+    std::vector<bool> locked;
+    std::vector<Quadric> quadrics;
+    std::vector<Triangle> triangles;
+    size_t aliveTriangles = 0;
+    double maxCost = 0.0;
+};
+
+}
+
+void MeshSimplifier::generateLods(MeshData& mesh, uint32_t maxLods, float reduction) {
+    if (!mesh.lods.empty() || mesh.indices.empty()) {
+        return;
+    }
+
+    uint32_t submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+    mesh.lods.push_back({ 0, submeshCount, static_cast<uint32_t>(mesh.indices.size()), 0.0f });
+
+    Simplifier simplifier(mesh);
+    while (mesh.lods.size() < maxLods) {
+        size_t previous = simplifier.getTriangleCount();
+        size_t target = static_cast<size_t>(previous * reduction);
+        // Poziom, który usuwa mniej niż 10% trójkątów, nie jest wart dodatkowych indeksów
+        if (!simplifier.simplify(target) || simplifier.getTriangleCount() > previous * 9 / 10) {
+            break;
+        }
+        simplifier.appendLod(mesh, submeshCount);
+    }
+}
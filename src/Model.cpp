@@ -0,0 +1,128 @@
+#include "Model.h"
+
+#include <algorithm>
+
+Model::Model(GLuint texture)
+    : texture(texture) {
+}
+
+Model::~Model() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+}
+
+bool Model::load(const std::string& path) {
+    MeshFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const MeshFileHeader& header = file.getHeader();
+
+    if (!vao) {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+    }
+
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(header.vertexCount) * header.vertexStride, file.getVertexData(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(header.indexCount) * header.indexSize, file.getIndexData(), GL_STATIC_DRAW);
+
+    if (header.vertexFormat == MESH_VERTEX_FORMAT_PACKED) {
+        VertexFormat::setupAttributes();
+    }
+    else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, header.vertexStride, (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, header.vertexStride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, header.vertexStride, (void*)(5 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+    }
+
+    glBindVertexArray(0);
+
+    indexSize = static_cast<GLsizei>(header.indexSize);
+    indexType = header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    bounds = BoundingBox();
+    bounds.expand(glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]));
+    bounds.expand(glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]));
+    submeshes.assign(file.getSubmeshes(), file.getSubmeshes() + header.submeshCount);
+    lods.assign(file.getLods(), file.getLods() + header.lodCount);
+    currentLod = 0;
+    return true;
+}
+
+void Model::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
+    if (!vao) {
+        return;
+    }
+
+    glUseProgram(shaderProgram);
+
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+
+    if (texture != 0) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    glBindVertexArray(vao);
+    const MeshLod& lod = lods[currentLod];
+    for (uint32_t i = lod.firstSubmesh; i < lod.firstSubmesh + lod.submeshCount; i++) {
+        const MeshSubmesh& submesh = submeshes[i];
+        glDrawElements(GL_TRIANGLES, submesh.indexCount, indexType, (void*)(size_t(submesh.firstIndex) * indexSize));
+    }
+    glBindVertexArray(0);
+
+    glUseProgram(0);
+}
+
+const BoundingBox& Model::getBounds() const {
+    return bounds;
+}
+
+void Model::selectLod(const glm::mat4& model, const glm::vec3& cameraPosition, const glm::mat4& projection, float viewportHeight, float maxPixelError) {
+    currentLod = 0;
+    if (lods.size() < 2) {
+        return;
+    }
+
+    float scale = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    glm::vec3 center = glm::vec3(model * glm::vec4(bounds.getCenter(), 1.0f));
+    float radius = glm::length(bounds.getExtents()) * scale;
+    float distance = glm::length(cameraPosition - center) - radius;
+    if (distance <= 0.0f) {
+        return;
+    }
+
+    // Rzut błędu z przestrzeni modelu na ekran: projection[1][1] = 1 / tan(fov / 2)
+    float pixelsPerUnit = projection[1][1] * 0.5f * viewportHeight / distance;
+    for (size_t i = lods.size() - 1; i > 0; i--) {
+        if (lods[i].error * scale * pixelsPerUnit <= maxPixelError) {
+            currentLod = i;
+            return;
+        }
+    }
+}
+
+size_t Model::getLod() const {
+    return currentLod;
+}
+
+size_t Model::getLodCount() const {
+    return lods.size();
+}
+
+size_t Model::getTriangleCount() const {
+    return lods.empty() ? 0 : lods[currentLod].indexCount / 3;
+}
@@ -0,0 +1,198 @@
+#include "ObjImporter.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+struct Corner {
+    int position;
+    int texCoord;
+    int normal;
+
+    bool operator==(const Corner& other) const {
+        return position == other.position && texCoord == other.texCoord && normal == other.normal;
+    }
+};
+
+struct CornerHash {
+    size_t operator()(const Corner& corner) const {
+        return (size_t(corner.position) * 73856093u) ^ (size_t(corner.texCoord + 1) * 19349663u) ^ (size_t(corner.normal) * 83492791u);
+    }
+};
+
+int resolveIndex(int index, size_t count) {
+    // Indeksy OBJ liczone są od 1, ujemne - od końca listy
+    return index > 0 ? index - 1 : static_cast<int>(count) + index;
+}
+
+Corner parseCorner(const std::string& token, size_t positions, size_t texCoords, size_t normals) {
+    Corner corner = { -1, -1, -1 };
+    const char* text = token.c_str();
+    char* end = nullptr;
+
+    corner.position = resolveIndex(std::strtol(text, &end, 10), positions);
+    if (*end == '/') {
+        text = end + 1;
+        if (*text != '/') {
+            corner.texCoord = resolveIndex(std::strtol(text, &end, 10), texCoords);
+        }
+        else {
+            end = const_cast<char*>(text);
+        }
+        if (*end == '/') {
+            corner.normal = resolveIndex(std::strtol(end + 1, &end, 10), normals);
+        }
+    }
+    return corner;
+}
+
+void closeSubmesh(MeshData& mesh) {
+    if (mesh.submeshes.empty()) {
+        return;
+    }
+    MeshSubmesh& submesh = mesh.submeshes.back();
+    submesh.indexCount = static_cast<uint32_t>(mesh.indices.size()) - submesh.firstIndex;
+    for (int axis = 0; axis < 3; axis++) {
+        submesh.boundsMin[axis] = FLT_MAX;
+        submesh.boundsMax[axis] = -FLT_MAX;
+    }
+    for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i++) {
+        const float* position = &mesh.vertices[mesh.indices[i] * 8];
+        for (int axis = 0; axis < 3; axis++) {
+            submesh.boundsMin[axis] = std::min(submesh.boundsMin[axis], position[axis]);
+            submesh.boundsMax[axis] = std::max(submesh.boundsMax[axis], position[axis]);
+        }
+    }
+    if (submesh.indexCount == 0) {
+        mesh.submeshes.pop_back();
+    }
+}
+
+void openSubmesh(MeshData& mesh, const std::string& material) {
+    closeSubmesh(mesh);
+    MeshSubmesh submesh = {};
+    submesh.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+    std::strncpy(submesh.material, material.c_str(), sizeof(submesh.material) - 1);
+    mesh.submeshes.push_back(submesh);
+}
+
+}
+
+bool ObjImporter::load(const std::string& path, MeshData& mesh) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open OBJ file: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<float> normals;
+    std::unordered_map<Corner, uint32_t, CornerHash> vertexLookup;
+
+    mesh = MeshData();
+    openSubmesh(mesh, "default");
+
+    std::string line;
+    std::vector<Corner> face;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if (keyword == "v") {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            stream >> x >> y >> z;
+            positions.insert(positions.end(), { x, y, z });
+        }
+        else if (keyword == "vt") {
+            float u = 0.0f, v = 0.0f;
+            stream >> u >> v;
+            texCoords.insert(texCoords.end(), { u, v });
+        }
+        else if (keyword == "vn") {
+            float x = 0.0f, y = 0.0f, z = 1.0f;
+            stream >> x >> y >> z;
+            normals.insert(normals.end(), { x, y, z });
+        }
+        else if (keyword == "usemtl") {
+            std::string material;
+            stream >> material;
+            openSubmesh(mesh, material);
+        }
+        else if (keyword == "f") {
+            face.clear();
+            std::string token;
+            while (stream >> token) {
+                Corner corner = parseCorner(token, positions.size() / 3, texCoords.size() / 2, normals.size() / 3);
+                if (corner.position < 0 || corner.position >= static_cast<int>(positions.size() / 3)) {
+                    std::cerr << "Invalid OBJ face index in " << path << ": " << token << std::endl;
+                    return false;
+                }
+                face.push_back(corner);
+            }
+            if (face.size() < 3) {
+                continue;
+            }
+
+            // Normalna ściany dla narożników bez `vn`
+            const float* p0 = &positions[face[0].position * 3];
+            const float* p1 = &positions[face[1].position * 3];
+            const float* p2 = &positions[face[2].position * 3];
+            float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            int faceNormal = -1;
+
+            std::vector<uint32_t> faceIndices;
+            for (Corner& corner : face) {
+                if (corner.normal < 0 || corner.normal >= static_cast<int>(normals.size() / 3)) {
+                    if (faceNormal < 0) {
+                        faceNormal = static_cast<int>(normals.size() / 3);
+                        float scale = length > 0.0f ? 1.0f / length : 0.0f;
+                        normals.insert(normals.end(), { n[0] * scale, n[1] * scale, n[2] * scale });
+                    }
+                    corner.normal = faceNormal;
+                }
+                if (corner.texCoord >= static_cast<int>(texCoords.size() / 2)) {
+                    corner.texCoord = -1;
+                }
+
+                auto found = vertexLookup.find(corner);
+                if (found != vertexLookup.end()) {
+                    faceIndices.push_back(found->second);
+                    continue;
+                }
+
+                uint32_t index = static_cast<uint32_t>(mesh.vertices.size() / 8);
+                const float* position = &positions[corner.position * 3];
+                const float* normal = &normals[corner.normal * 3];
+                float u = corner.texCoord >= 0 ? texCoords[corner.texCoord * 2] : 0.0f;
+                float v = corner.texCoord >= 0 ? texCoords[corner.texCoord * 2 + 1] : 0.0f;
+                mesh.vertices.insert(mesh.vertices.end(), { position[0], position[1], position[2], u, v, normal[0], normal[1], normal[2] });
+                vertexLookup.emplace(corner, index);
+                faceIndices.push_back(index);
+            }
+
+            for (size_t i = 1; i + 1 < faceIndices.size(); i++) {
+                mesh.indices.insert(mesh.indices.end(), { faceIndices[0], faceIndices[i], faceIndices[i + 1] });
+            }
+        }
+    }
+    closeSubmesh(mesh);
+
+    if (mesh.indices.empty()) {
+        std::cerr << "OBJ file contains no faces: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
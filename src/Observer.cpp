@@ -1,26 +1,67 @@
 #include "Observer.h"
+#include "SpatialHash.h"
 
-Observer::Observer(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up)
-    : position(position), target(target), up(up) {
+Observer::Observer(World& world, const glm::vec3& position, const glm::vec3& target, const glm::vec3& up)
+    : world(world) {
     glm::vec3 direction = glm::normalize(target - position);
-    pitch = glm::degrees(asin(direction.y));
-    yaw = glm::degrees(atan2(direction.z, direction.x));
+    float pitch = glm::degrees(asin(direction.y));
+    float yaw = glm::degrees(atan2(direction.z, direction.x));
+    entity = world.create(Camera{ position, target, up, pitch, yaw, 45.0f, 0.1f, 100.0f });
+}
+
+Entity Observer::getEntity() const {
+    return entity;
+}
+
+Camera& Observer::camera() const {
+    return *world.get<Camera>(entity);
 }
 
 glm::mat4 Observer::getViewMatrix() const {
-    return glm::lookAt(position, target, up);
+    const Camera& state = camera();
+    return glm::lookAt(state.position, state.target, state.up);
+}
+
+glm::mat4 Observer::getProjectionMatrix(float aspect) const {
+    const Camera& state = camera();
+    return glm::perspective(glm::radians(state.fov), aspect, state.nearPlane, state.farPlane);
+}
+
+Ray Observer::getPickRay(int x, int y, int width, int height) const {
+    // Środek piksela w NDC; oś Y okna rośnie w dół
+    glm::vec2 ndc(2.0f * (x + 0.5f) / width - 1.0f, 1.0f - 2.0f * (y + 0.5f) / height);
+    glm::mat4 inverse = glm::inverse(getProjectionMatrix(static_cast<float>(width) / height) * getViewMatrix());
+    glm::vec4 nearPoint = inverse * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverse * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 end = glm::vec3(farPoint) / farPoint.w;
+    return { origin, glm::normalize(end - origin) };
+}
+
+float Observer::getFov() const {
+    return camera().fov;
+}
+
+float Observer::getNearPlane() const {
+    return camera().nearPlane;
+}
+
+float Observer::getFarPlane() const {
+    return camera().farPlane;
 }
 
 void Observer::translate(const glm::vec3& direction) {
-    position += direction;
-    target += direction;
+    Camera& state = camera();
+    state.position += direction;
+    state.target += direction;
 }
 
 void Observer::rotate(float angle, const glm::vec3& axis) {
+    Camera& state = camera();
     glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(angle), axis);
-    glm::vec3 direction = glm::normalize(target - position);
+    glm::vec3 direction = glm::normalize(state.target - state.position);
     glm::vec3 rotatedDirection = glm::vec3(rotation * glm::vec4(direction, 0.0f));
-    target = position + rotatedDirection;
+    state.target = state.position + rotatedDirection;
 }
 
 void Observer::rotatePoint(float angle, const glm::vec3& axis, const glm::vec3& point) {
@@ -32,56 +73,78 @@ void Observer::rotatePoint(float angle, const glm::vec3& axis, const glm::vec3&
 }
 
 void Observer::setPosition(const glm::vec3& newPosition) {
-    target += (newPosition - position);
-    position = newPosition;
+    Camera& state = camera();
+    state.target += (newPosition - state.position);
+    state.position = newPosition;
 }
 
 void Observer::setTarget(const glm::vec3& newTarget) {
-    target = newTarget;
+    camera().target = newTarget;
 }
 
 const glm::vec3& Observer::getPosition() const {
-    return position;
+    return camera().position;
 }
 
 const glm::vec3& Observer::getTarget() const {
-    return target;
+    return camera().target;
 }
 
 void Observer::moveForward(float distance) {
-    glm::vec3 forward = glm::normalize(target - position);
-    this->translate( forward * distance);
+    const Camera& state = camera();
+    glm::vec3 forward = glm::normalize(state.target - state.position);
+    move(forward * distance);
 }
 
 void Observer::moveRight(float distance) {
-    glm::vec3 forward = glm::normalize(target - position);
-    glm::vec3 right = glm::normalize(glm::cross(forward, up));
-    this->translate(right * distance);
+    const Camera& state = camera();
+    glm::vec3 forward = glm::normalize(state.target - state.position);
+    glm::vec3 right = glm::normalize(glm::cross(forward, state.up));
+    move(right * distance);
+}
+
+void Observer::moveUp(float distance) {
+    move(glm::vec3(0.0f, distance, 0.0f));
+}
+
+void Observer::setCollision(SpatialHash* spatialHash, float radius) {
+    collision = spatialHash;
+    collisionRadius = radius;
+}
+
+void Observer::move(const glm::vec3& displacement) {
+    if (!collision) {
+        translate(displacement);
+        return;
+    }
+    glm::vec3 position = camera().position;
+    translate(collision->slideSphere(position, displacement, collisionRadius) - position);
 }
 
 float Observer::getPitch() const {
-    return pitch;
+    return camera().pitch;
 }
 
 float Observer::getYaw() const {
-    return yaw;
+    return camera().yaw;
 }
 
 void Observer::setPitch(float newPitch) {
-    pitch = glm::clamp(newPitch, -89.0f, 89.0f);
+    camera().pitch = glm::clamp(newPitch, -89.0f, 89.0f);
     updateTarget();
 }
 
 void Observer::setYaw(float newYaw) {
-    yaw = glm::mod(newYaw, 360.0f);
+    camera().yaw = glm::mod(newYaw, 360.0f);
     updateTarget();
 }
 
 void Observer::updateTarget() {
+    Camera& state = camera();
     glm::vec3 direction;
-    direction.x = cos(glm::radians(pitch)) * cos(glm::radians(yaw));
-    direction.y = sin(glm::radians(pitch));
-    direction.z = cos(glm::radians(pitch)) * sin(glm::radians(yaw));
+    direction.x = cos(glm::radians(state.pitch)) * cos(glm::radians(state.yaw));
+    direction.y = sin(glm::radians(state.pitch));
+    direction.z = cos(glm::radians(state.pitch)) * sin(glm::radians(state.yaw));
 
-    target = position + glm::normalize(direction);
-}
+    state.target = state.position + glm::normalize(direction);
+}
\ No newline at end of file
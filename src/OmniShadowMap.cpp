@@ -0,0 +1,87 @@
+#include "OmniShadowMap.h"
+
+OmniShadowMap::OmniShadowMap(int resolution, int lightCount)
+    : resolution(resolution), lightCount(lightCount) {
+    glGenTextures(1, &cubeArray);
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, cubeArray);
+    glTexImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, FACE_COUNT * glm::max(lightCount, 1), 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, cubeArray, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Omnidirectional shadow framebuffer is incomplete!" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+OmniShadowMap::~OmniShadowMap() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &cubeArray);
+}
+
+void OmniShadowMap::bindForWriting() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, resolution, resolution);
+}
+
+GLuint OmniShadowMap::getTexture() const {
+    return cubeArray;
+}
+
+int OmniShadowMap::getResolution() const {
+    return resolution;
+}
+
+int OmniShadowMap::getLightCount() const {
+    return lightCount;
+}
+
+void OmniShadowMap::computeFaceMatrices(const glm::vec3& position, float farPlane, glm::mat4 matrices[FACE_COUNT]) {
+    glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, farPlane);
+
+    matrices[0] = projection * glm::lookAt(position, position + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    matrices[1] = projection * glm::lookAt(position, position + glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    matrices[2] = projection * glm::lookAt(position, position + glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    matrices[3] = projection * glm::lookAt(position, position + glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+    matrices[4] = projection * glm::lookAt(position, position + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    matrices[5] = projection * glm::lookAt(position, position + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+}
+
+int OmniShadowMap::computeFaceMask(const BoundingBox& bounds, const glm::vec3& position, float farPlane) {
+    glm::vec3 center = bounds.getCenter() - position;
+    float radius = bounds.getRadius();
+
+    if (glm::length(center) - radius > farPlane) {
+        return 0;
+    }
+
+    const float invSqrt2 = 0.70710678f;
+    int mask = 0;
+    for (int face = 0; face < FACE_COUNT; face++) {
+        int axis = face / 2;
+        float major = (face % 2 == 0) ? center[axis] : -center[axis];
+        float u = center[(axis + 1) % 3];
+        float v = center[(axis + 2) % 3];
+
+        // Ostrosłup ściany: major >= |u| i major >= |v|, odległości od płaszczyzn bocznych
+        if ((major - u) * invSqrt2 < -radius || (major + u) * invSqrt2 < -radius) {
+            continue;
+        }
+        if ((major - v) * invSqrt2 < -radius || (major + v) * invSqrt2 < -radius) {
+            continue;
+        }
+        mask |= 1 << face;
+    }
+    return mask;
+}
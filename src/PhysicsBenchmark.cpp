@@ -0,0 +1,75 @@
+#include "PhysicsWorld.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+
+const float STEP = 1.0f / 60.0f;
+const int STEPS = 600, REPORT_INTERVAL = 60;
+
+}
+
+int main(int argc, char** argv) {
+    int boxCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10000;
+    unsigned int threads = argc > 2 ? static_cast<unsigned int>(std::max(1, std::atoi(argv[2]))) : 0;
+
+    JobSystem jobs(threads);
+    PhysicsWorld world;
+    world.addPlane(glm::vec3(0.0f, 1.0f, 0.0f), 0.0f);
+
+    // Pudła rozrzucone w kwadracie z czterema ścianami, zrzucane warstwami, żeby tworzyły stosy
+    float side = std::sqrt(static_cast<float>(boxCount)) * 1.6f;
+    glm::quat identity(1.0f, 0.0f, 0.0f, 0.0f);
+    world.addBox(glm::vec3(-0.5f, 5.0f, side * 0.5f), identity, glm::vec3(0.5f, 5.0f, side * 0.5f + 1.0f), 0.0f);
+    world.addBox(glm::vec3(side + 0.5f, 5.0f, side * 0.5f), identity, glm::vec3(0.5f, 5.0f, side * 0.5f + 1.0f), 0.0f);
+    world.addBox(glm::vec3(side * 0.5f, 5.0f, -0.5f), identity, glm::vec3(side * 0.5f, 5.0f, 0.5f), 0.0f);
+    world.addBox(glm::vec3(side * 0.5f, 5.0f, side + 0.5f), identity, glm::vec3(side * 0.5f, 5.0f, 0.5f), 0.0f);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(0.6f, side - 0.6f), height(0.5f, 6.0f), angle(0.0f, 3.14159265f);
+    for (int i = 0; i < boxCount; i++) {
+        glm::vec3 axis = glm::normalize(glm::vec3(coordinate(random), coordinate(random), coordinate(random)));
+        world.addBox(glm::vec3(coordinate(random), height(random), coordinate(random)), glm::angleAxis(angle(random), axis), glm::vec3(0.5f), 1.0f);
+    }
+
+    std::cout << boxCount << " boxes, " << jobs.getThreadCount() << " threads, step " << STEP * 1000.0f << " ms" << std::endl;
+    std::cout << std::setw(6) << "step" << std::setw(8) << "awake" << std::setw(9) << "pairs" << std::setw(10) << "contacts"
+              << std::setw(9) << "islands" << std::setw(10) << "avg ms" << std::setw(10) << "max ms" << std::endl;
+
+    double total = 0.0, intervalTotal = 0.0, intervalMax = 0.0, activeTotal = 0.0;
+    int activeSteps = 0;
+    for (int step = 1; step <= STEPS; step++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        world.step(STEP, &jobs);
+        double time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        total += time;
+        intervalTotal += time;
+        intervalMax = std::max(intervalMax, time);
+        if (world.getAwakeCount() >= static_cast<size_t>(boxCount) * 9 / 10) {
+            activeTotal += time;
+            activeSteps++;
+        }
+        if (step % REPORT_INTERVAL == 0) {
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::setw(6) << step << std::setw(8) << world.getAwakeCount() << std::setw(9) << world.getPairCount()
+                      << std::setw(10) << world.getContactCount() << std::setw(9) << world.getIslandCount()
+                      << std::setw(10) << intervalTotal / REPORT_INTERVAL << std::setw(10) << intervalMax << std::endl;
+            intervalTotal = 0.0;
+            intervalMax = 0.0;
+        }
+    }
+
+    std::cout << "average " << total / STEPS << " ms per step";
+    if (activeSteps > 0) {
+        std::cout << ", " << activeTotal / activeSteps << " ms with at least 90% of boxes awake (" << activeSteps << " steps)";
+    }
+    std::cout << std::endl;
+    return 0;
+}
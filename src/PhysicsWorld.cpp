@@ -0,0 +1,981 @@
+#include "PhysicsWorld.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+const float CONTACT_MARGIN = 0.02f;
+const float PENETRATION_SLOP = 0.005f;
+const float BAUMGARTE = 0.2f;
+const float MAX_CORRECTION_VELOCITY = 3.0f;
+const float FRICTION = 0.5f;
+const float RESTITUTION = 0.1f, RESTITUTION_THRESHOLD = 1.0f;
+const float ANGULAR_DAMPING = 0.05f;
+const int VELOCITY_ITERATIONS = 8;
+const float TIME_TO_SLEEP = 0.5f;
+const float LINEAR_SLEEP_TOLERANCE = 0.05f, ANGULAR_SLEEP_TOLERANCE = 0.05f;
+const float MATCH_DISTANCE = 0.1f;
+const float RELATIVE_TOLERANCE = 0.95f, ABSOLUTE_TOLERANCE = 0.01f;
+const size_t SWEEP_GRAIN = 1024, NARROWPHASE_GRAIN = 256, ISLAND_GRAIN = 16;
+const uint32_t PLANE_KEY_BIT = 0x80000000u;
+
+/**
+ * Prostopadłościan zorientowany - wejście testów kolizji.
+ */
+struct Box {
+    glm::vec3 center;
+    glm::vec3 axes[3];
+    glm::vec3 extents;
+};
+
+/**
+ * Punkt kontaktu przed redukcją do MAX_CONTACTS.
+ */
+struct ClipPoint {
+    glm::vec3 position;
+    float penetration;
+};
+
+/**
+ * Wiersz ograniczenia kontaktu z wyliczonymi z góry składowymi jakobianu.
+ */
+struct SolverRow {
+    glm::vec3 direction;     // kierunek impulsu (normalna albo styczna)
+    glm::vec3 angularA;      // rA x kierunek
+    glm::vec3 angularB;      // rB x kierunek
+    glm::vec3 impulseA;      // odwrotny tensor A * angularA
+    glm::vec3 impulseB;      // odwrotny tensor B * angularB
+    float mass;              // masa efektywna
+    float impulse;           // skumulowany impuls
+};
+
+/**
+ * Kontakt w lokalnej tablicy solvera wyspy - normalna i dwa kierunki tarcia.
+ */
+struct SolverContact {
+    SolverRow rows[3];
+    float bias;
+    float inverseMassA, inverseMassB;
+    uint32_t indexA, indexB;
+};
+
+/**
+ * Prędkości ciała w lokalnej tablicy solvera wyspy.
+ */
+struct SolverBody {
+    glm::vec3 linearVelocity;
+    glm::vec3 angularVelocity;
+};
+
+uint64_t pairKey(uint32_t a, uint32_t b, bool plane) {
+    return (static_cast<uint64_t>(a) << 32) | (plane ? (b | PLANE_KEY_BIT) : b);
+}
+
+int clipPolygon(const glm::vec3* input, int count, const glm::vec3& normal, float offset, glm::vec3* output) {
+    int outputCount = 0;
+    for (int i = 0; i < count; i++) {
+        const glm::vec3& a = input[i];
+        const glm::vec3& b = input[(i + 1) % count];
+        float da = glm::dot(normal, a) - offset;
+        float db = glm::dot(normal, b) - offset;
+        if (da <= 0.0f) {
+            output[outputCount++] = a;
+        }
+        if ((da <= 0.0f) != (db <= 0.0f)) {
+            output[outputCount++] = a + (b - a) * (da / (da - db));
+        }
+    }
+    return outputCount;
+}
+
+// Najgłębszy punkt, najdalszy od niego i dwa rozpinające największe trójkąty po obu stronach
+int reducePoints(ClipPoint* points, int count, const glm::vec3& normal) {
+    if (count <= PhysicsWorld::MAX_CONTACTS) {
+        return count;
+    }
+
+    int chosen[PhysicsWorld::MAX_CONTACTS];
+    chosen[0] = 0;
+    for (int i = 1; i < count; i++) {
+        if (points[i].penetration > points[chosen[0]].penetration) {
+            chosen[0] = i;
+        }
+    }
+
+    chosen[1] = chosen[0];
+    float farthest = -1.0f;
+    for (int i = 0; i < count; i++) {
+        glm::vec3 offset = points[i].position - points[chosen[0]].position;
+        float distance = glm::dot(offset, offset);
+        if (distance > farthest) {
+            farthest = distance;
+            chosen[1] = i;
+        }
+    }
+
+    chosen[2] = chosen[0];
+    chosen[3] = chosen[1];
+    float maxArea = 0.0f, minArea = 0.0f;
+    for (int i = 0; i < count; i++) {
+        glm::vec3 toFirst = points[chosen[0]].position - points[i].position;
+        glm::vec3 toSecond = points[chosen[1]].position - points[i].position;
+        float area = glm::dot(glm::cross(toFirst, toSecond), normal);
+        if (area > maxArea) {
+            maxArea = area;
+            chosen[2] = i;
+        }
+        if (area < minArea) {
+            minArea = area;
+            chosen[3] = i;
+        }
+    }
+
+    ClipPoint reduced[PhysicsWorld::MAX_CONTACTS];
+    int reducedCount = 0;
+    for (int i = 0; i < PhysicsWorld::MAX_CONTACTS; i++) {
+        if (std::find(chosen, chosen + i, chosen[i]) == chosen + i) {
+            reduced[reducedCount++] = points[chosen[i]];
+        }
+    }
+    std::copy(reduced, reduced + reducedCount, points);
+    return reducedCount;
+}
+
+int collideBoxPlane(const Box& box, const glm::vec3& planeNormal, float planeOffset, glm::vec3& normal, ClipPoint* points) {
+    int count = 0;
+    for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 point = box.center
+            + box.axes[0] * ((corner & 1) ? box.extents.x : -box.extents.x)
+            + box.axes[1] * ((corner & 2) ? box.extents.y : -box.extents.y)
+            + box.axes[2] * ((corner & 4) ? box.extents.z : -box.extents.z);
+        float separation = glm::dot(planeNormal, point) - planeOffset;
+        if (separation <= CONTACT_MARGIN) {
+            points[count++] = { point - planeNormal * (separation * 0.5f), -separation };
+        }
+    }
+    normal = -planeNormal;
+    return count;
+}
+
+int collideBoxes(const Box& a, const Box& b, glm::vec3& normal, ClipPoint* points) {
+    glm::vec3 offset = b.center - a.center;
+    float absR[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            absR[i][j] = std::abs(glm::dot(a.axes[i], b.axes[j])) + 1e-6f;
+        }
+    }
+
+    // Osie rozdzielające: ściany A, ściany B i iloczyny wektorowe krawędzi
+    float faceASeparation = -FLT_MAX, faceBSeparation = -FLT_MAX, edgeSeparation = -FLT_MAX;
+    int faceA = 0, faceB = 0, edgeA = 0, edgeB = 0;
+    glm::vec3 edgeAxis(0.0f);
+    for (int i = 0; i < 3; i++) {
+        float projected = b.extents.x * absR[i][0] + b.extents.y * absR[i][1] + b.extents.z * absR[i][2];
+        float separation = std::abs(glm::dot(offset, a.axes[i])) - (a.extents[i] + projected);
+        if (separation > CONTACT_MARGIN) {
+            return 0;
+        }
+        if (separation > faceASeparation) {
+            faceASeparation = separation;
+            faceA = i;
+        }
+    }
+    for (int j = 0; j < 3; j++) {
+        float projected = a.extents.x * absR[0][j] + a.extents.y * absR[1][j] + a.extents.z * absR[2][j];
+        float separation = std::abs(glm::dot(offset, b.axes[j])) - (b.extents[j] + projected);
+        if (separation > CONTACT_MARGIN) {
+            return 0;
+        }
+        if (separation > faceBSeparation) {
+            faceBSeparation = separation;
+            faceB = j;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            glm::vec3 axis = glm::cross(a.axes[i], b.axes[j]);
+            float length = glm::length(axis);
+            if (length < 1e-3f) {
+                continue;
+            }
+            axis /= length;
+            float radiusA = a.extents.x * std::abs(glm::dot(a.axes[0], axis)) + a.extents.y * std::abs(glm::dot(a.axes[1], axis)) + a.extents.z * std::abs(glm::dot(a.axes[2], axis));
+            float radiusB = b.extents.x * std::abs(glm::dot(b.axes[0], axis)) + b.extents.y * std::abs(glm::dot(b.axes[1], axis)) + b.extents.z * std::abs(glm::dot(b.axes[2], axis));
+            float distance = glm::dot(offset, axis);
+            float separation = std::abs(distance) - (radiusA + radiusB);
+            if (separation > CONTACT_MARGIN) {
+                return 0;
+            }
+            if (separation > edgeSeparation) {
+                edgeSeparation = separation;
+                edgeA = i;
+                edgeB = j;
+                edgeAxis = distance < 0.0f ? -axis : axis;
+            }
+        }
+    }
+
+    // Ściany mają pierwszeństwo przed krawędziami, żeby kontakty nie przeskakiwały między krokami
+    bool referenceB = faceBSeparation > RELATIVE_TOLERANCE * faceASeparation + ABSOLUTE_TOLERANCE;
+    float faceSeparation = referenceB ? faceBSeparation : faceASeparation;
+
+    if (edgeSeparation > RELATIVE_TOLERANCE * faceSeparation + ABSOLUTE_TOLERANCE) {
+        glm::vec3 pointA = a.center, pointB = b.center;
+        for (int k = 0; k < 3; k++) {
+            if (k != edgeA) {
+                pointA += a.axes[k] * (glm::dot(a.axes[k], edgeAxis) > 0.0f ? a.extents[k] : -a.extents[k]);
+            }
+            if (k != edgeB) {
+                pointB += b.axes[k] * (glm::dot(b.axes[k], edgeAxis) > 0.0f ? -b.extents[k] : b.extents[k]);
+            }
+        }
+
+        // Najbliższe punkty dwóch prostych krawędzi
+        const glm::vec3& directionA = a.axes[edgeA];
+        const glm::vec3& directionB = b.axes[edgeB];
+        glm::vec3 between = pointA - pointB;
+        float cosine = glm::dot(directionA, directionB);
+        float denominator = std::max(1.0f - cosine * cosine, 1e-6f);
+        float alongA = (cosine * glm::dot(directionB, between) - glm::dot(directionA, between)) / denominator;
+        alongA = glm::clamp(alongA, -a.extents[edgeA], a.extents[edgeA]);
+        float alongB = glm::clamp(glm::dot(directionB, between) + alongA * cosine, -b.extents[edgeB], b.extents[edgeB]);
+
+        normal = edgeAxis;
+        points[0] = { (pointA + directionA * alongA + pointB + directionB * alongB) * 0.5f, -edgeSeparation };
+        return 1;
+    }
+
+    const Box& reference = referenceB ? b : a;
+    const Box& incident = referenceB ? a : b;
+    int axis = referenceB ? faceB : faceA;
+    glm::vec3 referenceNormal = reference.axes[axis];
+    if (glm::dot(incident.center - reference.center, referenceNormal) < 0.0f) {
+        referenceNormal = -referenceNormal;
+    }
+
+    // Ściana incydentna - najbardziej przeciwna do normalnej ściany odniesienia
+    int incidentAxis = 0;
+    float incidentDot = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        float alignment = glm::dot(incident.axes[k], referenceNormal);
+        if (std::abs(alignment) > std::abs(incidentDot)) {
+            incidentDot = alignment;
+            incidentAxis = k;
+        }
+    }
+    glm::vec3 incidentCenter = incident.center + incident.axes[incidentAxis] * (incidentDot > 0.0f ? -incident.extents[incidentAxis] : incident.extents[incidentAxis]);
+    glm::vec3 side1 = incident.axes[(incidentAxis + 1) % 3] * incident.extents[(incidentAxis + 1) % 3];
+    glm::vec3 side2 = incident.axes[(incidentAxis + 2) % 3] * incident.extents[(incidentAxis + 2) % 3];
+
+    glm::vec3 polygon[8] = {
+        incidentCenter + side1 + side2,
+        incidentCenter - side1 + side2,
+        incidentCenter - side1 - side2,
+        incidentCenter + side1 - side2
+    };
+    glm::vec3 clipped[8];
+    int count = 4;
+    for (int k = 1; k <= 2 && count > 0; k++) {
+        int sideAxis = (axis + k) % 3;
+        const glm::vec3& direction = reference.axes[sideAxis];
+        float center = glm::dot(direction, reference.center);
+        count = clipPolygon(polygon, count, direction, center + reference.extents[sideAxis], clipped);
+        count = count > 0 ? clipPolygon(clipped, count, -direction, reference.extents[sideAxis] - center, polygon) : 0;
+    }
+
+    glm::vec3 referenceCenter = reference.center + referenceNormal * reference.extents[axis];
+    int pointCount = 0;
+    for (int i = 0; i < count; i++) {
+        float separation = glm::dot(polygon[i] - referenceCenter, referenceNormal);
+        if (separation <= CONTACT_MARGIN) {
+            points[pointCount++] = { polygon[i] - referenceNormal * (separation * 0.5f), -separation };
+        }
+    }
+    normal = referenceB ? -referenceNormal : referenceNormal;
+    return pointCount;
+}
+
+glm::vec3 orthogonal(const glm::vec3& normal) {
+    if (std::abs(normal.x) >= 0.57735f) {
+        return glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+    }
+    return glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+}
+
+}
+
+PhysicsWorld::PhysicsWorld(const glm::vec3& gravity) : gravity(gravity) {
+}
+
+PhysicsWorld::Body PhysicsWorld::addBox(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& halfExtents, float mass) {
+    Body handle;
+    if (!freeBodies.empty()) {
+        handle = freeBodies.back();
+        freeBodies.pop_back();
+    }
+    else {
+        handle = static_cast<Body>(bodies.size());
+        bodies.emplace_back();
+    }
+
+    RigidBody& body = bodies[handle];
+    body = {};
+    body.position = position;
+    body.orientation = glm::normalize(orientation);
+    body.halfExtents = halfExtents;
+    body.alive = true;
+    if (mass > 0.0f) {
+        glm::vec3 squared = halfExtents * halfExtents;
+        body.inverseMass = 1.0f / mass;
+        body.inverseInertia = glm::vec3(3.0f / (mass * (squared.y + squared.z)),
+                                        3.0f / (mass * (squared.x + squared.z)),
+                                        3.0f / (mass * (squared.x + squared.y)));
+        body.awake = true;
+    }
+    updateDerived(body);
+
+    proxiesDirty = true;
+    return handle;
+}
+
+void PhysicsWorld::removeBody(Body body) {
+    if (body >= bodies.size() || !bodies[body].alive) {
+        return;
+    }
+    bodies[body].alive = false;
+    bodies[body].awake = false;
+    removedBodies.push_back(body);
+    proxiesDirty = true;
+}
+
+void PhysicsWorld::addPlane(const glm::vec3& normal, float offset) {
+    float length = glm::length(normal);
+    planes.push_back({ normal / length, offset / length });
+}
+
+void PhysicsWorld::setVelocity(Body body, const glm::vec3& linear, const glm::vec3& angular) {
+    RigidBody& rigidBody = bodies[body];
+    if (rigidBody.inverseMass == 0.0f) {
+        return;
+    }
+    rigidBody.linearVelocity = linear;
+    rigidBody.angularVelocity = angular;
+    rigidBody.awake = true;
+    rigidBody.sleepTime = 0.0f;
+}
+
+void PhysicsWorld::updateDerived(RigidBody& body) {
+    body.rotation = glm::mat3_cast(body.orientation);
+    glm::mat3 scaled(body.rotation[0] * body.inverseInertia.x, body.rotation[1] * body.inverseInertia.y, body.rotation[2] * body.inverseInertia.z);
+    body.inverseInertiaWorld = scaled * glm::transpose(body.rotation);
+
+    glm::vec3 extent = glm::abs(body.rotation[0]) * body.halfExtents.x
+                     + glm::abs(body.rotation[1]) * body.halfExtents.y
+                     + glm::abs(body.rotation[2]) * body.halfExtents.z;
+    body.boundsMin = body.position - extent;
+    body.boundsMax = body.position + extent;
+}
+
+void PhysicsWorld::step(float dt, JobSystem* jobs) {
+    if (dt <= 0.0f) {
+        return;
+    }
+    flushRemovals();
+    findPairs(jobs);
+
+    manifolds.resize(pairs.size());
+    auto narrowphase = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            collide(pairs[i], manifolds[i]);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(pairs.size(), NARROWPHASE_GRAIN, narrowphase);
+    }
+    else {
+        narrowphase(0, pairs.size());
+    }
+
+    buildIslands();
+    size_t islandCount = islandBodyStart.size() - 1;
+    auto solve = [this, dt](size_t begin, size_t end) {
+        for (size_t island = begin; island < end; island++) {
+            solveIsland(island, dt);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(islandCount, ISLAND_GRAIN, solve);
+    }
+    else {
+        solve(0, islandCount);
+    }
+
+    contactCount = 0;
+    for (const Manifold& manifold : manifolds) {
+        contactCount += manifold.contactCount;
+    }
+    awakeCount = 0;
+    for (const RigidBody& body : bodies) {
+        awakeCount += body.alive && body.awake;
+    }
+
+    // Pary są posortowane po kluczu, więc następny krok wyszukuje kontakty binarnie
+    previousManifolds.swap(manifolds);
+}
+
+void PhysicsWorld::flushRemovals() {
+    if (removedBodies.empty()) {
+        return;
+    }
+
+    std::vector<uint8_t> removed(bodies.size(), 0);
+    for (Body body : removedBodies) {
+        removed[body] = 1;
+    }
+    auto touchesRemoved = [&](const Manifold& manifold) {
+        bool removedA = removed[manifold.a];
+        bool removedB = !manifold.plane && removed[manifold.b];
+        if (!removedA && !removedB) {
+            return false;
+        }
+        if (removedA != removedB && (removedB || !manifold.plane)) {
+            RigidBody& other = bodies[removedA ? manifold.b : manifold.a];
+            if (other.inverseMass > 0.0f) {
+                other.awake = true;
+                other.sleepTime = 0.0f;
+            }
+        }
+        return true;
+    };
+    previousManifolds.erase(std::remove_if(previousManifolds.begin(), previousManifolds.end(), touchesRemoved), previousManifolds.end());
+
+    // Uchwyty wracają do puli dopiero teraz, żeby nowe ciało nie odziedziczyło starych kontaktów
+    freeBodies.insert(freeBodies.end(), removedBodies.begin(), removedBodies.end());
+    removedBodies.clear();
+}
+
+void PhysicsWorld::findPairs(JobSystem* jobs) {
+    // Oś przeczesywania o największej wariancji środków - najmniej fałszywych nakładań
+    glm::vec3 sum(0.0f), sumSquares(0.0f);
+    size_t aliveCount = 0;
+    for (const RigidBody& body : bodies) {
+        if (body.alive) {
+            glm::vec3 center = (body.boundsMin + body.boundsMax) * 0.5f;
+            sum += center;
+            sumSquares += center * center;
+            aliveCount++;
+        }
+    }
+    if (aliveCount > 0) {
+        glm::vec3 variance = sumSquares - sum * sum / static_cast<float>(aliveCount);
+        int axis = sweepAxis;
+        for (int candidate = 0; candidate < 3; candidate++) {
+            axis = variance[candidate] > variance[axis] ? candidate : axis;
+        }
+        if (axis != sweepAxis) {
+            sweepAxis = axis;
+            proxiesDirty = true;
+        }
+    }
+
+    int axis = sweepAxis;
+    auto lessMin = [axis](const Proxy& a, const Proxy& b) { return a.min[axis] < b.min[axis]; };
+    if (proxiesDirty) {
+        proxies.clear();
+        for (Body body = 0; body < bodies.size(); body++) {
+            if (bodies[body].alive) {
+                proxies.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), body, false });
+            }
+        }
+    }
+    for (Proxy& proxy : proxies) {
+        const RigidBody& body = bodies[proxy.body];
+        proxy.min = body.boundsMin;
+        proxy.max = body.boundsMax;
+        proxy.awake = body.awake;
+    }
+    if (proxiesDirty) {
+        std::sort(proxies.begin(), proxies.end(), lessMin);
+        proxiesDirty = false;
+    }
+    else {
+        // Między krokami kolejność prawie się nie zmienia - sortowanie przez wstawianie jest liniowe
+        for (size_t i = 1; i < proxies.size(); i++) {
+            Proxy proxy = proxies[i];
+            size_t j = i;
+            while (j > 0 && proxies[j - 1].min[axis] > proxy.min[axis]) {
+                proxies[j] = proxies[j - 1];
+                j--;
+            }
+            proxies[j] = proxy;
+        }
+    }
+
+    // Ciała uśpione i statyczne przeczesywane są tylko względem aktywnych, więc śpiąca część sceny nic nie kosztuje
+    awakeProxies.clear();
+    restingProxies.clear();
+    for (const Proxy& proxy : proxies) {
+        (proxy.awake ? awakeProxies : restingProxies).push_back(proxy);
+    }
+
+    int axis1 = (axis + 1) % 3, axis2 = (axis + 2) % 3;
+    auto overlaps = [axis1, axis2](const Proxy& a, const Proxy& b) {
+        return a.min[axis1] <= b.max[axis1] && b.min[axis1] <= a.max[axis1]
+            && a.min[axis2] <= b.max[axis2] && b.min[axis2] <= a.max[axis2];
+    };
+    auto makePair = [](Body first, Body second) {
+        Body a = std::min(first, second), b = std::max(first, second);
+        return Pair{ pairKey(a, b, false), a, b, false };
+    };
+
+    pairs.clear();
+    std::mutex pairsMutex;
+    size_t activeCount = awakeProxies.size();
+    auto sweep = [&](size_t begin, size_t end) {
+        std::vector<Pair> found;
+        for (size_t i = begin; i < end; i++) {
+            if (i < activeCount) {
+                // Aktywne z aktywnymi oraz spoczywające zaczynające się wewnątrz przedziału aktywnego
+                const Proxy& proxy = awakeProxies[i];
+                for (size_t j = i + 1; j < activeCount && awakeProxies[j].min[axis] <= proxy.max[axis]; j++) {
+                    if (overlaps(proxy, awakeProxies[j])) {
+                        found.push_back(makePair(proxy.body, awakeProxies[j].body));
+                    }
+                }
+                auto first = std::lower_bound(restingProxies.begin(), restingProxies.end(), proxy, lessMin);
+                for (auto other = first; other != restingProxies.end() && other->min[axis] <= proxy.max[axis]; ++other) {
+                    if (overlaps(proxy, *other)) {
+                        found.push_back(makePair(proxy.body, other->body));
+                    }
+                }
+            }
+            else {
+                // Aktywne zaczynające się wewnątrz przedziału spoczywającego
+                const Proxy& proxy = restingProxies[i - activeCount];
+                auto first = std::upper_bound(awakeProxies.begin(), awakeProxies.end(), proxy, lessMin);
+                for (auto other = first; other != awakeProxies.end() && other->min[axis] <= proxy.max[axis]; ++other) {
+                    if (overlaps(proxy, *other)) {
+                        found.push_back(makePair(proxy.body, other->body));
+                    }
+                }
+            }
+        }
+        if (!found.empty()) {
+            std::lock_guard<std::mutex> lock(pairsMutex);
+            pairs.insert(pairs.end(), found.begin(), found.end());
+        }
+    };
+    size_t sweepCount = activeCount == 0 ? 0 : proxies.size();
+    if (jobs) {
+        jobs->parallelFor(sweepCount, SWEEP_GRAIN, sweep);
+    }
+    else {
+        sweep(0, sweepCount);
+    }
+
+    // Spoczywające ciała dotknięte przez aktywne budzą się jeszcze przed fazą wąską, razem z leżącymi
+    // na nich sąsiadami - inaczej przez jeden krok nie miałyby kontaktów z podłożem ani resztą stosu
+    std::vector<Body> woken;
+    auto wake = [&](Body body) {
+        RigidBody& rigidBody = bodies[body];
+        if (!rigidBody.awake && rigidBody.inverseMass > 0.0f) {
+            rigidBody.awake = true;
+            rigidBody.sleepTime = 0.0f;
+            woken.push_back(body);
+        }
+    };
+    for (const Pair& pair : pairs) {
+        wake(pair.a);
+        wake(pair.b);
+    }
+    float restingLength = 0.0f;
+    if (!woken.empty()) {
+        for (const Proxy& proxy : restingProxies) {
+            restingLength = std::max(restingLength, proxy.max[axis] - proxy.min[axis]);
+        }
+    }
+    for (size_t i = 0; i < woken.size(); i++) {
+        const RigidBody& body = bodies[woken[i]];
+        Proxy proxy = { body.boundsMin, body.boundsMax, woken[i], true };
+        Proxy start = proxy;
+        start.min[axis] -= restingLength;
+        auto first = std::lower_bound(restingProxies.begin(), restingProxies.end(), start, lessMin);
+        for (auto other = first; other != restingProxies.end() && other->min[axis] <= proxy.max[axis]; ++other) {
+            if (other->body != proxy.body && other->max[axis] >= proxy.min[axis] && overlaps(proxy, *other)) {
+                pairs.push_back(makePair(proxy.body, other->body));
+                wake(other->body);
+            }
+        }
+    }
+
+    auto addPlanePairs = [this](Body proxyBody) {
+        const RigidBody& body = bodies[proxyBody];
+        for (uint32_t plane = 0; plane < planes.size(); plane++) {
+            const glm::vec3& normal = planes[plane].normal;
+            float radius = body.halfExtents.x * std::abs(glm::dot(normal, body.rotation[0]))
+                         + body.halfExtents.y * std::abs(glm::dot(normal, body.rotation[1]))
+                         + body.halfExtents.z * std::abs(glm::dot(normal, body.rotation[2]));
+            if (glm::dot(normal, body.position) - planes[plane].offset - radius <= CONTACT_MARGIN) {
+                pairs.push_back({ pairKey(proxyBody, plane, true), proxyBody, plane, true });
+            }
+        }
+    };
+    for (const Proxy& proxy : awakeProxies) {
+        addPlanePairs(proxy.body);
+    }
+    for (Body body : woken) {
+        addPlanePairs(body);
+    }
+
+    // Dwa obudzone ciała mogły dodać tę samą parę z obu stron
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.key < b.key; });
+    pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.key == b.key; }), pairs.end());
+}
+
+void PhysicsWorld::collide(const Pair& pair, Manifold& manifold) const {
+    const RigidBody& bodyA = bodies[pair.a];
+    Box boxA = { bodyA.position, { bodyA.rotation[0], bodyA.rotation[1], bodyA.rotation[2] }, bodyA.halfExtents };
+
+    ClipPoint points[8];
+    glm::vec3 normal(0.0f);
+    int count;
+    if (pair.plane) {
+        count = collideBoxPlane(boxA, planes[pair.b].normal, planes[pair.b].offset, normal, points);
+    }
+    else {
+        const RigidBody& bodyB = bodies[pair.b];
+        Box boxB = { bodyB.position, { bodyB.rotation[0], bodyB.rotation[1], bodyB.rotation[2] }, bodyB.halfExtents };
+        count = collideBoxes(boxA, boxB, normal, points);
+    }
+    count = reducePoints(points, count, normal);
+
+    manifold.key = pair.key;
+    manifold.a = pair.a;
+    manifold.b = pair.b;
+    manifold.plane = pair.plane;
+    manifold.contactCount = count;
+    manifold.normal = normal;
+    if (count == 0) {
+        return;
+    }
+    manifold.tangents[0] = orthogonal(normal);
+    manifold.tangents[1] = glm::cross(normal, manifold.tangents[0]);
+
+    // Ciepły start - impulsy kontaktów poprzedniego kroku leżących w tym samym miejscu ciała A
+    auto previous = std::lower_bound(previousManifolds.begin(), previousManifolds.end(), manifold.key,
+                                     [](const Manifold& m, uint64_t key) { return m.key < key; });
+    bool hasPrevious = previous != previousManifolds.end() && previous->key == manifold.key;
+
+    glm::mat3 toLocal = glm::transpose(bodyA.rotation);
+    for (int i = 0; i < count; i++) {
+        Contact& contact = manifold.contacts[i];
+        contact.position = points[i].position;
+        contact.penetration = points[i].penetration;
+        contact.localA = toLocal * (contact.position - bodyA.position);
+        contact.normalImpulse = 0.0f;
+        contact.tangentImpulse[0] = 0.0f;
+        contact.tangentImpulse[1] = 0.0f;
+
+        if (!hasPrevious) {
+            continue;
+        }
+        for (int j = 0; j < previous->contactCount; j++) {
+            const Contact& old = previous->contacts[j];
+            glm::vec3 offset = old.localA - contact.localA;
+            if (glm::dot(offset, offset) < MATCH_DISTANCE * MATCH_DISTANCE) {
+                contact.normalImpulse = old.normalImpulse;
+                contact.tangentImpulse[0] = old.tangentImpulse[0];
+                contact.tangentImpulse[1] = old.tangentImpulse[1];
+                break;
+            }
+        }
+    }
+}
+
+void PhysicsWorld::buildIslands() {
+    islandParent.resize(bodies.size());
+    solverIndex.resize(bodies.size());
+    for (uint32_t i = 0; i < islandParent.size(); i++) {
+        islandParent[i] = i;
+    }
+    auto find = [this](uint32_t body) {
+        while (islandParent[body] != body) {
+            islandParent[body] = islandParent[islandParent[body]];
+            body = islandParent[body];
+        }
+        return body;
+    };
+
+    // Ciała statyczne nie łączą wysp - inaczej cała scena na podłodze byłaby jedną wyspą
+    for (const Manifold& manifold : manifolds) {
+        if (manifold.contactCount == 0 || manifold.plane) {
+            continue;
+        }
+        if (bodies[manifold.a].inverseMass > 0.0f && bodies[manifold.b].inverseMass > 0.0f) {
+            islandParent[find(manifold.a)] = find(manifold.b);
+        }
+    }
+
+    // Wyspa jest rozwiązywana, gdy ma choć jedno aktywne ciało
+    std::vector<int32_t> islandOfRoot(bodies.size(), -1);
+    std::vector<uint8_t> rootAwake(bodies.size(), 0);
+    for (Body body = 0; body < bodies.size(); body++) {
+        if (bodies[body].alive && bodies[body].awake) {
+            rootAwake[find(body)] = 1;
+        }
+    }
+
+    islandBodyStart.assign(1, 0);
+    std::vector<uint32_t> bodyCounts;
+    for (Body body = 0; body < bodies.size(); body++) {
+        const RigidBody& rigidBody = bodies[body];
+        if (!rigidBody.alive || rigidBody.inverseMass == 0.0f) {
+            continue;
+        }
+        uint32_t root = find(body);
+        if (!rootAwake[root]) {
+            continue;
+        }
+        if (islandOfRoot[root] < 0) {
+            islandOfRoot[root] = static_cast<int32_t>(bodyCounts.size());
+            bodyCounts.push_back(0);
+        }
+        bodyCounts[islandOfRoot[root]]++;
+    }
+
+    size_t islandCount = bodyCounts.size();
+    islandBodyStart.resize(islandCount + 1);
+    for (size_t island = 0; island < islandCount; island++) {
+        islandBodyStart[island + 1] = islandBodyStart[island] + bodyCounts[island];
+    }
+    islandBodies.resize(islandBodyStart[islandCount]);
+    std::vector<uint32_t> cursor(islandBodyStart.begin(), islandBodyStart.end() - 1);
+    for (Body body = 0; body < bodies.size(); body++) {
+        if (bodies[body].alive && bodies[body].inverseMass > 0.0f) {
+            int32_t island = islandOfRoot[find(body)];
+            if (island >= 0) {
+                islandBodies[cursor[island]++] = body;
+            }
+        }
+    }
+
+    std::vector<uint32_t> manifoldCounts(islandCount, 0);
+    std::vector<int32_t> manifoldIsland(manifolds.size(), -1);
+    for (size_t i = 0; i < manifolds.size(); i++) {
+        const Manifold& manifold = manifolds[i];
+        if (manifold.contactCount == 0) {
+            continue;
+        }
+        Body dynamic = bodies[manifold.a].inverseMass > 0.0f ? manifold.a : manifold.b;
+        int32_t island = islandOfRoot[find(dynamic)];
+        if (island >= 0) {
+            manifoldIsland[i] = island;
+            manifoldCounts[island]++;
+        }
+    }
+    islandManifoldStart.assign(islandCount + 1, 0);
+    for (size_t island = 0; island < islandCount; island++) {
+        islandManifoldStart[island + 1] = islandManifoldStart[island] + manifoldCounts[island];
+    }
+    islandManifolds.resize(islandManifoldStart[islandCount]);
+    cursor.assign(islandManifoldStart.begin(), islandManifoldStart.end() - 1);
+    for (size_t i = 0; i < manifolds.size(); i++) {
+        if (manifoldIsland[i] >= 0) {
+            islandManifolds[cursor[manifoldIsland[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+void PhysicsWorld::solveIsland(size_t island, float dt) {
+    const Body* islandBodyList = islandBodies.data() + islandBodyStart[island];
+    size_t bodyCount = islandBodyStart[island + 1] - islandBodyStart[island];
+    const uint32_t* islandManifoldList = islandManifolds.data() + islandManifoldStart[island];
+    size_t manifoldCount = islandManifoldStart[island + 1] - islandManifoldStart[island];
+
+    // Prędkości kopiowane są do zwartej tablicy wyspy; ostatni element zastępuje ciała statyczne
+    thread_local std::vector<SolverBody> velocities;
+    thread_local std::vector<SolverContact> solverContacts;
+    velocities.resize(bodyCount + 1);
+    velocities[bodyCount] = { glm::vec3(0.0f), glm::vec3(0.0f) };
+
+    float damping = 1.0f / (1.0f + dt * ANGULAR_DAMPING);
+    for (size_t i = 0; i < bodyCount; i++) {
+        RigidBody& body = bodies[islandBodyList[i]];
+        if (!body.awake) {
+            body.awake = true;
+            body.sleepTime = 0.0f;
+        }
+        body.linearVelocity += gravity * dt;
+        body.angularVelocity *= damping;
+        velocities[i] = { body.linearVelocity, body.angularVelocity };
+        solverIndex[islandBodyList[i]] = static_cast<uint32_t>(i);
+    }
+
+    auto localIndex = [&](Body body, bool plane) {
+        return plane || bodies[body].inverseMass == 0.0f ? static_cast<uint32_t>(bodyCount) : solverIndex[body];
+    };
+
+    solverContacts.clear();
+    for (size_t m = 0; m < manifoldCount; m++) {
+        const Manifold& manifold = manifolds[islandManifoldList[m]];
+        const RigidBody& a = bodies[manifold.a];
+        const RigidBody* b = manifold.plane ? nullptr : &bodies[manifold.b];
+        uint32_t indexA = localIndex(manifold.a, false), indexB = localIndex(manifold.b, manifold.plane);
+        const glm::vec3 directions[3] = { manifold.normal, manifold.tangents[0], manifold.tangents[1] };
+
+        for (int i = 0; i < manifold.contactCount; i++) {
+            const Contact& contact = manifold.contacts[i];
+            SolverContact solverContact;
+            solverContact.indexA = indexA;
+            solverContact.indexB = indexB;
+            solverContact.inverseMassA = a.inverseMass;
+            solverContact.inverseMassB = b ? b->inverseMass : 0.0f;
+
+            glm::vec3 rA = contact.position - a.position;
+            glm::vec3 rB = b ? contact.position - b->position : glm::vec3(0.0f);
+            const float impulses[3] = { contact.normalImpulse, contact.tangentImpulse[0], contact.tangentImpulse[1] };
+            for (int k = 0; k < 3; k++) {
+                SolverRow& row = solverContact.rows[k];
+                row.direction = directions[k];
+                row.angularA = glm::cross(rA, directions[k]);
+                row.angularB = glm::cross(rB, directions[k]);
+                row.impulseA = a.inverseInertiaWorld * row.angularA;
+                row.impulseB = b ? b->inverseInertiaWorld * row.angularB : glm::vec3(0.0f);
+                float mass = solverContact.inverseMassA + solverContact.inverseMassB
+                           + glm::dot(row.angularA, row.impulseA) + glm::dot(row.angularB, row.impulseB);
+                row.mass = mass > 0.0f ? 1.0f / mass : 0.0f;
+                row.impulse = impulses[k];
+            }
+
+            // Przenikanie wypychane ułamkiem głębokości na krok, kontakt w marginesie może się jeszcze zbliżyć
+            if (contact.penetration > PENETRATION_SLOP) {
+                solverContact.bias = std::min(BAUMGARTE / dt * (contact.penetration - PENETRATION_SLOP), MAX_CORRECTION_VELOCITY);
+            }
+            else {
+                solverContact.bias = std::min(contact.penetration, 0.0f) / dt;
+            }
+            const SolverBody& velocityA = velocities[indexA];
+            const SolverBody& velocityB = velocities[indexB];
+            const SolverRow& normalRow = solverContact.rows[0];
+            float normalVelocity = glm::dot(normalRow.direction, velocityB.linearVelocity - velocityA.linearVelocity)
+                                 + glm::dot(normalRow.angularB, velocityB.angularVelocity) - glm::dot(normalRow.angularA, velocityA.angularVelocity);
+            if (normalVelocity < -RESTITUTION_THRESHOLD) {
+                solverContact.bias = std::max(solverContact.bias, -RESTITUTION * normalVelocity);
+            }
+            solverContacts.push_back(solverContact);
+        }
+    }
+
+    auto applyImpulse = [](SolverBody& a, SolverBody& b, const SolverContact& contact, const SolverRow& row, float lambda) {
+        a.linearVelocity -= row.direction * (lambda * contact.inverseMassA);
+        a.angularVelocity -= row.impulseA * lambda;
+        b.linearVelocity += row.direction * (lambda * contact.inverseMassB);
+        b.angularVelocity += row.impulseB * lambda;
+    };
+    auto rowVelocity = [](const SolverBody& a, const SolverBody& b, const SolverRow& row) {
+        return glm::dot(row.direction, b.linearVelocity - a.linearVelocity)
+             + glm::dot(row.angularB, b.angularVelocity) - glm::dot(row.angularA, a.angularVelocity);
+    };
+
+    // Ciepły start impulsami z poprzedniego kroku
+    for (const SolverContact& contact : solverContacts) {
+        for (const SolverRow& row : contact.rows) {
+            applyImpulse(velocities[contact.indexA], velocities[contact.indexB], contact, row, row.impulse);
+        }
+    }
+
+    for (int iteration = 0; iteration < VELOCITY_ITERATIONS; iteration++) {
+        for (SolverContact& contact : solverContacts) {
+            SolverBody& a = velocities[contact.indexA];
+            SolverBody& b = velocities[contact.indexB];
+
+            float maxFriction = FRICTION * contact.rows[0].impulse;
+            for (int k = 1; k < 3; k++) {
+                SolverRow& row = contact.rows[k];
+                float accumulated = glm::clamp(row.impulse - rowVelocity(a, b, row) * row.mass, -maxFriction, maxFriction);
+                float lambda = accumulated - row.impulse;
+                row.impulse = accumulated;
+                applyImpulse(a, b, contact, row, lambda);
+            }
+
+            SolverRow& row = contact.rows[0];
+            float accumulated = std::max(row.impulse + row.mass * (contact.bias - rowVelocity(a, b, row)), 0.0f);
+            float lambda = accumulated - row.impulse;
+            row.impulse = accumulated;
+            applyImpulse(a, b, contact, row, lambda);
+        }
+    }
+
+    size_t next = 0;
+    for (size_t m = 0; m < manifoldCount; m++) {
+        Manifold& manifold = manifolds[islandManifoldList[m]];
+        for (int i = 0; i < manifold.contactCount; i++) {
+            const SolverContact& solverContact = solverContacts[next++];
+            manifold.contacts[i].normalImpulse = solverContact.rows[0].impulse;
+            manifold.contacts[i].tangentImpulse[0] = solverContact.rows[1].impulse;
+            manifold.contacts[i].tangentImpulse[1] = solverContact.rows[2].impulse;
+        }
+    }
+
+    float minSleepTime = FLT_MAX;
+    for (size_t i = 0; i < bodyCount; i++) {
+        RigidBody& body = bodies[islandBodyList[i]];
+        body.linearVelocity = velocities[i].linearVelocity;
+        body.angularVelocity = velocities[i].angularVelocity;
+        body.position += body.linearVelocity * dt;
+        glm::quat spin(0.0f, body.angularVelocity);
+        body.orientation = glm::normalize(body.orientation + spin * body.orientation * (0.5f * dt));
+        updateDerived(body);
+
+        bool resting = glm::dot(body.linearVelocity, body.linearVelocity) < LINEAR_SLEEP_TOLERANCE * LINEAR_SLEEP_TOLERANCE
+                    && glm::dot(body.angularVelocity, body.angularVelocity) < ANGULAR_SLEEP_TOLERANCE * ANGULAR_SLEEP_TOLERANCE;
+        body.sleepTime = resting ? body.sleepTime + dt : 0.0f;
+        minSleepTime = std::min(minSleepTime, body.sleepTime);
+    }
+
+    if (minSleepTime >= TIME_TO_SLEEP) {
+        for (size_t i = 0; i < bodyCount; i++) {
+            RigidBody& body = bodies[islandBodyList[i]];
+            body.awake = false;
+            body.linearVelocity = glm::vec3(0.0f);
+            body.angularVelocity = glm::vec3(0.0f);
+        }
+    }
+}
+
+glm::vec3 PhysicsWorld::getPosition(Body body) const {
+    return bodies[body].position;
+}
+
+glm::quat PhysicsWorld::getOrientation(Body body) const {
+    return bodies[body].orientation;
+}
+
+bool PhysicsWorld::isAwake(Body body) const {
+    return bodies[body].alive && bodies[body].awake;
+}
+
+size_t PhysicsWorld::getBodyCount() const {
+    return bodies.size() - freeBodies.size() - removedBodies.size();
+}
+
+size_t PhysicsWorld::getAwakeCount() const {
+    return awakeCount;
+}
+
+size_t PhysicsWorld::getPairCount() const {
+    return pairs.size();
+}
+
+size_t PhysicsWorld::getContactCount() const {
+    return contactCount;
+}
+
+size_t PhysicsWorld::getIslandCount() const {
+    return islandBodyStart.empty() ? 0 : islandBodyStart.size() - 1;
+}
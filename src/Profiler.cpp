@@ -0,0 +1,141 @@
+#include "Profiler.h"
+
+Profiler::Profiler(double reportInterval) : reportInterval(reportInterval) {
+    for (FrameQueries& frame : frames) {
+        glGenQueries(1, &frame.frameStart);
+        glGenQueries(1, &frame.frameEnd);
+    }
+    lastReportTime = std::chrono::steady_clock::now();
+}
+
+Profiler::~Profiler() {
+    for (FrameQueries& frame : frames) {
+        glDeleteQueries(1, &frame.frameStart);
+        glDeleteQueries(1, &frame.frameEnd);
+        for (PassQuery& pass : frame.passes) {
+            glDeleteQueries(1, &pass.startQuery);
+            glDeleteQueries(1, &pass.endQuery);
+        }
+    }
+}
+
+void Profiler::beginFrame() {
+    FrameQueries& frame = frames[frameIndex % FRAME_LATENCY];
+    if (frame.pending) {
+        resolve(frame);
+    }
+
+    frame.usedPasses = 0;
+    frame.pending = true;
+    openPasses.clear();
+    frameStartTime = std::chrono::steady_clock::now();
+    glQueryCounter(frame.frameStart, GL_TIMESTAMP);
+}
+
+void Profiler::endFrame() {
+    FrameQueries& frame = frames[frameIndex % FRAME_LATENCY];
+    glQueryCounter(frame.frameEnd, GL_TIMESTAMP);
+    frameIndex++;
+
+    auto now = std::chrono::steady_clock::now();
+    cpuFrame.last = std::chrono::duration<double, std::milli>(now - frameStartTime).count();
+    cpuFrame.total += cpuFrame.last;
+    cpuFrame.samples++;
+
+    if (std::chrono::duration<double>(now - lastReportTime).count() >= reportInterval) {
+        report();
+        lastReportTime = now;
+    }
+}
+
+void Profiler::beginPass(const std::string& name) {
+    FrameQueries& frame = frames[frameIndex % FRAME_LATENCY];
+    if (frame.usedPasses == frame.passes.size()) {
+        PassQuery pass;
+        glGenQueries(1, &pass.startQuery);
+        glGenQueries(1, &pass.endQuery);
+        frame.passes.push_back(pass);
+    }
+
+    PassQuery& pass = frame.passes[frame.usedPasses];
+    pass.name = name;
+    glQueryCounter(pass.startQuery, GL_TIMESTAMP);
+    openPasses.push_back(frame.usedPasses);
+    frame.usedPasses++;
+}
+
+void Profiler::endPass() {
+    if (openPasses.empty()) {
+        return;
+    }
+    FrameQueries& frame = frames[frameIndex % FRAME_LATENCY];
+    glQueryCounter(frame.passes[openPasses.back()].endQuery, GL_TIMESTAMP);
+    openPasses.pop_back();
+}
+
+void Profiler::setCounter(const std::string& name, double value) {
+    counters[name] = value;
+}
+
+double Profiler::getPassTime(const std::string& name) const {
+    auto it = stats.find(name);
+    return it != stats.end() ? it->second.last : 0.0;
+}
+
+double Profiler::getGpuFrameTime() const {
+    return gpuFrame.last;
+}
+
+void Profiler::resolve(FrameQueries& frame) {
+    frame.pending = false;
+
+    // Wyniki odczytujemy tylko gdy są gotowe - czekanie na GPU zafałszowałoby pomiar
+    GLint available = 0;
+    glGetQueryObjectiv(frame.frameEnd, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        droppedFrames++;
+        return;
+    }
+
+    GLuint64 start = 0, end = 0;
+    glGetQueryObjectui64v(frame.frameStart, GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(frame.frameEnd, GL_QUERY_RESULT, &end);
+    gpuFrame.last = (end - start) / 1.0e6;
+    gpuFrame.total += gpuFrame.last;
+    gpuFrame.samples++;
+
+    for (size_t i = 0; i < frame.usedPasses; i++) {
+        glGetQueryObjectui64v(frame.passes[i].startQuery, GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.passes[i].endQuery, GL_QUERY_RESULT, &end);
+        Stat& stat = stats[frame.passes[i].name];
+        stat.last = (end - start) / 1.0e6;
+        stat.total += stat.last;
+        stat.samples++;
+    }
+}
+
+void Profiler::report() {
+    auto average = [](const Stat& stat) {
+        return stat.samples > 0 ? stat.total / stat.samples : 0.0;
+    };
+
+    std::cout << "[Profiler] CPU: " << average(cpuFrame) << " ms, GPU: " << average(gpuFrame) << " ms";
+    for (auto& [name, stat] : stats) {
+        std::cout << " | " << name << ": " << average(stat) << " ms";
+        stat.total = 0.0;
+        stat.samples = 0;
+    }
+    for (const auto& [name, value] : counters) {
+        std::cout << " | " << name << ": " << value;
+    }
+    if (droppedFrames > 0) {
+        std::cout << " | dropped: " << droppedFrames;
+    }
+    std::cout << std::endl;
+
+    cpuFrame.total = 0.0;
+    cpuFrame.samples = 0;
+    gpuFrame.total = 0.0;
+    gpuFrame.samples = 0;
+    droppedFrames = 0;
+}
@@ -0,0 +1,106 @@
+#include "SceneFile.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+
+const char* DEFAULT_PATH = "scene_benchmark.scene";
+
+double elapsed(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int objectCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000000;
+    std::string path = argc > 2 ? argv[2] : DEFAULT_PATH;
+
+    // Sześciany rozrzucone w sześcianie o boku rosnącym z pierwiastkiem sześciennym liczby obiektów
+    SceneData scene;
+    float side = std::cbrt(static_cast<float>(objectCount)) * 3.0f;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, side), angle(0.0f, 3.14159265f);
+    scene.objects.resize(objectCount);
+    for (SceneObject& object : scene.objects) {
+        glm::vec3 axis = glm::normalize(glm::vec3(coordinate(random), coordinate(random), coordinate(random)) + 0.01f);
+        glm::quat orientation = glm::angleAxis(angle(random), axis);
+        object.position[0] = coordinate(random);
+        object.position[1] = coordinate(random);
+        object.position[2] = coordinate(random);
+        object.kind = SCENE_OBJECT_CUBE;
+        object.orientation[0] = orientation.x;
+        object.orientation[1] = orientation.y;
+        object.orientation[2] = orientation.z;
+        object.orientation[3] = orientation.w;
+        object.halfExtents[0] = object.halfExtents[1] = object.halfExtents[2] = 0.5f;
+        object.material = random() % 2;
+    }
+    scene.materials.resize(2);
+    std::strncpy(scene.materials[0].texture, "textures/wall.jpg", sizeof(SceneMaterial::texture) - 1);
+    std::strncpy(scene.materials[1].texture, "textures/wood.jpg", sizeof(SceneMaterial::texture) - 1);
+    scene.lights.push_back({ { 0.0f, side, 0.0f }, { 3.0f, 3.0f, 3.0f } });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!SceneFile::write(path, scene)) {
+        return 1;
+    }
+    double writeTime = elapsed(start);
+    size_t fileSize = static_cast<size_t>(std::ifstream(path, std::ios::binary | std::ios::ate).tellg());
+
+    // Odczyt strumieniem do wektora - punkt odniesienia dla mapowania
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<char> buffer(fileSize);
+    std::ifstream(path, std::ios::binary).read(buffer.data(), static_cast<std::streamsize>(fileSize));
+    double readTime = elapsed(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    SceneFile file;
+    if (!file.open(path)) {
+        return 1;
+    }
+    double openTime = elapsed(start);
+
+    // Pierwsze przejście dotyka wszystkich stron; tablice silnika budowane są wprost z rekordów
+    start = std::chrono::high_resolution_clock::now();
+    const SceneFileHeader& header = file.getHeader();
+    const SceneObject* objects = file.getObjects();
+    std::vector<glm::vec3> positions(header.objectCount);
+    std::vector<glm::quat> orientations(header.objectCount);
+    size_t invalidMaterials = 0;
+    for (uint32_t i = 0; i < header.objectCount; i++) {
+        const SceneObject& object = objects[i];
+        positions[i] = glm::vec3(object.position[0], object.position[1], object.position[2]);
+        orientations[i] = glm::quat(object.orientation[3], object.orientation[0], object.orientation[1], object.orientation[2]);
+        invalidMaterials += object.material >= header.materialCount;
+    }
+    double gatherTime = elapsed(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<SceneObject> copy(objects, objects + header.objectCount);
+    double copyTime = elapsed(start);
+
+    std::cout << header.objectCount << " objects, " << fileSize / (1024.0 * 1024.0) << " MB (" << path << ")" << std::endl;
+    std::cout << "write           " << writeTime << " ms" << std::endl;
+    std::cout << "stream read     " << readTime << " ms" << std::endl;
+    std::cout << "map + validate  " << openTime << " ms" << std::endl;
+    std::cout << "gather arrays   " << gatherTime << " ms (first touch of every page)" << std::endl;
+    std::cout << "bulk copy       " << copyTime << " ms" << std::endl;
+    if (invalidMaterials > 0) {
+        std::cout << invalidMaterials << " objects reference missing materials" << std::endl;
+    }
+
+    file.close();
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "SceneFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+bool SceneFile::open(const std::string& path) {
+    close();
+
+    if (!file.open(path)) {
+        return false;
+    }
+    data = file.getData();
+    size_t size = file.getSize();
+
+    if (size < sizeof(SceneFileHeader)) {
+        std::cerr << "Scene file is truncated: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    const SceneFileHeader& header = getHeader();
+    if (std::memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) != 0 || header.version != SCENE_FILE_VERSION) {
+        std::cerr << "Unsupported scene file format or version: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Przesunięcia muszą zachować wyrównanie rekordów, bo sekcje czytane są wprost jako tablice
+    uint64_t misaligned = (header.objectOffset | header.materialOffset | header.lightOffset) % SCENE_FILE_ALIGNMENT;
+    if (misaligned != 0 || !file.containsRange(header.objectOffset, header.objectCount, sizeof(SceneObject))
+        || !file.containsRange(header.materialOffset, header.materialCount, sizeof(SceneMaterial))
+        || !file.containsRange(header.lightOffset, header.lightCount, sizeof(SceneLight))) {
+        std::cerr << "Scene file sections are misaligned or exceed file size: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SceneFile::close() {
+    file.close();
+    data = nullptr;
+}
+
+const SceneFileHeader& SceneFile::getHeader() const {
+    return *reinterpret_cast<const SceneFileHeader*>(data);
+}
+
+const SceneObject* SceneFile::getObjects() const {
+    return reinterpret_cast<const SceneObject*>(data + getHeader().objectOffset);
+}
+
+const SceneMaterial* SceneFile::getMaterials() const {
+    return reinterpret_cast<const SceneMaterial*>(data + getHeader().materialOffset);
+}
+
+const SceneLight* SceneFile::getLights() const {
+    return reinterpret_cast<const SceneLight*>(data + getHeader().lightOffset);
+}
+
+bool SceneFile::write(const std::string& path, const SceneData& scene) {
+    auto align = [](uint64_t offset) {
+        return (offset + SCENE_FILE_ALIGNMENT - 1) / SCENE_FILE_ALIGNMENT * SCENE_FILE_ALIGNMENT;
+    };
+
+    SceneFileHeader header = {};
+    std::memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC));
+    header.version = SCENE_FILE_VERSION;
+    header.objectCount = static_cast<uint32_t>(scene.objects.size());
+    header.materialCount = static_cast<uint32_t>(scene.materials.size());
+    header.lightCount = static_cast<uint32_t>(scene.lights.size());
+    header.camera = scene.camera;
+
+    header.objectOffset = align(sizeof(SceneFileHeader));
+    header.materialOffset = align(header.objectOffset + scene.objects.size() * sizeof(SceneObject));
+    header.lightOffset = align(header.materialOffset + scene.materials.size() * sizeof(SceneMaterial));
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open scene file for writing: " << path << std::endl;
+        return false;
+    }
+
+    auto pad = [&file](uint64_t offset) {
+        static const char zeros[SCENE_FILE_ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        file.write(zeros, static_cast<std::streamsize>(offset - position));
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad(header.objectOffset);
+    file.write(reinterpret_cast<const char*>(scene.objects.data()), static_cast<std::streamsize>(scene.objects.size() * sizeof(SceneObject)));
+    pad(header.materialOffset);
+    file.write(reinterpret_cast<const char*>(scene.materials.data()), static_cast<std::streamsize>(scene.materials.size() * sizeof(SceneMaterial)));
+    pad(header.lightOffset);
+    file.write(reinterpret_cast<const char*>(scene.lights.data()), static_cast<std::streamsize>(scene.lights.size() * sizeof(SceneLight)));
+    return file.good();
+}
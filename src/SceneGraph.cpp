@@ -0,0 +1,367 @@
+#include "SceneGraph.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCENEGRAPH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+struct Lane1 {
+    float v;
+
+    static constexpr size_t WIDTH = 1;
+    static Lane1 set(float value) { return { value }; }
+    static Lane1 load(const float* source) { return { *source }; }
+    static Lane1 gather(const float* source, const uint32_t* indices) { return { source[indices[0]] }; }
+    void store(float* target) const { *target = v; }
+};
+
+inline Lane1 operator+(Lane1 a, Lane1 b) { return { a.v + b.v }; }
+inline Lane1 operator-(Lane1 a, Lane1 b) { return { a.v - b.v }; }
+inline Lane1 operator*(Lane1 a, Lane1 b) { return { a.v * b.v }; }
+
+#ifdef SCENEGRAPH_SSE
+struct Lane4 {
+    __m128 v;
+
+    static constexpr size_t WIDTH = 4;
+    static Lane4 set(float value) { return { _mm_set1_ps(value) }; }
+    static Lane4 load(const float* source) { return { _mm_loadu_ps(source) }; }
+    static Lane4 gather(const float* source, const uint32_t* indices) {
+        // Rodzeństwo zwykle leży obok siebie - wtedy wystarczy jedno rozgłoszenie
+        if (indices[0] == indices[1] && indices[0] == indices[2] && indices[0] == indices[3]) {
+            return { _mm_set1_ps(source[indices[0]]) };
+        }
+        return { _mm_setr_ps(source[indices[0]], source[indices[1]], source[indices[2]], source[indices[3]]) };
+    }
+    void store(float* target) const { _mm_storeu_ps(target, v); }
+};
+
+inline Lane4 operator+(Lane4 a, Lane4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline Lane4 operator-(Lane4 a, Lane4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline Lane4 operator*(Lane4 a, Lane4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+#endif
+
+const float IDENTITY_WORLD[12] = { 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 };
+const size_t PARALLEL_LEVEL_SIZE = 8192;
+const size_t PARALLEL_GRAIN = 2048;
+
+}
+
+SceneGraph::SceneGraph() {
+    parents.push_back(0);
+    depths.push_back(0);
+    dirty.push_back(0);
+    for (int i = 0; i < 3; i++) {
+        position[i].push_back(0.0f);
+        scale[i].push_back(1.0f);
+    }
+    for (int i = 0; i < 4; i++) {
+        rotation[i].push_back(i == 3 ? 1.0f : 0.0f);
+    }
+    for (int i = 0; i < 12; i++) {
+        world[i].push_back(IDENTITY_WORLD[i]);
+    }
+    handleToIndex.push_back(0);
+    indexToHandle.push_back(ROOT);
+    levelStarts = { 0, 1 };
+}
+
+SceneGraph::Node SceneGraph::createNode(Node parent) {
+    uint32_t parentIndex = handleToIndex[parent];
+    uint32_t index = static_cast<uint32_t>(parents.size());
+    uint32_t depth = depths[parentIndex] + 1;
+
+    // Węzeł płytszy niż ostatni w tablicach łamie porządek poziomów
+    if (depth < depths.back()) {
+        orderDirty = true;
+    }
+    levelsDirty = true;
+
+    parents.push_back(parentIndex);
+    depths.push_back(depth);
+    dirty.push_back(1);
+    for (int i = 0; i < 3; i++) {
+        position[i].push_back(0.0f);
+        scale[i].push_back(1.0f);
+    }
+    for (int i = 0; i < 4; i++) {
+        rotation[i].push_back(i == 3 ? 1.0f : 0.0f);
+    }
+    for (int i = 0; i < 12; i++) {
+        world[i].push_back(IDENTITY_WORLD[i]);
+    }
+
+    Node node = static_cast<Node>(handleToIndex.size());
+    handleToIndex.push_back(index);
+    indexToHandle.push_back(node);
+    return node;
+}
+
+bool SceneGraph::setParent(Node node, Node parent) {
+    uint32_t index = handleToIndex[node];
+    uint32_t parentIndex = handleToIndex[parent];
+    if (node == ROOT) {
+        return false;
+    }
+    for (uint32_t ancestor = parentIndex; ancestor != 0; ancestor = parents[ancestor]) {
+        if (ancestor == index) {
+            return false;
+        }
+    }
+
+    parents[index] = parentIndex;
+    dirty[index] = 1;
+    orderDirty = true;
+    return true;
+}
+
+void SceneGraph::setPosition(Node node, const glm::vec3& value) {
+    uint32_t index = handleToIndex[node];
+    position[0][index] = value.x;
+    position[1][index] = value.y;
+    position[2][index] = value.z;
+    dirty[index] = 1;
+}
+
+void SceneGraph::translate(Node node, const glm::vec3& direction) {
+    setPosition(node, getPosition(node) + direction);
+}
+
+void SceneGraph::setRotation(Node node, float angle, const glm::vec3& axis) {
+    uint32_t index = handleToIndex[node];
+    glm::vec3 unit = glm::normalize(axis);
+    float half = glm::radians(angle) * 0.5f;
+    float s = std::sin(half);
+    rotation[0][index] = unit.x * s;
+    rotation[1][index] = unit.y * s;
+    rotation[2][index] = unit.z * s;
+    rotation[3][index] = std::cos(half);
+    dirty[index] = 1;
+}
+
+void SceneGraph::rotate(Node node, float angle, const glm::vec3& axis) {
+    uint32_t index = handleToIndex[node];
+    glm::vec3 unit = glm::normalize(axis);
+    float half = glm::radians(angle) * 0.5f;
+    float s = std::sin(half);
+    float ax = unit.x * s, ay = unit.y * s, az = unit.z * s, aw = std::cos(half);
+    float bx = rotation[0][index], by = rotation[1][index], bz = rotation[2][index], bw = rotation[3][index];
+
+    // Iloczyn kwaternionów a * b - nowy obrót wykonywany po dotychczasowym
+    float x = aw * bx + ax * bw + ay * bz - az * by;
+    float y = aw * by - ax * bz + ay * bw + az * bx;
+    float z = aw * bz + ax * by - ay * bx + az * bw;
+    float w = aw * bw - ax * bx - ay * by - az * bz;
+    float length = std::sqrt(x * x + y * y + z * z + w * w);
+    rotation[0][index] = x / length;
+    rotation[1][index] = y / length;
+    rotation[2][index] = z / length;
+    rotation[3][index] = w / length;
+    dirty[index] = 1;
+}
+
+void SceneGraph::setScale(Node node, const glm::vec3& value) {
+    uint32_t index = handleToIndex[node];
+    scale[0][index] = value.x;
+    scale[1][index] = value.y;
+    scale[2][index] = value.z;
+    dirty[index] = 1;
+}
+
+glm::vec3 SceneGraph::getPosition(Node node) const {
+    uint32_t index = handleToIndex[node];
+    return glm::vec3(position[0][index], position[1][index], position[2][index]);
+}
+
+void SceneGraph::rebuildOrder() {
+    size_t count = parents.size();
+
+    if (orderDirty) {
+        // Głębokości po przepięciu - rodzic może leżeć w tablicach za dzieckiem
+        std::vector<uint8_t> known(count, 0);
+        std::vector<uint32_t> chain;
+        known[0] = 1;
+        for (uint32_t i = 1; i < count; i++) {
+            uint32_t current = i;
+            while (!known[current]) {
+                chain.push_back(current);
+                current = parents[current];
+            }
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                depths[*it] = depths[parents[*it]] + 1;
+                known[*it] = 1;
+            }
+            chain.clear();
+        }
+
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return depths[a] < depths[b];
+        });
+        std::vector<uint32_t> newIndex(count);
+        for (uint32_t i = 0; i < count; i++) {
+            newIndex[order[i]] = i;
+        }
+
+        auto permute = [&order](auto& values) {
+            std::remove_reference_t<decltype(values)> sorted(values.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                sorted[i] = values[order[i]];
+            }
+            values.swap(sorted);
+        };
+        permute(parents);
+        permute(depths);
+        permute(dirty);
+        permute(indexToHandle);
+        for (auto* arrays : { position, scale }) {
+            for (int i = 0; i < 3; i++) {
+                permute(arrays[i]);
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            permute(rotation[i]);
+        }
+        for (int i = 0; i < 12; i++) {
+            permute(world[i]);
+        }
+        for (uint32_t& parent : parents) {
+            parent = newIndex[parent];
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            handleToIndex[indexToHandle[i]] = i;
+        }
+        orderDirty = false;
+    }
+
+    levelStarts.clear();
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0 || depths[i] != depths[i - 1]) {
+            levelStarts.push_back(i);
+        }
+    }
+    levelStarts.push_back(count);
+    levelsDirty = false;
+}
+
+template <typename Lane>
+void SceneGraph::updateLanes(size_t first) {
+    const Lane one = Lane::set(1.0f);
+    const Lane two = Lane::set(2.0f);
+
+    Lane qx = Lane::load(&rotation[0][first]);
+    Lane qy = Lane::load(&rotation[1][first]);
+    Lane qz = Lane::load(&rotation[2][first]);
+    Lane qw = Lane::load(&rotation[3][first]);
+    Lane sx = Lane::load(&scale[0][first]);
+    Lane sy = Lane::load(&scale[1][first]);
+    Lane sz = Lane::load(&scale[2][first]);
+
+    Lane xx = qx * qx, yy = qy * qy, zz = qz * qz;
+    Lane xy = qx * qy, xz = qx * qz, yz = qy * qz;
+    Lane wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+    // Macierz lokalna 3x4 (kolumny obrotu przeskalowane, ostatnia kolumna to przesunięcie)
+    Lane local[12] = {
+        (one - two * (yy + zz)) * sx, two * (xy + wz) * sx, two * (xz - wy) * sx,
+        two * (xy - wz) * sy, (one - two * (xx + zz)) * sy, two * (yz + wx) * sy,
+        two * (xz + wy) * sz, two * (yz - wx) * sz, (one - two * (xx + yy)) * sz,
+        Lane::load(&position[0][first]), Lane::load(&position[1][first]), Lane::load(&position[2][first])
+    };
+
+    Lane parent[12];
+    for (int i = 0; i < 12; i++) {
+        parent[i] = Lane::gather(world[i].data(), &parents[first]);
+    }
+
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            Lane value = parent[row] * local[column * 3] + parent[3 + row] * local[column * 3 + 1] + parent[6 + row] * local[column * 3 + 2];
+            value.store(&world[column * 3 + row][first]);
+        }
+    }
+    for (int row = 0; row < 3; row++) {
+        Lane value = parent[row] * local[9] + parent[3 + row] * local[10] + parent[6 + row] * local[11] + parent[9 + row];
+        value.store(&world[9 + row][first]);
+    }
+}
+
+size_t SceneGraph::updateRange(size_t first, size_t last) {
+    size_t updated = 0;
+    for (size_t i = first; i < last; i++) {
+        dirty[i] |= dirty[parents[i]];
+        updated += dirty[i];
+    }
+
+    size_t i = first;
+#ifdef SCENEGRAPH_SSE
+    for (; i + Lane4::WIDTH <= last; i += Lane4::WIDTH) {
+        if (dirty[i] | dirty[i + 1] | dirty[i + 2] | dirty[i + 3]) {
+            updateLanes<Lane4>(i);
+        }
+    }
+#endif
+    for (; i < last; i++) {
+        if (dirty[i]) {
+            updateLanes<Lane1>(i);
+        }
+    }
+    return updated;
+}
+
+void SceneGraph::update(JobSystem* jobs) {
+    if (orderDirty || levelsDirty) {
+        rebuildOrder();
+    }
+
+    // Poziom 0 to sam korzeń; w obrębie poziomu węzły są niezależne, więc można je liczyć czwórkami
+    // i dzielić między wątki - rodzice leżą w poprzednich, już policzonych poziomach
+    std::atomic<size_t> updated{ 0 };
+    for (size_t level = 1; level + 1 < levelStarts.size(); level++) {
+        size_t begin = levelStarts[level];
+        size_t end = levelStarts[level + 1];
+        if (jobs && end - begin >= PARALLEL_LEVEL_SIZE) {
+            jobs->parallelFor(end - begin, PARALLEL_GRAIN, [this, begin, &updated](size_t first, size_t last) {
+                updated.fetch_add(updateRange(begin + first, begin + last), std::memory_order_relaxed);
+            });
+        }
+        else {
+            updated.fetch_add(updateRange(begin, end), std::memory_order_relaxed);
+        }
+    }
+    updatedCount = updated.load();
+
+    std::fill(dirty.begin(), dirty.end(), 0);
+}
+
+glm::mat4 SceneGraph::getWorldMatrix(Node node) const {
+    uint32_t index = handleToIndex[node];
+    return glm::mat4(
+        glm::vec4(world[0][index], world[1][index], world[2][index], 0.0f),
+        glm::vec4(world[3][index], world[4][index], world[5][index], 0.0f),
+        glm::vec4(world[6][index], world[7][index], world[8][index], 0.0f),
+        glm::vec4(world[9][index], world[10][index], world[11][index], 1.0f));
+}
+
+glm::vec3 SceneGraph::getWorldPosition(Node node) const {
+    uint32_t index = handleToIndex[node];
+    return glm::vec3(world[9][index], world[10][index], world[11][index]);
+}
+
+size_t SceneGraph::getNodeCount() const {
+    return parents.size() - 1;
+}
+
+size_t SceneGraph::getUpdatedCount() const {
+    return updatedCount;
+}
@@ -0,0 +1,120 @@
+#include "ScenePicker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Numer ściany dla [oś pudła][czy normalna jest dodatnia], zgodny z Cube::setTextureForSide
+const int FACE_INDEX[3][2] = { { 2, 3 }, { 5, 4 }, { 1, 0 } };
+
+}
+
+ScenePicker::Target ScenePicker::add(Entity entity, const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents) {
+    Target target;
+    if (!freeTargets.empty()) {
+        target = freeTargets.back();
+        freeTargets.pop_back();
+    }
+    else {
+        target = static_cast<Target>(boxes.size());
+        boxes.emplace_back();
+    }
+
+    Box& box = boxes[target];
+    box.center = center;
+    box.rotation = glm::mat3_cast(orientation);
+    box.halfExtents = halfExtents;
+    box.entity = entity;
+    box.alive = true;
+    box.proxy = tree.createProxy(computeBounds(box), target);
+    targetCount++;
+    return target;
+}
+
+void ScenePicker::update(Target target, const glm::vec3& center, const glm::quat& orientation) {
+    Box& box = boxes[target];
+    box.center = center;
+    box.rotation = glm::mat3_cast(orientation);
+    tree.moveProxy(box.proxy, computeBounds(box));
+}
+
+void ScenePicker::remove(Target target) {
+    if (target >= boxes.size() || !boxes[target].alive) {
+        return;
+    }
+    tree.destroyProxy(boxes[target].proxy);
+    boxes[target].alive = false;
+    freeTargets.push_back(target);
+    targetCount--;
+}
+
+BoundingBox ScenePicker::computeBounds(const Box& box) {
+    glm::vec3 extents(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        extents += glm::abs(box.rotation[axis]) * box.halfExtents[axis];
+    }
+    BoundingBox bounds;
+    bounds.min = box.center - extents;
+    bounds.max = box.center + extents;
+    return bounds;
+}
+
+bool ScenePicker::pick(const Ray& ray, float maxDistance, Hit& hit) {
+    bool found = false;
+    tree.raycast(ray.origin, ray.direction, maxDistance, [&](uint32_t target, float distance) {
+        const Box& box = boxes[target];
+        glm::mat3 toLocal = glm::transpose(box.rotation);
+        glm::vec3 origin = toLocal * (ray.origin - box.center);
+        glm::vec3 direction = toLocal * ray.direction;
+
+        // Test płyt w układzie pudła; oś, na której promień wchodzi najpóźniej, wyznacza ścianę
+        float enter = -std::numeric_limits<float>::max();
+        float exit = distance;
+        int enterAxis = -1;
+        for (int axis = 0; axis < 3; axis++) {
+            if (std::abs(direction[axis]) < 1e-8f) {
+                if (std::abs(origin[axis]) > box.halfExtents[axis]) {
+                    return distance;
+                }
+                continue;
+            }
+            float inverse = 1.0f / direction[axis];
+            float entry = (-box.halfExtents[axis] - origin[axis]) * inverse;
+            float leave = (box.halfExtents[axis] - origin[axis]) * inverse;
+            if (entry > leave) {
+                std::swap(entry, leave);
+            }
+            if (entry > enter) {
+                enter = entry;
+                enterAxis = axis;
+            }
+            exit = std::min(exit, leave);
+        }
+        if (enterAxis < 0 || enter < 0.0f || enter > exit) {
+            return distance;
+        }
+
+        bool positive = direction[enterAxis] < 0.0f;
+        glm::vec3 normal(0.0f);
+        normal[enterAxis] = positive ? 1.0f : -1.0f;
+
+        found = true;
+        hit.entity = box.entity;
+        hit.distance = enter;
+        hit.face = FACE_INDEX[enterAxis][positive ? 1 : 0];
+        hit.position = ray.at(enter);
+        hit.normal = box.rotation * normal;
+        return enter;
+    });
+    return found;
+}
+
+size_t ScenePicker::getTargetCount() const {
+    return targetCount;
+}
+
+size_t ScenePicker::getVisitedCount() const {
+    return tree.getVisitedCount();
+}
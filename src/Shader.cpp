@@ -52,6 +52,26 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, c
     glDeleteShader(geometryShader);
 }
 
+Shader::Shader(const std::string& computePath) {
+    std::string computeCode = loadShaderFromFile(computePath);
+
+    GLuint computeShader = compileShader(computeCode, GL_COMPUTE_SHADER);
+
+    programID = glCreateProgram();
+    glAttachShader(programID, computeShader);
+    glLinkProgram(programID);
+
+    GLint success;
+    glGetProgramiv(programID, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(programID, 512, nullptr, infoLog);
+        std::cerr << "Shader Program Linking Error:\n" << infoLog << std::endl;
+    }
+
+    glDeleteShader(computeShader);
+}
+
 Shader::~Shader() {
     glDeleteProgram(programID);
 }
@@ -0,0 +1,182 @@
+#include "ShadowAtlas.h"
+
+#include <algorithm>
+#include <numeric>
+
+ShadowAtlas::ShadowAtlas(int atlasSize, int minTileSize, int maxTileSize)
+    : atlasSize(atlasSize), minTileSize(minTileSize), maxTileSize(glm::min(maxTileSize, atlasSize)) {
+    // Liniowa odległość od światła mieści się w 16 bitach - atlas 4096^2 zajmuje 32 MB
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16, atlasSize, atlasSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+ShadowAtlas::~ShadowAtlas() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &depthTexture);
+}
+
+int ShadowAtlas::tileSizeForCoverage(float coverage) const {
+    if (coverage <= 0.0f) {
+        return 0;
+    }
+    int target = static_cast<int>(maxTileSize * glm::min(coverage, 1.0f));
+    int size = minTileSize;
+    while (size * 2 <= target && size * 2 <= maxTileSize) {
+        size *= 2;
+    }
+    return size;
+}
+
+bool ShadowAtlas::pack(const std::vector<int>& requestedSizes) {
+    size_t ownerCount = requestedSizes.size();
+    size_t cellsPerSide = atlasSize / minTileSize;
+    size_t capacity = cellsPerSide * cellsPerSide;
+
+    auto cellsFor = [this](int size) {
+        size_t side = size / minTileSize;
+        return side * side;
+    };
+
+    std::vector<int> sizes(ownerCount, 0);
+    size_t needed = 0;
+    for (size_t i = 0; i < ownerCount; i++) {
+        if (requestedSizes[i] > 0) {
+            sizes[i] = minTileSize;
+            while (sizes[i] * 2 <= requestedSizes[i] && sizes[i] * 2 <= maxTileSize) {
+                sizes[i] *= 2;
+            }
+            needed += cellsFor(sizes[i]) * FACES_PER_OWNER;
+        }
+    }
+
+    // Przepełnienie: zmniejszamy największe kafelki, aż całość zmieści się w atlasie
+    while (needed > capacity) {
+        auto largest = std::max_element(sizes.begin(), sizes.end());
+        if (largest == sizes.end() || *largest <= minTileSize) {
+            break;
+        }
+        needed -= cellsFor(*largest) * FACES_PER_OWNER;
+        *largest /= 2;
+        needed += cellsFor(*largest) * FACES_PER_OWNER;
+    }
+
+    // Kolejność malejąca gwarantuje, że każdy kafelek zaczyna się w wyrównanym kwadracie krzywej Mortona
+    std::vector<size_t> order(ownerCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+        return sizes[a] > sizes[b];
+    });
+
+    tiles.clear();
+    ownerTileSize.assign(ownerCount, 0);
+    ownerFirstTile.assign(ownerCount, -1);
+
+    bool complete = true;
+    size_t cursor = 0;
+    for (size_t owner : order) {
+        if (sizes[owner] == 0) {
+            continue;
+        }
+        size_t cells = cellsFor(sizes[owner]);
+        if (cursor + cells * FACES_PER_OWNER > capacity) {
+            complete = false;
+            continue;
+        }
+
+        ownerTileSize[owner] = sizes[owner];
+        ownerFirstTile[owner] = static_cast<int>(tiles.size());
+        for (int face = 0; face < FACES_PER_OWNER; face++) {
+            glm::ivec2 cell = decodeMorton(static_cast<unsigned int>(cursor));
+            tiles.push_back({ static_cast<int>(owner), face, cell.x * minTileSize, cell.y * minTileSize, sizes[owner] });
+            cursor += cells;
+        }
+    }
+    usedCells = cursor;
+    return complete;
+}
+
+void ShadowAtlas::bindForWriting() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, atlasSize, atlasSize);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+bool ShadowAtlas::setFaceViewports(int owner) const {
+    if (owner < 0 || owner >= static_cast<int>(ownerFirstTile.size()) || ownerFirstTile[owner] < 0) {
+        return false;
+    }
+    for (int face = 0; face < FACES_PER_OWNER; face++) {
+        const Tile& tile = tiles[ownerFirstTile[owner] + face];
+        glViewportIndexedf(face, static_cast<float>(tile.x), static_cast<float>(tile.y), static_cast<float>(tile.size), static_cast<float>(tile.size));
+    }
+    return true;
+}
+
+glm::vec4 ShadowAtlas::getTileRect(int owner, int face) const {
+    if (owner < 0 || owner >= static_cast<int>(ownerFirstTile.size()) || ownerFirstTile[owner] < 0) {
+        return glm::vec4(0.0f);
+    }
+    const Tile& tile = tiles[ownerFirstTile[owner] + face];
+    float scale = 1.0f / atlasSize;
+    return glm::vec4(tile.x * scale, tile.y * scale, tile.size * scale, tile.size * scale);
+}
+
+int ShadowAtlas::getOwnerTileSize(int owner) const {
+    if (owner < 0 || owner >= static_cast<int>(ownerTileSize.size())) {
+        return 0;
+    }
+    return ownerTileSize[owner];
+}
+
+const std::vector<ShadowAtlas::Tile>& ShadowAtlas::getTiles() const {
+    return tiles;
+}
+
+float ShadowAtlas::getOccupancy() const {
+    size_t cellsPerSide = atlasSize / minTileSize;
+    return static_cast<float>(usedCells) / static_cast<float>(cellsPerSide * cellsPerSide);
+}
+
+void ShadowAtlas::printLayout(std::ostream& out) const {
+    out << "Shadow atlas " << atlasSize << "x" << atlasSize << ", " << tiles.size() << " tiles, "
+        << static_cast<int>(getOccupancy() * 100.0f) << "% used" << std::endl;
+    for (const Tile& tile : tiles) {
+        out << "  light " << tile.owner << " face " << tile.face
+            << ": (" << tile.x << ", " << tile.y << ") " << tile.size << "x" << tile.size << std::endl;
+    }
+}
+
+GLuint ShadowAtlas::getTexture() const {
+    return depthTexture;
+}
+
+int ShadowAtlas::getSize() const {
+    return atlasSize;
+}
+
+glm::ivec2 ShadowAtlas::decodeMorton(unsigned int index) {
+    auto compact = [](unsigned int v) {
+        v &= 0x55555555u;
+        v = (v ^ (v >> 1)) & 0x33333333u;
+        v = (v ^ (v >> 2)) & 0x0f0f0f0fu;
+        v = (v ^ (v >> 4)) & 0x00ff00ffu;
+        v = (v ^ (v >> 8)) & 0x0000ffffu;
+        return static_cast<int>(v);
+    };
+    return glm::ivec2(compact(index), compact(index >> 1));
+}
@@ -0,0 +1,332 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Odstęp, na jakim sfera zatrzymuje się przed powierzchnią, żeby następny test nie zaczynał się w styku
+const float SKIN = 0.01f;
+const int MAX_SLIDES = 4;
+// Średnia liczba wpisów na kubełek, powyżej której tablica jest podwajana
+const size_t MAX_LOAD_FACTOR = 2;
+
+}
+
+SpatialHash::SpatialHash(float cellSize, size_t bucketCount)
+    : cellSize(cellSize), inverseCellSize(1.0f / cellSize) {
+    size_t size = 1;
+    while (size < bucketCount) {
+        size <<= 1;
+    }
+    bucketMask = size - 1;
+    buckets.resize(size);
+}
+
+SpatialHash::Collider SpatialHash::add(Entity entity, const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents) {
+    Collider collider;
+    if (!freeColliders.empty()) {
+        collider = freeColliders.back();
+        freeColliders.pop_back();
+    }
+    else {
+        collider = static_cast<Collider>(boxes.size());
+        boxes.emplace_back();
+    }
+
+    Box& box = boxes[collider];
+    box.center = center;
+    box.rotation = glm::mat3_cast(orientation);
+    box.halfExtents = halfExtents;
+    box.entity = entity;
+    box.stamp = queryStamp;
+    box.alive = true;
+    updateBounds(box);
+    insert(collider);
+    colliderCount++;
+    return collider;
+}
+
+void SpatialHash::update(Collider collider, const glm::vec3& center, const glm::quat& orientation) {
+    Box& box = boxes[collider];
+    glm::ivec3 cellMin = box.cellMin;
+    glm::ivec3 cellMax = box.cellMax;
+
+    box.center = center;
+    box.rotation = glm::mat3_cast(orientation);
+    updateBounds(box);
+    if (box.cellMin == cellMin && box.cellMax == cellMax) {
+        return;
+    }
+
+    // Wypisanie ze starego zakresu komórek wymaga starych granic
+    glm::ivec3 newMin = box.cellMin;
+    glm::ivec3 newMax = box.cellMax;
+    box.cellMin = cellMin;
+    box.cellMax = cellMax;
+    erase(collider);
+    box.cellMin = newMin;
+    box.cellMax = newMax;
+    insert(collider);
+}
+
+void SpatialHash::remove(Collider collider) {
+    if (collider >= boxes.size() || !boxes[collider].alive) {
+        return;
+    }
+    erase(collider);
+    boxes[collider].alive = false;
+    freeColliders.push_back(collider);
+    colliderCount--;
+}
+
+void SpatialHash::updateBounds(Box& box) const {
+    // Połowa rozmiaru AABB obróconego pudła to |R| * halfExtents
+    glm::vec3 extents(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        extents += glm::abs(box.rotation[axis]) * box.halfExtents[axis];
+    }
+    box.bounds.min = box.center - extents;
+    box.bounds.max = box.center + extents;
+    box.cellMin = cellOf(box.bounds.min);
+    box.cellMax = cellOf(box.bounds.max);
+}
+
+void SpatialHash::insert(Collider collider) {
+    const Box& box = boxes[collider];
+    for (int z = box.cellMin.z; z <= box.cellMax.z; z++) {
+        for (int y = box.cellMin.y; y <= box.cellMax.y; y++) {
+            for (int x = box.cellMin.x; x <= box.cellMax.x; x++) {
+                buckets[bucketOf(x, y, z)].push_back(collider);
+                entryCount++;
+            }
+        }
+    }
+    if (entryCount > buckets.size() * MAX_LOAD_FACTOR) {
+        grow();
+    }
+}
+
+void SpatialHash::grow() {
+    for (std::vector<Collider>& bucket : buckets) {
+        bucket.clear();
+    }
+    buckets.resize(buckets.size() * 2);
+    bucketMask = buckets.size() - 1;
+
+    for (Collider collider = 0; collider < boxes.size(); collider++) {
+        const Box& box = boxes[collider];
+        if (!box.alive) {
+            continue;
+        }
+        for (int z = box.cellMin.z; z <= box.cellMax.z; z++) {
+            for (int y = box.cellMin.y; y <= box.cellMax.y; y++) {
+                for (int x = box.cellMin.x; x <= box.cellMax.x; x++) {
+                    buckets[bucketOf(x, y, z)].push_back(collider);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::erase(Collider collider) {
+    // Każda komórka wpisała zderzacz raz, więc z każdej usuwane jest jedno wystąpienie
+    const Box& box = boxes[collider];
+    for (int z = box.cellMin.z; z <= box.cellMax.z; z++) {
+        for (int y = box.cellMin.y; y <= box.cellMax.y; y++) {
+            for (int x = box.cellMin.x; x <= box.cellMax.x; x++) {
+                std::vector<Collider>& bucket = buckets[bucketOf(x, y, z)];
+                auto it = std::find(bucket.begin(), bucket.end(), collider);
+                if (it != bucket.end()) {
+                    *it = bucket.back();
+                    bucket.pop_back();
+                    entryCount--;
+                }
+            }
+        }
+    }
+}
+
+size_t SpatialHash::bucketOf(int x, int y, int z) const {
+    uint32_t hash = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u) ^ (static_cast<uint32_t>(z) * 83492791u);
+    return hash & bucketMask;
+}
+
+glm::ivec3 SpatialHash::cellOf(const glm::vec3& point) const {
+    return glm::ivec3(glm::floor(point * inverseCellSize));
+}
+
+template <typename Visit>
+void SpatialHash::forEachCandidate(const BoundingBox& area, Visit&& visit) {
+    candidateCount = 0;
+    queryStamp++;
+    if (queryStamp == 0) {
+        // Po przepełnieniu licznika stare znaczniki mogłyby pasować do nowego zapytania
+        for (Box& box : boxes) {
+            box.stamp = 0;
+        }
+        queryStamp = 1;
+    }
+
+    auto visitBucket = [&](const std::vector<Collider>& bucket) {
+        for (Collider collider : bucket) {
+            Box& box = boxes[collider];
+            if (box.stamp == queryStamp) {
+                continue;
+            }
+            box.stamp = queryStamp;
+            // Kubełek dzielą różne komórki, więc AABB sprawdzane jest przed testem dokładnym
+            if (!box.bounds.intersects(area)) {
+                continue;
+            }
+            candidateCount++;
+            visit(collider, box);
+        }
+    };
+
+    glm::ivec3 cellMin = cellOf(area.min);
+    glm::ivec3 cellMax = cellOf(area.max);
+    glm::vec3 span = glm::vec3(cellMax - cellMin) + 1.0f;
+    if (span.x * span.y * span.z > static_cast<float>(buckets.size())) {
+        // Obszar większy niż tablica - przejście po wszystkich kubełkach jest tańsze
+        for (const std::vector<Collider>& bucket : buckets) {
+            visitBucket(bucket);
+        }
+        return;
+    }
+    for (int z = cellMin.z; z <= cellMax.z; z++) {
+        for (int y = cellMin.y; y <= cellMax.y; y++) {
+            for (int x = cellMin.x; x <= cellMax.x; x++) {
+                visitBucket(buckets[bucketOf(x, y, z)]);
+            }
+        }
+    }
+}
+
+void SpatialHash::queryBox(const BoundingBox& box, std::vector<Collider>& results) {
+    results.clear();
+    forEachCandidate(box, [&results](Collider collider, const Box&) {
+        results.push_back(collider);
+    });
+}
+
+void SpatialHash::querySphere(const glm::vec3& center, float radius, std::vector<Collider>& results) {
+    results.clear();
+    BoundingBox area;
+    area.min = center - radius;
+    area.max = center + radius;
+    forEachCandidate(area, [&](Collider collider, const Box& box) {
+        // Najbliższy punkt pudła w jego układzie lokalnym
+        glm::vec3 local = glm::transpose(box.rotation) * (center - box.center);
+        glm::vec3 closest = glm::clamp(local, -box.halfExtents, box.halfExtents);
+        glm::vec3 offset = local - closest;
+        if (glm::dot(offset, offset) <= radius * radius) {
+            results.push_back(collider);
+        }
+    });
+}
+
+bool SpatialHash::sweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, Hit& hit) {
+    BoundingBox area;
+    area.min = glm::min(start, end) - radius;
+    area.max = glm::max(start, end) + radius;
+
+    bool found = false;
+    hit.time = 1.0f;
+    forEachCandidate(area, [&](Collider collider, const Box& box) {
+        glm::mat3 toLocal = glm::transpose(box.rotation);
+        glm::vec3 origin = toLocal * (start - box.center);
+        glm::vec3 direction = toLocal * (end - start);
+        glm::vec3 extents = box.halfExtents + radius;
+
+        // Test płyt: promień względem pudła powiększonego o promień sfery
+        float enter = -std::numeric_limits<float>::max();
+        float exit = std::numeric_limits<float>::max();
+        int enterAxis = -1;
+        for (int axis = 0; axis < 3; axis++) {
+            if (std::abs(direction[axis]) < 1e-8f) {
+                if (std::abs(origin[axis]) > extents[axis]) {
+                    return;
+                }
+                continue;
+            }
+            float inverse = 1.0f / direction[axis];
+            float entry = (-extents[axis] - origin[axis]) * inverse;
+            float leave = (extents[axis] - origin[axis]) * inverse;
+            if (entry > leave) {
+                std::swap(entry, leave);
+            }
+            if (entry > enter) {
+                enter = entry;
+                enterAxis = axis;
+            }
+            exit = std::min(exit, leave);
+        }
+        if (enter > exit || exit < 0.0f || enter > hit.time) {
+            return;
+        }
+
+        glm::vec3 normal(0.0f);
+        float time = enter;
+        if (enter < 0.0f || enterAxis < 0) {
+            // Sfera już tkwi w pudle - blokowany jest tylko ruch w głąb przez najbliższą ścianę
+            glm::vec3 depth = extents - glm::abs(origin);
+            int axis = depth.x < depth.y ? (depth.x < depth.z ? 0 : 2) : (depth.y < depth.z ? 1 : 2);
+            normal[axis] = origin[axis] < 0.0f ? -1.0f : 1.0f;
+            if (glm::dot(direction, normal) >= 0.0f) {
+                return;
+            }
+            time = 0.0f;
+        }
+        else {
+            normal[enterAxis] = direction[enterAxis] > 0.0f ? -1.0f : 1.0f;
+        }
+
+        found = true;
+        hit.collider = collider;
+        hit.entity = box.entity;
+        hit.time = time;
+        hit.normal = box.rotation * normal;
+    });
+    return found;
+}
+
+glm::vec3 SpatialHash::slideSphere(const glm::vec3& start, const glm::vec3& displacement, float radius) {
+    glm::vec3 position = start;
+    glm::vec3 remaining = displacement;
+    for (int slide = 0; slide < MAX_SLIDES; slide++) {
+        float length = glm::length(remaining);
+        if (length < 1e-6f) {
+            break;
+        }
+
+        Hit hit;
+        if (!sweepSphere(position, position + remaining, radius, hit)) {
+            position += remaining;
+            break;
+        }
+
+        float time = std::max(hit.time - SKIN / length, 0.0f);
+        position += remaining * time;
+        remaining *= 1.0f - time;
+        remaining -= hit.normal * glm::dot(remaining, hit.normal);
+    }
+    return position;
+}
+
+Entity SpatialHash::getEntity(Collider collider) const {
+    return boxes[collider].entity;
+}
+
+const BoundingBox& SpatialHash::getBounds(Collider collider) const {
+    return boxes[collider].bounds;
+}
+
+size_t SpatialHash::getColliderCount() const {
+    return colliderCount;
+}
+
+size_t SpatialHash::getCandidateCount() const {
+    return candidateCount;
+}
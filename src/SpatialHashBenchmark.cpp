@@ -0,0 +1,111 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+const float CELL_SIZE = 2.0f, AREA_PER_COLLIDER = 9.0f, HEIGHT = 8.0f;
+const float QUERY_HALF_SIZE = 4.0f, SPHERE_RADIUS = 3.0f, SWEEP_RADIUS = 0.3f, SWEEP_LENGTH = 10.0f;
+const int QUERIES = 100000;
+const size_t DEFAULT_COUNTS[] = { 1000, 10000, 100000, 1000000 };
+
+double microseconds(std::chrono::high_resolution_clock::time_point start, int count) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / count;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> counts(std::begin(DEFAULT_COUNTS), std::end(DEFAULT_COUNTS));
+    if (argc > 1) {
+        counts.clear();
+        for (int i = 1; i < argc; i++) {
+            counts.push_back(static_cast<size_t>(std::max(1, std::atoi(argv[i]))));
+        }
+    }
+
+    std::cout << "cell " << CELL_SIZE << ", " << AREA_PER_COLLIDER << " m^2 per collider, " << QUERIES << " queries per test" << std::endl;
+    std::cout << std::setw(9) << "objects" << std::setw(10) << "build ms" << std::setw(10) << "box us" << std::setw(8) << "tested" << std::setw(6) << "hits"
+              << std::setw(11) << "sphere us" << std::setw(10) << "sweep us" << std::setw(11) << "update us" << std::endl;
+
+    for (size_t count : counts) {
+        // Stała gęstość - rośnie tylko pole, więc liczba sąsiadów zapytania jest dla każdego rozmiaru ta sama
+        float side = std::sqrt(static_cast<float>(count) * AREA_PER_COLLIDER);
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> coordinate(0.0f, side), height(0.0f, HEIGHT), angle(0.0f, 3.14159265f), unit(-1.0f, 1.0f);
+
+        std::vector<glm::vec3> centers(count);
+        std::vector<glm::quat> orientations(count);
+        for (size_t i = 0; i < count; i++) {
+            centers[i] = glm::vec3(coordinate(random), height(random), coordinate(random));
+            glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.001f, 0.0f));
+            orientations[i] = glm::angleAxis(angle(random), axis);
+        }
+
+        SpatialHash hash(CELL_SIZE);
+        std::vector<SpatialHash::Collider> colliders(count);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            colliders[i] = hash.add(Entity{ static_cast<uint32_t>(i), 1 }, centers[i], orientations[i], glm::vec3(0.5f));
+        }
+        double buildTime = microseconds(start, 1) / 1000.0;
+
+        std::vector<glm::vec3> points(QUERIES);
+        for (glm::vec3& point : points) {
+            point = glm::vec3(coordinate(random), height(random), coordinate(random));
+        }
+
+        std::vector<SpatialHash::Collider> results;
+        size_t tested = 0, found = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (const glm::vec3& point : points) {
+            BoundingBox box;
+            box.expand(point - glm::vec3(QUERY_HALF_SIZE));
+            box.expand(point + glm::vec3(QUERY_HALF_SIZE));
+            results.clear();
+            hash.queryBox(box, results);
+            tested += hash.getCandidateCount();
+            found += results.size();
+        }
+        double boxTime = microseconds(start, QUERIES);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (const glm::vec3& point : points) {
+            results.clear();
+            hash.querySphere(point, SPHERE_RADIUS, results);
+        }
+        double sphereTime = microseconds(start, QUERIES);
+
+        SpatialHash::Hit hit;
+        start = std::chrono::high_resolution_clock::now();
+        for (const glm::vec3& point : points) {
+            glm::vec3 direction = glm::normalize(glm::vec3(point.z - point.x, 0.0f, point.x - point.z) + glm::vec3(0.001f, 0.0f, 0.0f));
+            hash.sweepSphere(point, point + direction * SWEEP_LENGTH, SWEEP_RADIUS, hit);
+        }
+        double sweepTime = microseconds(start, QUERIES);
+
+        // Przesunięcia rzędu kroku symulacji - większość aktualizacji nie zmienia zakresu komórek
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < QUERIES; i++) {
+            size_t index = pick(random);
+            centers[index] += glm::vec3(unit(random), unit(random), unit(random)) * 0.1f;
+            hash.update(colliders[index], centers[index], orientations[index]);
+        }
+        double updateTime = microseconds(start, QUERIES);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(9) << count << std::setw(10) << buildTime << std::setw(10) << boxTime
+                  << std::setw(8) << std::setprecision(1) << static_cast<double>(tested) / QUERIES
+                  << std::setw(6) << static_cast<double>(found) / QUERIES << std::setprecision(3)
+                  << std::setw(11) << sphereTime << std::setw(10) << sweepTime << std::setw(11) << updateTime << std::endl;
+    }
+    return 0;
+}
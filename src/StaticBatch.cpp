@@ -0,0 +1,196 @@
+#include "StaticBatch.h"
+
+#include <algorithm>
+#include <tuple>
+
+StaticBatch::StaticBatch(float cellSize) : cellSize(cellSize) {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    VertexFormat::setupAttributes();
+
+    glBindVertexArray(0);
+}
+
+StaticBatch::~StaticBatch() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+}
+
+void StaticBatch::build(const std::vector<ShapeObject*>& objects) {
+    // Obiekt należy do komórki swojego środka, więc paczka sięga najwyżej o pół obiektu poza komórkę
+    auto cellOf = [this](const ShapeObject* object) {
+        const BoundingBox& bounds = object->getBounds();
+        glm::ivec3 cell(glm::floor((bounds.min + bounds.max) * 0.5f / cellSize));
+        return std::make_tuple(cell.x, cell.y, cell.z, object->getTexture());
+    };
+    std::vector<const ShapeObject*> ordered(objects.begin(), objects.end());
+    std::stable_sort(ordered.begin(), ordered.end(), [&cellOf](const ShapeObject* a, const ShapeObject* b) {
+        return cellOf(a) < cellOf(b);
+    });
+
+    std::vector<PackedVertex> vertices;
+    std::vector<unsigned int> indices;
+    batches.clear();
+
+    for (size_t i = 0; i < ordered.size(); i++) {
+        const ShapeObject* object = ordered[i];
+        if (i == 0 || cellOf(ordered[i - 1]) != cellOf(object)) {
+            batches.push_back({ object->getTexture(), static_cast<GLuint>(indices.size()), 0, BoundingBox() });
+        }
+        Batch& batch = batches.back();
+
+        // Wierzchołki obiektów są już w przestrzeni świata - wystarczy przesunąć indeksy
+        unsigned int baseVertex = static_cast<unsigned int>(vertices.size());
+        std::vector<PackedVertex> packed = VertexFormat::pack(object->getVertices());
+        vertices.insert(vertices.end(), packed.begin(), packed.end());
+        for (unsigned int index : object->getIndices()) {
+            indices.push_back(baseVertex + index);
+        }
+
+        batch.indexCount = static_cast<GLsizei>(indices.size() - batch.firstIndex);
+        batch.bounds.expand(object->getBounds().min);
+        batch.bounds.expand(object->getBounds().max);
+    }
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PackedVertex), vertices.data(), GL_STATIC_DRAW);
+    indexType = VertexFormat::uploadIndices(indices, vertices.size(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StaticBatch::reserve(size_t maxVertices, size_t maxIndices) {
+    batches.clear();
+    vertexCapacity = maxVertices;
+    indexCapacity = maxIndices;
+    vertexCount = 0;
+    indexCount = 0;
+    pendingVertices.clear();
+    pendingIndices.clear();
+
+    indexType = VertexFormat::fitsShortIndices(maxVertices) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    size_t indexSize = getIndexSize();
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, maxVertices * sizeof(PackedVertex), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(vao);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, maxIndices * indexSize, nullptr, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
+bool StaticBatch::append(GLuint texture, std::span<const float> vertices, const std::vector<unsigned int>& indices) {
+    size_t objectVertexCount = vertices.size() / VERTEX_FLOATS;
+    if (vertexCount + objectVertexCount > vertexCapacity || indexCount + indices.size() > indexCapacity) {
+        return false;
+    }
+
+    if (batches.empty() || batches.back().texture != texture) {
+        batches.push_back({ texture, static_cast<GLuint>(indexCount), 0, BoundingBox() });
+    }
+    Batch& batch = batches.back();
+    BoundingBox bounds = BoundingBox::fromVertices(vertices, VERTEX_FLOATS);
+    batch.bounds.expand(bounds.min);
+    batch.bounds.expand(bounds.max);
+
+    for (size_t i = 0; i < objectVertexCount; i++) {
+        pendingVertices.push_back(VertexFormat::pack(&vertices[i * VERTEX_FLOATS]));
+    }
+    for (unsigned int index : indices) {
+        pendingIndices.push_back(static_cast<unsigned int>(vertexCount) + index);
+    }
+    vertexCount += objectVertexCount;
+    indexCount += indices.size();
+    batch.indexCount = static_cast<GLsizei>(indexCount - batch.firstIndex);
+    return true;
+}
+
+size_t StaticBatch::flush() {
+    if (pendingVertices.empty()) {
+        return 0;
+    }
+
+    // Dopisane dane leżą na końcu buforów - przesyłany jest jeden ciągły zakres wierzchołków i indeksów
+    size_t vertexBytes = pendingVertices.size() * sizeof(PackedVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, (vertexCount - pendingVertices.size()) * sizeof(PackedVertex), vertexBytes, pendingVertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    size_t firstIndex = indexCount - pendingIndices.size();
+    size_t indexBytes = 0;
+    glBindVertexArray(vao);
+    if (indexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> shortIndices = VertexFormat::packIndices(pendingIndices);
+        indexBytes = shortIndices.size() * sizeof(uint16_t);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex * sizeof(uint16_t), indexBytes, shortIndices.data());
+    }
+    else {
+        indexBytes = pendingIndices.size() * sizeof(GLuint);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex * sizeof(GLuint), indexBytes, pendingIndices.data());
+    }
+    glBindVertexArray(0);
+
+    pendingVertices.clear();
+    pendingIndices.clear();
+    return vertexBytes + indexBytes;
+}
+
+void StaticBatch::bind(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) const {
+    glUseProgram(shaderProgram);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glBindVertexArray(vao);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void StaticBatch::drawRange(const Batch& batch) const {
+    size_t indexSize = getIndexSize();
+    glBindTexture(GL_TEXTURE_2D, batch.texture);
+    glDrawElements(GL_TRIANGLES, batch.indexCount, indexType, (void*)(batch.firstIndex * indexSize));
+}
+
+size_t StaticBatch::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection, const Frustum& frustum) const {
+    if (batches.empty()) {
+        return 0;
+    }
+
+    size_t drawn = 0;
+    bind(shaderProgram, view, projection);
+    for (const Batch& batch : batches) {
+        if (!frustum.intersectsBox(batch.bounds)) {
+            continue;
+        }
+        drawRange(batch);
+        drawn++;
+    }
+    glBindVertexArray(0);
+    glUseProgram(0);
+    return drawn;
+}
+
+void StaticBatch::drawBatch(GLuint shaderProgram, size_t batch, const glm::mat4& view, const glm::mat4& projection) const {
+    bind(shaderProgram, view, projection);
+    drawRange(batches[batch]);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+size_t StaticBatch::getBatchCount() const {
+    return batches.size();
+}
+
+size_t StaticBatch::getIndexSize() const {
+    return indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+}
+
+const BoundingBox& StaticBatch::getBounds(size_t batch) const {
+    return batches[batch].bounds;
+}
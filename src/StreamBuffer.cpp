@@ -0,0 +1,143 @@
+#include "StreamBuffer.h"
+
+#include <algorithm>
+
+StreamBuffer::StreamBuffer(GLenum target, size_t regionSize, int regionCount)
+    : target(target), regionSize((regionSize + 255) / 256 * 256), regionCount(std::clamp(regionCount, 1, MAX_REGIONS)) {
+    if (!GLEW_ARB_buffer_storage) {
+        std::cerr << "GL_ARB_buffer_storage is not supported - stream buffers fall back to glBufferSubData!" << std::endl;
+    }
+    create();
+}
+
+StreamBuffer::~StreamBuffer() {
+    destroy();
+}
+
+void StreamBuffer::create() {
+    // Regiony zaczynają się na granicy 256 B, więc wyrównanie względem regionu jest też wyrównaniem względem bufora
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+    if (!GLEW_ARB_buffer_storage) {
+        glBufferData(target, regionSize * regionCount, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(target, 0);
+        return;
+    }
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(target, regionSize * regionCount, nullptr, flags);
+    mapped = static_cast<unsigned char*>(glMapBufferRange(target, 0, regionSize * regionCount, flags));
+    glBindBuffer(target, 0);
+
+    // Pierwsze przejście beginFrame() trafia w region 0
+    region = regionCount - 1;
+    cursor = 0;
+}
+
+void StreamBuffer::destroy() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (mapped) {
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+        mapped = nullptr;
+    }
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+}
+
+void StreamBuffer::reserve(size_t size) {
+    if (size <= regionSize) {
+        return;
+    }
+    // Stary bufor zwalniany jest przez sterownik dopiero po poleceniach, które z niego czytają
+    size_t grown = regionSize;
+    while (grown < size) {
+        grown *= 2;
+    }
+    destroy();
+    regionSize = grown;
+    create();
+}
+
+void StreamBuffer::beginFrame() {
+    if (overflowed) {
+        reserve(demand);
+    }
+    demand = 0;
+    overflowed = false;
+
+    region = (region + 1) % regionCount;
+    cursor = 0;
+
+    GLsync& fence = fences[region];
+    if (!fence) {
+        return;
+    }
+
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        auto start = std::chrono::high_resolution_clock::now();
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
+        stallTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        stallCount++;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void* StreamBuffer::allocate(size_t size, size_t alignment, GLintptr& offset) {
+    if (!mapped) {
+        return nullptr;
+    }
+
+    // Suma żądań klatki - po przepełnieniu region powiększy się do niej w następnym beginFrame()
+    demand += size + alignment;
+    size_t aligned = alignment > 1 ? (cursor + alignment - 1) / alignment * alignment : cursor;
+    if (aligned + size > regionSize) {
+        overflowCount++;
+        overflowed = true;
+        return nullptr;
+    }
+
+    cursor = aligned + size;
+    offset = static_cast<GLintptr>(region * regionSize + aligned);
+    return mapped + offset;
+}
+
+void StreamBuffer::endFrame() {
+    if (!mapped) {
+        return;
+    }
+    if (fences[region]) {
+        glDeleteSync(fences[region]);
+    }
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLuint StreamBuffer::getBuffer() const {
+    return buffer;
+}
+
+size_t StreamBuffer::getStallCount() const {
+    return stallCount;
+}
+
+double StreamBuffer::getStallTime() const {
+    return stallTime;
+}
+
+size_t StreamBuffer::getOverflowCount() const {
+    return overflowCount;
+}
+
+size_t StreamBuffer::getRegionSize() const {
+    return regionSize;
+}
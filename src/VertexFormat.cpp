@@ -0,0 +1,34 @@
+#include "VertexFormat.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+PackedVertex VertexFormat::pack(const float* vertex) {
+    PackedVertex packed;
+    packed.position[0] = vertex[0];
+    packed.position[1] = vertex[1];
+    packed.position[2] = vertex[2];
+    packed.texCoord = glm::packHalf2x16(glm::vec2(vertex[3], vertex[4]));
+
+    glm::vec3 normal(vertex[5], vertex[6], vertex[7]);
+    float length = glm::length(normal);
+    normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    packed.normal = glm::packSnorm3x10_1x2(glm::vec4(normal, 0.0f));
+    return packed;
+}
+
+std::vector<PackedVertex> VertexFormat::pack(std::span<const float> vertices) {
+    std::vector<PackedVertex> packed(vertices.size() / VERTEX_FLOATS);
+    for (size_t i = 0; i < packed.size(); i++) {
+        packed[i] = pack(&vertices[i * VERTEX_FLOATS]);
+    }
+    return packed;
+}
+
+bool VertexFormat::fitsShortIndices(size_t vertexCount) {
+    return vertexCount <= SHORT_INDEX_LIMIT;
+}
+
+std::vector<uint16_t> VertexFormat::packIndices(const std::vector<uint32_t>& indices) {
+    return std::vector<uint16_t>(indices.begin(), indices.end());
+}
@@ -15,37 +15,51 @@ Wall::Wall(float width, float height, float x, float y, float z, GLuint texture)
 
     this->textureID = texture;
 
+    bounds = BoundingBox::fromVertices(vertices, 8);
+
     setupBuffers();
 }
 
 void Wall::setupBuffers() {
-    
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
 
     glBindVertexArray(vao);
 
+    std::vector<PackedVertex> packed = VertexFormat::pack(vertices);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    indexType = VertexFormat::uploadIndices(indices, packed.size(), GL_STATIC_DRAW);
 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); 
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    VertexFormat::setupAttributes();
 
     glBindVertexArray(0);
+}
 
+void Wall::releaseBuffers() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+    vao = vbo = ebo = 0;
+}
+
+void Wall::uploadVertices() {
+    if (vbo == 0) {
+        return;
+    }
+    std::vector<PackedVertex> packed = VertexFormat::pack(vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, packed.size() * sizeof(PackedVertex), packed.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Wall::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
+    if (vao == 0) {
+        return;
+    }
     glUseProgram(shaderProgram);
 
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
@@ -59,7 +73,7 @@ void Wall::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& v
     }
 
     glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, indices.size(), indexType, 0);
     glBindVertexArray(0);
 
     glUseProgram(0);
@@ -72,9 +86,10 @@ void Wall::translate(const glm::vec3& direction) {
         vertices[i + 2] += direction.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+
+    uploadVertices();
 }
 
 void Wall::rotate(float angle, const glm::vec3& axis) {
@@ -93,9 +108,10 @@ void Wall::rotate(float angle, const glm::vec3& axis) {
         vertices[i + 7] = normal.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+
+    uploadVertices();
 }
 
 void Wall::scale(float sx, float sy) {
@@ -120,9 +136,10 @@ void Wall::scale(float sx, float sy) {
         vertices[i + 7] = normal.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bounds = BoundingBox::fromVertices(vertices, 8);
+    markChanged();
+
+    uploadVertices();
 }
 
 void Wall::rotatePoint(float angle, const glm::vec3& axis, const glm::vec3& point) {
@@ -142,3 +159,19 @@ void Wall::rotateAround(float angle, const glm::vec3& axis) {
 
     rotatePoint(angle,axis,center);
 }
+
+const BoundingBox& Wall::getBounds() const {
+    return bounds;
+}
+
+std::span<const float> Wall::getVertices() const {
+    return vertices;
+}
+
+const std::vector<unsigned int>& Wall::getIndices() const {
+    return indices;
+}
+
+GLuint Wall::getTexture() const {
+    return textureID;
+}
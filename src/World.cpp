@@ -0,0 +1,132 @@
+#include "World.h"
+
+World::World() {
+    findArchetype(0);
+}
+
+uint32_t World::registerComponent(size_t size) {
+    static uint32_t nextId = 0;
+    assert(nextId < MAX_COMPONENTS && "Too many component types");
+    componentSizes()[nextId] = size;
+    return nextId++;
+}
+
+std::array<size_t, World::MAX_COMPONENTS>& World::componentSizes() {
+    static std::array<size_t, MAX_COMPONENTS> sizes = {};
+    return sizes;
+}
+
+uint32_t World::findArchetype(Signature signature) {
+    auto found = archetypeLookup.find(signature);
+    if (found != archetypeLookup.end()) {
+        return found->second;
+    }
+
+    Archetype archetype;
+    archetype.signature = signature;
+    archetype.columnOf.fill(-1);
+    for (uint32_t component = 0; component < MAX_COMPONENTS; component++) {
+        if (signature & (Signature(1) << component)) {
+            archetype.columnOf[component] = static_cast<int8_t>(archetype.columns.size());
+            archetype.columns.push_back({ component, componentSizes()[component], {} });
+        }
+    }
+
+    uint32_t index = static_cast<uint32_t>(archetypes.size());
+    archetypes.push_back(std::move(archetype));
+    archetypeLookup.emplace(signature, index);
+    return index;
+}
+
+Entity World::create() {
+    return allocateEntity(0);
+}
+
+Entity World::allocateEntity(uint32_t archetypeIndex) {
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(records.size());
+        // Generacja 0 jest zarezerwowana dla pustego uchwytu
+        records.push_back({ 1, 0, 0 });
+    }
+
+    Entity entity = { index, records[index].generation };
+    records[index].archetype = archetypeIndex;
+    records[index].row = appendRow(archetypes[archetypeIndex], entity);
+    aliveCount++;
+    return entity;
+}
+
+uint32_t World::appendRow(Archetype& archetype, Entity entity) {
+    uint32_t row = static_cast<uint32_t>(archetype.entities.size());
+    archetype.entities.push_back(entity);
+    for (Column& column : archetype.columns) {
+        column.data.resize(column.data.size() + column.elementSize);
+    }
+    return row;
+}
+
+void World::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    EntityRecord& record = records[entity.index];
+    removeRow(record.archetype, record.row);
+    record.generation++;
+    freeIndices.push_back(entity.index);
+    aliveCount--;
+}
+
+bool World::isAlive(Entity entity) const {
+    return entity.index < records.size() && records[entity.index].generation == entity.generation;
+}
+
+void World::moveEntity(Entity entity, uint32_t targetIndex) {
+    EntityRecord& record = records[entity.index];
+    Archetype& source = archetypes[record.archetype];
+    Archetype& target = archetypes[targetIndex];
+
+    uint32_t row = appendRow(target, entity);
+    for (Column& column : target.columns) {
+        int sourceColumn = source.columnOf[column.component];
+        if (sourceColumn >= 0) {
+            std::memcpy(column.data.data() + row * column.elementSize,
+                        source.columns[sourceColumn].data.data() + record.row * column.elementSize, column.elementSize);
+        }
+    }
+
+    removeRow(record.archetype, record.row);
+    record.archetype = targetIndex;
+    record.row = row;
+}
+
+void World::removeRow(uint32_t archetypeIndex, uint32_t row) {
+    Archetype& archetype = archetypes[archetypeIndex];
+    uint32_t last = static_cast<uint32_t>(archetype.entities.size()) - 1;
+
+    if (row != last) {
+        for (Column& column : archetype.columns) {
+            std::memcpy(column.data.data() + row * column.elementSize, column.data.data() + last * column.elementSize, column.elementSize);
+        }
+        Entity moved = archetype.entities[last];
+        archetype.entities[row] = moved;
+        records[moved.index].row = row;
+    }
+
+    archetype.entities.pop_back();
+    for (Column& column : archetype.columns) {
+        column.data.resize(column.data.size() - column.elementSize);
+    }
+}
+
+size_t World::getEntityCount() const {
+    return aliveCount;
+}
+
+size_t World::getArchetypeCount() const {
+    return archetypes.size();
+}
@@ -0,0 +1,85 @@
+#include "ChunkStreamer.h"
+#include "SceneFile.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+namespace {
+
+const char* MATERIAL_PATHS[] = { "textures/wall.jpg", "textures/wood.jpg" };
+const int MAX_STACK = 4;
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: WorldGenerator <output directory> [chunks per side = 64] [objects per chunk = 256]" << std::endl;
+        return 1;
+    }
+    std::filesystem::path directory = argv[1];
+    int side = argc > 2 ? std::max(1, std::atoi(argv[2])) : 64;
+    int objectsPerChunk = argc > 3 ? std::max(1, std::atoi(argv[3])) : 256;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    auto start = std::chrono::high_resolution_clock::now();
+
+    SceneData chunk;
+    for (const char* path : MATERIAL_PATHS) {
+        SceneMaterial material = {};
+        std::strncpy(material.texture, path, sizeof(material.texture) - 1);
+        chunk.materials.push_back(material);
+    }
+
+    // Siatka fragmentów wokół początku układu; cztery fragmenty przy nim zostają puste na pokój startowy
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> offset(0.0f, WORLD_CHUNK_SIZE), size(0.5f, 1.5f), angle(0.0f, 6.2831853f);
+    std::uniform_int_distribution<int> stack(1, MAX_STACK), material(0, 1);
+    size_t objectCount = 0, chunkCount = 0;
+    for (int z = -side / 2; z < side - side / 2; z++) {
+        for (int x = -side / 2; x < side - side / 2; x++) {
+            if ((x == -1 || x == 0) && (z == -1 || z == 0)) {
+                continue;
+            }
+            // Sześciany ustawione w wieże na podłodze (y = 0), obrócone wokół osi pionowej
+            chunk.objects.clear();
+            while (static_cast<int>(chunk.objects.size()) < objectsPerChunk) {
+                float baseX = x * WORLD_CHUNK_SIZE + offset(random);
+                float baseZ = z * WORLD_CHUNK_SIZE + offset(random);
+                float halfSize = size(random);
+                glm::quat orientation = glm::angleAxis(angle(random), glm::vec3(0.0f, 1.0f, 0.0f));
+                int height = std::min(stack(random), objectsPerChunk - static_cast<int>(chunk.objects.size()));
+                for (int level = 0; level < height; level++) {
+                    SceneObject object = {};
+                    object.position[0] = baseX;
+                    object.position[1] = halfSize * (2.0f * level + 1.0f);
+                    object.position[2] = baseZ;
+                    object.kind = SCENE_OBJECT_CUBE;
+                    object.orientation[0] = orientation.x;
+                    object.orientation[1] = orientation.y;
+                    object.orientation[2] = orientation.z;
+                    object.orientation[3] = orientation.w;
+                    object.halfExtents[0] = object.halfExtents[1] = object.halfExtents[2] = halfSize;
+                    object.material = static_cast<uint32_t>(material(random));
+                    chunk.objects.push_back(object);
+                }
+            }
+            if (!SceneFile::write((directory / ChunkStreamer::chunkFileName(x, z)).string(), chunk)) {
+                return 1;
+            }
+            objectCount += chunk.objects.size();
+            chunkCount++;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Wrote " << chunkCount << " chunks, " << objectCount << " objects to " << directory.string() << " in " << elapsed << " ms" << std::endl;
+    return 0;
+}